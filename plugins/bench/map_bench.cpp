@@ -0,0 +1,121 @@
+// Times the map storage modes on cell and string keys: insert n keys, 10^7 lookups, iterate, erase half
+// g++ -std=c++11 -O2 -I../src map_bench.cpp -o map_bench
+
+#include "utils/hybrid_map.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+const size_t num_lookups = 10000000;
+
+template <class Func>
+static double measure(Func func)
+{
+	auto start = std::chrono::steady_clock::now();
+	func();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <class Key>
+static void run(const char *name, const std::vector<Key> &keys, size_t size, const std::vector<size_t> &probes, aux::hybrid_map_mode mode)
+{
+	aux::hybrid_map<Key, std::int32_t> map(mode);
+	std::int64_t sum = 0;
+
+	double insert = measure([&]()
+	{
+		for(size_t i = 0; i < size; i++)
+		{
+			map.emplace(keys[i], static_cast<std::int32_t>(i));
+		}
+	});
+	double find = measure([&]()
+	{
+		// half of the probes are for keys that are not in the map
+		for(size_t i = 0; i < num_lookups; i++)
+		{
+			auto it = map.find(keys[probes[i]]);
+			if(it != map.end())
+			{
+				sum += (*it).second;
+			}
+		}
+	});
+	double iterate = measure([&]()
+	{
+		for(const auto &pair : map)
+		{
+			sum += pair.second;
+		}
+	});
+	double erase = measure([&]()
+	{
+		for(size_t i = 0; i < size; i += 2)
+		{
+			map.erase(keys[i]);
+		}
+	});
+	std::printf("  %-10s %10.1f %10.1f %10.2f %10.1f   (%lld)\n", name, insert, find, iterate, erase, static_cast<long long>(sum));
+}
+
+template <class Key>
+static void run_all(const std::vector<Key> &keys, std::mt19937 &rng)
+{
+	// the map holds the first half of the keys, the probes also hit the second half
+	std::vector<size_t> probes(num_lookups);
+	for(auto &probe : probes)
+	{
+		probe = rng() % keys.size();
+	}
+	std::printf("  %-10s %10s %10s %10s %10s\n", "storage", "insert", "find", "iterate", "erase");
+	struct mode_info
+	{
+		const char *name;
+		aux::hybrid_map_mode mode;
+	};
+	const mode_info modes[] = {
+		{"hashed", aux::hybrid_map_mode::unordered},
+		{"flat", aux::hybrid_map_mode::flat},
+		{"ordered", aux::hybrid_map_mode::ordered},
+		{"btree", aux::hybrid_map_mode::btree},
+	};
+	for(const auto &info : modes)
+	{
+		run(info.name, keys, keys.size() / 2, probes, info.mode);
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(4);
+#ifdef FLAT_MAP_SSE2
+	std::printf("flat map groups matched with SSE2\n");
+#else
+	std::printf("flat map groups matched with the portable loop\n");
+#endif
+	for(size_t n : {1000u, 100000u, 1000000u})
+	{
+		std::vector<std::int32_t> cells(2 * n);
+		for(auto &key : cells)
+		{
+			key = static_cast<std::int32_t>(rng());
+		}
+		std::printf("%zu cell keys, ms:\n", n);
+		run_all(cells, rng);
+	}
+	for(size_t n : {1000u, 100000u})
+	{
+		std::vector<std::string> strings(2 * n);
+		for(auto &key : strings)
+		{
+			key = "player_" + std::to_string(rng());
+		}
+		std::printf("%zu string keys, ms:\n", n);
+		run_all(strings, rng);
+	}
+	return 0;
+}
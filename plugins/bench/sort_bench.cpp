@@ -0,0 +1,162 @@
+// Checks the radix paths of list_sort against the comparison sort and times them
+// g++ -std=c++11 -O2 -pthread -I../src sort_bench.cpp -o sort_bench
+
+#include "utils/radix_sort.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::int32_t cell;
+
+struct sort_entry
+{
+	std::uint64_t key;
+	size_t index;
+};
+
+typedef std::vector<cell> element;
+
+// The order of cell_sorter(offset, 1) for untagged cells
+struct cell_sorter
+{
+	size_t offset;
+
+	bool operator()(const element &a, const element &b) const
+	{
+		if(offset >= b.size())
+		{
+			return false;
+		}else if(offset >= a.size())
+		{
+			return true;
+		}
+		return a[offset] < b[offset];
+	}
+};
+
+static std::vector<element> comparison_sort(std::vector<element> list, size_t offset, bool reverse)
+{
+	if(!reverse)
+	{
+		std::stable_sort(list.begin(), list.end(), cell_sorter{offset});
+	}else{
+		std::stable_sort(list.rbegin(), list.rend(), cell_sorter{offset});
+	}
+	return list;
+}
+
+static std::vector<element> radix_sort(const std::vector<element> &list, size_t offset, bool reverse, size_t parts)
+{
+	std::vector<sort_entry> keys(list.size()), buffer(list.size());
+	for(size_t i = 0; i < list.size(); i++)
+	{
+		keys[i] = {aux::cell_key(offset < list[i].size() ? &list[i][offset] : nullptr, reverse), i};
+	}
+	auto key = [](const sort_entry &entry) { return entry.key; };
+	if(parts > 1)
+	{
+		aux::parallel_radix_sort(keys.data(), keys.data() + keys.size(), buffer.data(), key, aux::cell_key_bits, parts);
+	}else{
+		aux::radix_sort(keys.data(), keys.data() + keys.size(), buffer.data(), key, aux::cell_key_bits);
+	}
+	std::vector<element> sorted;
+	sorted.reserve(list.size());
+	for(const auto &entry : keys)
+	{
+		sorted.push_back(list[entry.index]);
+	}
+	return sorted;
+}
+
+static std::vector<element> make_list(std::mt19937 &rng, size_t size, cell range, size_t max_length)
+{
+	std::vector<element> list(size);
+	for(auto &elem : list)
+	{
+		elem.resize(rng() % (max_length + 1));
+		for(auto &value : elem)
+		{
+			value = range ? static_cast<cell>(rng() % range) - range / 2 : static_cast<cell>(rng());
+		}
+	}
+	return list;
+}
+
+static int fuzz(unsigned rounds)
+{
+	std::mt19937 rng(1);
+	const cell ranges[] = {0, 2, 50, 100000};
+	for(unsigned round = 0; round < rounds; round++)
+	{
+		size_t size = rng() % 3000;
+		cell range = ranges[rng() % 4];
+		size_t offset = rng() % 3;
+		bool reverse = rng() % 2 != 0;
+		size_t parts = 1 + rng() % 9;
+		auto list = make_list(rng, size, range, 3);
+		if(radix_sort(list, offset, reverse, parts) != comparison_sort(list, offset, reverse))
+		{
+			std::printf("mismatch: size %zu, range %d, offset %zu, reverse %d, parts %zu\n", size, range, offset, reverse, parts);
+			return 1;
+		}
+	}
+	std::printf("fuzz: %u rounds passed\n", rounds);
+	return 0;
+}
+
+template <class Func>
+static double measure(Func func, unsigned repeat)
+{
+	double best = 0;
+	for(unsigned i = 0; i < repeat; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		func();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if(i == 0 || ms < best)
+		{
+			best = ms;
+		}
+	}
+	return best;
+}
+
+static void bench()
+{
+	std::mt19937 rng(2);
+	unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	std::printf("%u hardware threads, best of 5, ms\n", threads);
+	std::printf("%10s %12s %12s %12s\n", "size", "stable_sort", "radix", "parallel");
+	for(size_t size : {1000u, 10000u, 100000u, 1000000u})
+	{
+		auto list = make_list(rng, size, 0, 1);
+		for(auto &elem : list)
+		{
+			elem.resize(1);
+		}
+		size_t parts = std::max<size_t>(2, std::min<size_t>(threads, size / 1024));
+		double comparison = measure([&]() { comparison_sort(list, 0, false); }, 5);
+		double radix = measure([&]() { radix_sort(list, 0, false, 1); }, 5);
+		double parallel = measure([&]() { radix_sort(list, 0, false, parts); }, 5);
+		std::printf("%10zu %12.3f %12.3f %12.3f (%zu parts)\n", size, comparison, radix, parallel, parts);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if(fuzz(2000))
+	{
+		return 1;
+	}
+	if(argc < 2 || std::string(argv[1]) != "--fuzz-only")
+	{
+		bench();
+	}
+	return 0;
+}
@@ -0,0 +1,251 @@
+// Moves 10k points around a Spatial grid and times radius, box and k-nearest queries against brute force
+// g++ -std=c++11 -O2 -I../src spatial_bench.cpp -o spatial_bench
+
+#include "utils/spatial_grid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef aux::spatial_grid<int> grid_t;
+
+const size_t num_points = 10000;
+const size_t num_queries = 1000;
+const int num_ticks = 20;
+const float area[3] = {6000, 6000, 100};
+const float cell_size = 50;
+const float max_step = 15;
+const float radius = 100;
+const float box_half = 100;
+const size_t knn = 5;
+
+struct timer
+{
+	double total = 0;
+	std::chrono::steady_clock::time_point start;
+
+	void begin()
+	{
+		start = std::chrono::steady_clock::now();
+	}
+
+	void end()
+	{
+		total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+};
+
+static float distance_sq(const float a[3], const float b[3])
+{
+	float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+	return dx * dx + dy * dy + dz * dz;
+}
+
+int main(int argc, char **argv)
+{
+	bool check = argc < 2 || std::string(argv[1]) != "--no-check";
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> unit(0, 1), step(-max_step, max_step);
+
+	grid_t grid(cell_size);
+	std::vector<size_t> handles(num_points);
+	std::vector<std::vector<float>> pos(num_points, std::vector<float>(3));
+	for(size_t i = 0; i < num_points; i++)
+	{
+		for(int j = 0; j < 3; j++)
+		{
+			pos[i][j] = unit(rng) * area[j];
+		}
+		handles[i] = grid.insert(pos[i].data(), static_cast<int>(i));
+	}
+
+	timer move, radius_grid, radius_brute, box_grid, box_brute, knn_grid, knn_brute;
+	size_t found = 0, mismatches = 0;
+	std::vector<size_t> result, expected;
+	std::vector<std::pair<float, size_t>> nearest, brute;
+	std::vector<std::vector<float>> centers(num_queries, std::vector<float>(3));
+
+	for(int tick = 0; tick < num_ticks; tick++)
+	{
+		// a few points leave and others join, so handles get reused
+		for(size_t n = 0; n < num_points / 100; n++)
+		{
+			size_t i = rng() % num_points;
+			grid.remove(handles[i]);
+			handles[i] = grid.insert(pos[i].data(), static_cast<int>(i));
+		}
+
+		for(auto &p : pos)
+		{
+			for(int j = 0; j < 3; j++)
+			{
+				p[j] = std::min(std::max(p[j] + step(rng), 0.0f), area[j]);
+			}
+		}
+		move.begin();
+		for(size_t i = 0; i < num_points; i++)
+		{
+			grid.move(handles[i], pos[i].data());
+		}
+		move.end();
+
+		for(auto &center : centers)
+		{
+			for(int j = 0; j < 3; j++)
+			{
+				center[j] = unit(rng) * area[j];
+			}
+		}
+
+		radius_grid.begin();
+		for(const auto &center : centers)
+		{
+			grid.query_radius(center.data(), radius, [&](size_t handle)
+			{
+				found++;
+				return true;
+			});
+		}
+		radius_grid.end();
+
+		radius_brute.begin();
+		for(const auto &center : centers)
+		{
+			for(size_t i = 0; i < num_points; i++)
+			{
+				if(distance_sq(pos[i].data(), center.data()) <= radius * radius)
+				{
+					found++;
+				}
+			}
+		}
+		radius_brute.end();
+
+		box_grid.begin();
+		for(const auto &center : centers)
+		{
+			float min[3] = {center[0] - box_half, center[1] - box_half, 0};
+			float max[3] = {center[0] + box_half, center[1] + box_half, area[2]};
+			grid.query_box(min, max, [&](size_t handle)
+			{
+				found++;
+				return true;
+			});
+		}
+		box_grid.end();
+
+		box_brute.begin();
+		for(const auto &center : centers)
+		{
+			for(size_t i = 0; i < num_points; i++)
+			{
+				const float *p = pos[i].data();
+				if(p[0] >= center[0] - box_half && p[0] <= center[0] + box_half && p[1] >= center[1] - box_half && p[1] <= center[1] + box_half)
+				{
+					found++;
+				}
+			}
+		}
+		box_brute.end();
+
+		knn_grid.begin();
+		for(const auto &center : centers)
+		{
+			grid.nearest(center.data(), knn, -1, nearest);
+			found += nearest.size();
+		}
+		knn_grid.end();
+
+		knn_brute.begin();
+		for(const auto &center : centers)
+		{
+			brute.clear();
+			for(size_t i = 0; i < num_points; i++)
+			{
+				brute.emplace_back(distance_sq(pos[i].data(), center.data()), handles[i]);
+			}
+			std::partial_sort(brute.begin(), brute.begin() + knn, brute.end());
+			found += knn;
+		}
+		knn_brute.end();
+
+		if(!check)
+		{
+			continue;
+		}
+		for(const auto &center : centers)
+		{
+			result.clear();
+			expected.clear();
+			grid.query_radius(center.data(), radius, [&](size_t handle)
+			{
+				result.push_back(handle);
+				return true;
+			});
+			for(size_t i = 0; i < num_points; i++)
+			{
+				if(distance_sq(pos[i].data(), center.data()) <= radius * radius)
+				{
+					expected.push_back(handles[i]);
+				}
+			}
+			std::sort(result.begin(), result.end());
+			std::sort(expected.begin(), expected.end());
+			mismatches += result != expected;
+
+			result.clear();
+			expected.clear();
+			float min[3] = {center[0] - box_half, center[1] - box_half, center[2] - box_half};
+			float max[3] = {center[0] + box_half, center[1] + box_half, center[2] + box_half};
+			grid.query_box(min, max, [&](size_t handle)
+			{
+				result.push_back(handle);
+				return true;
+			});
+			for(size_t i = 0; i < num_points; i++)
+			{
+				const float *p = pos[i].data();
+				if(p[0] >= min[0] && p[0] <= max[0] && p[1] >= min[1] && p[1] <= max[1] && p[2] >= min[2] && p[2] <= max[2])
+				{
+					expected.push_back(handles[i]);
+				}
+			}
+			std::sort(result.begin(), result.end());
+			std::sort(expected.begin(), expected.end());
+			mismatches += result != expected;
+
+			grid.nearest(center.data(), knn, -1, nearest);
+			brute.clear();
+			for(size_t i = 0; i < num_points; i++)
+			{
+				brute.emplace_back(distance_sq(pos[i].data(), center.data()), handles[i]);
+			}
+			std::partial_sort(brute.begin(), brute.begin() + knn, brute.end());
+			for(size_t k = 0; k < knn; k++)
+			{
+				// equally distant points may come in either order
+				mismatches += nearest.size() != knn || nearest[k].first != brute[k].first;
+			}
+		}
+	}
+
+	std::printf("%zu points in %gx%gx%g, cell size %g, moving up to %g per tick\n", num_points, area[0], area[1], area[2], cell_size, max_step);
+	std::printf("per tick, average over %d ticks, ms (grid / brute force):\n", num_ticks);
+	char label[64];
+	std::printf("  %-30s %8.3f\n", "move all points", move.total / num_ticks);
+	std::snprintf(label, sizeof(label), "%zu radius-%g queries", num_queries, radius);
+	std::printf("  %-30s %8.3f / %8.3f\n", label, radius_grid.total / num_ticks, radius_brute.total / num_ticks);
+	std::snprintf(label, sizeof(label), "%zu %gx%g column boxes", num_queries, 2 * box_half, 2 * box_half);
+	std::printf("  %-30s %8.3f / %8.3f\n", label, box_grid.total / num_ticks, box_brute.total / num_ticks);
+	std::snprintf(label, sizeof(label), "%zu %zu-nearest queries", num_queries, knn);
+	std::printf("  %-30s %8.3f / %8.3f\n", label, knn_grid.total / num_ticks, knn_brute.total / num_ticks);
+	if(check)
+	{
+		std::printf("results checked against brute force: %zu mismatches\n", mismatches);
+	}
+	std::printf("(%zu results)\n", found);
+	return mismatches != 0;
+}
@@ -45,6 +45,7 @@ namespace amx
 		friend bool invalidate(AMX *amx);
 
 		AMX *_amx;
+		AMX *_origin;
 		std::unordered_map<std::type_index, std::unique_ptr<extra>> extras;
 		bool initialized = false;
 
@@ -57,17 +58,17 @@ namespace amx
 		std::string name;
 		std::shared_ptr<AMX_DBG> dbg;
 
-		instance() : _amx(nullptr)
+		instance() : _amx(nullptr), _origin(nullptr)
 		{
 
 		}
 
-		explicit instance(AMX *amx) : _amx(amx)
+		explicit instance(AMX *amx) : _amx(amx), _origin(amx)
 		{
 
 		}
 
-		instance(const instance &obj, AMX *new_amx) : _amx(new_amx), name(obj.name), dbg(obj.dbg)
+		instance(const instance &obj, AMX *new_amx) : _amx(new_amx), _origin(obj._origin), name(obj.name), dbg(obj.dbg)
 		{
 			for(const auto &pair : obj.extras)
 			{
@@ -83,7 +84,7 @@ namespace amx
 		}
 
 		instance(const instance &obj) = delete;
-		instance(instance &&obj) : _amx(obj._amx), extras(std::move(obj.extras)), name(std::move(obj.name)), dbg(std::move(obj.dbg))
+		instance(instance &&obj) : _amx(obj._amx), _origin(obj._origin), extras(std::move(obj.extras)), name(std::move(obj.name)), dbg(std::move(obj.dbg))
 		{
 			obj._amx = nullptr;
 			obj.extras.clear();
@@ -100,6 +101,7 @@ namespace amx
 			if(this != &obj)
 			{
 				_amx = obj._amx;
+				_origin = obj._origin;
 				extras = std::move(obj.extras);
 				name = std::move(obj.name);
 				dbg = std::move(obj.dbg);
@@ -150,6 +152,12 @@ namespace amx
 			return _amx;
 		}
 
+		// The script the instance was loaded from (forks are cloned from their origin)
+		AMX *origin() const
+		{
+			return _origin;
+		}
+
 		operator AMX*()
 		{
 			return _amx;
@@ -21,6 +21,7 @@ namespace pp
 	string_table string;
 	variant_table variant;
 	task_table task;
+	heap_table heap;
 }
 
 bool pp::load()
@@ -45,6 +46,7 @@ bool pp::load()
 		string.load(table[6]);
 		variant.load(table[7]);
 		task.load(table[8]);
+		heap.load(table[9]);
 		return true;
 	}
 	return false;
@@ -53,5 +55,9 @@ bool pp::load()
 void pp::api_table::load(void **ptr)
 {
 	_ptr = ptr;
-	for(_size = 0; ptr[_size]; _size++);
+	_size = 0;
+	if(ptr)
+	{
+		for(; ptr[_size]; _size++);
+	}
 }
@@ -628,6 +628,80 @@ namespace pp
 		}
 	};
 
+	class heap_table : public api_table
+	{
+	public:
+		void *create(bool max) const
+		{
+			return get<void*(bool max)>(0)(max);
+		}
+
+		void remove(void *heap) const
+		{
+			return get<void(void *heap)>(1)(heap);
+		}
+
+		cell get_id(void *heap) const
+		{
+			return get<cell(void *heap)>(2)(heap);
+		}
+
+		void *from_id(cell id) const
+		{
+			return get<void*(cell id)>(3)(id);
+		}
+
+		size_t get_size(const void *heap) const
+		{
+			return get<cell(const void *heap)>(4)(heap);
+		}
+
+		cell push_copy(void *heap, const void *key, const void *value) const
+		{
+			return get<cell(void *heap, const void *key, const void *value)>(5)(heap, key, value);
+		}
+
+		cell push_move(void *heap, void *key, void *value) const
+		{
+			return get<cell(void *heap, void *key, void *value)>(6)(heap, key, value);
+		}
+
+		void *top(void *heap) const
+		{
+			return get<void*(void *heap)>(7)(heap);
+		}
+
+		bool top_key(const void *heap, void *key) const
+		{
+			return get<bool(const void *heap, void *key)>(8)(heap, key);
+		}
+
+		bool pop(void *heap, void *value) const
+		{
+			return get<bool(void *heap, void *value)>(9)(heap, value);
+		}
+
+		bool update(void *heap, cell handle, const void *key) const
+		{
+			return get<bool(void *heap, cell handle, const void *key)>(10)(heap, handle, key);
+		}
+
+		bool remove_handle(void *heap, cell handle) const
+		{
+			return get<bool(void *heap, cell handle)>(11)(heap, handle);
+		}
+
+		void clear(void *heap) const
+		{
+			return get<void(void *heap)>(12)(heap);
+		}
+
+		void *get_handle(void *heap) const
+		{
+			return get<void*(void *heap)>(13)(heap);
+		}
+	};
+
 	extern main_table main;
 	extern tag_table tag;
 	extern dyn_object_table dyn_object;
@@ -637,6 +711,7 @@ namespace pp
 	extern string_table string;
 	extern variant_table variant;
 	extern task_table task;
+	extern heap_table heap;
 }
 
 #endif
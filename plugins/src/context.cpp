@@ -1,10 +1,12 @@
 #include "context.h"
 #include "main.h"
+#include "utils/owner_list.h"
 
 #include <unordered_map>
 #include <forward_list>
 #include <deque>
 #include <stdexcept>
+#include <vector>
 
 int globalExecLevel = 0;
 bool groundRecursion = false;
@@ -51,12 +53,15 @@ public:
 };
 
 invocation_list<void, AMX*> ground_callbacks;
+std::vector<AMX*> owner_stack;
 
 int amx::push(AMX *amx, int index)
 {
 	globalExecLevel++;
 	amx::object obj;
 	get_state(amx, obj).contexts.emplace_back(amx, index);
+	owner_stack.push_back(aux::object_owner());
+	aux::object_owner() = obj->origin();
 	return globalExecLevel;
 }
 
@@ -73,6 +78,8 @@ int amx::pop(AMX *amx)
 		auto top = std::move(contexts.back());
 		contexts.pop_back();
 	}
+	aux::object_owner() = owner_stack.back();
+	owner_stack.pop_back();
 
 	globalExecLevel--;
 	if(globalExecLevel == 0)
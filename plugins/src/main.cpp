@@ -12,6 +12,7 @@
 #include "modules/tags.h"
 #include "modules/debug.h"
 #include "modules/expressions.h"
+#include "modules/amxutils.h"
 
 #include "sdk/amx/amx.h"
 #include "sdk/plugincommon.h"
@@ -60,6 +61,10 @@ PLUGIN_EXPORT void PLUGIN_CALL Unload() noexcept
 	map_pool.clear();
 	linked_list_pool.clear();
 	pool_pool.clear();
+	heap_pool.clear();
+	spatial_pool.clear();
+	frozen_list_pool.clear();
+	frozen_map_pool.clear();
 	expression_pool.clear();
 	iter_pool.clear();
 	tasks::clear();
@@ -81,8 +86,56 @@ PLUGIN_EXPORT int PLUGIN_CALL AmxLoad(AMX *amx) noexcept
 	return AMX_ERR_NONE;
 }
 
+static void release_owned(AMX *amx)
+{
+	bool cleanup = false;
+	if(amx::valid(amx))
+	{
+		auto &obj = amx::load_lock(amx);
+		if(obj->has_extra<native_unload_cleanup>())
+		{
+			cleanup = obj->get_extra<native_unload_cleanup>().cleanup;
+		}
+	}
+	if(cleanup)
+	{
+		tasks::release_owner(amx);
+		pool_pool.release_owner(amx);
+		heap_pool.release_owner(amx);
+		spatial_pool.release_owner(amx);
+		frozen_list_pool.release_owner(amx);
+		frozen_map_pool.release_owner(amx);
+		linked_list_pool.release_owner(amx);
+		map_pool.release_owner(amx);
+		list_pool.release_owner(amx);
+		iter_pool.release_owner(amx);
+		handle_pool.release_owner(amx);
+		expression_pool.release_owner(amx);
+		variants::pool.release_owner(amx);
+		strings::pool.release_owner(amx);
+		amx_var_pool.release_owner(amx);
+	}else{
+		tasks::forget_owner(amx);
+		pool_pool.forget_owner(amx);
+		heap_pool.forget_owner(amx);
+		spatial_pool.forget_owner(amx);
+		frozen_list_pool.forget_owner(amx);
+		frozen_map_pool.forget_owner(amx);
+		linked_list_pool.forget_owner(amx);
+		map_pool.forget_owner(amx);
+		list_pool.forget_owner(amx);
+		iter_pool.forget_owner(amx);
+		handle_pool.forget_owner(amx);
+		expression_pool.forget_owner(amx);
+		variants::pool.forget_owner(amx);
+		strings::pool.forget_owner(amx);
+		amx_var_pool.forget_owner(amx);
+	}
+}
+
 PLUGIN_EXPORT int PLUGIN_CALL AmxUnload(AMX *amx) noexcept
 {
+	release_owned(amx);
 	amx::invalidate(amx);
 	amx::unload(amx);
 	return AMX_ERR_NONE;
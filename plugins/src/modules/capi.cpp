@@ -442,7 +442,11 @@ static func_ptr string_functions[] = {
 	},
 	+[]/*delete_string*/(void *str) -> void
 	{
-		strings::pool.remove(*static_cast<string_ptr>(str));
+		auto &ptr = *static_cast<string_ptr>(str);
+		if(!strings::is_interned(strings::pool.get_id(ptr), *ptr))
+		{
+			strings::pool.remove(ptr);
+		}
 	},
 	+[]/*string_get_id*/(void *str) -> cell
 	{
@@ -459,11 +463,11 @@ static func_ptr string_functions[] = {
 	},
 	+[]/*string_acquire*/(void *str) -> cell
 	{
-		return static_cast<string_ptr>(str)->acquire();
+		return strings::pool.acquire_ref(*static_cast<string_ptr>(str));
 	},
 	+[]/*string_release*/(void *str) -> cell
 	{
-		return static_cast<string_ptr>(str)->release();
+		return strings::pool.release_ref(*static_cast<string_ptr>(str));
 	},
 	+[]/*string_get_size*/(const void *str) -> cell
 	{
@@ -521,11 +525,11 @@ static func_ptr variant_functions[] = {
 	},
 	+[]/*variant_acquire*/(void *var) -> cell
 	{
-		return static_cast<variant_ptr>(var)->acquire();
+		return variants::pool.acquire_ref(*static_cast<variant_ptr>(var));
 	},
 	+[]/*variant_release*/(void *var) -> cell
 	{
-		return static_cast<variant_ptr>(var)->release();
+		return variants::pool.release_ref(*static_cast<variant_ptr>(var));
 	},
 	+[]/*variant_get_size*/(const void *var) -> cell
 	{
@@ -644,6 +648,93 @@ static func_ptr task_functions[] = {
 	nullptr
 };
 
+static func_ptr heap_functions[] = {
+	+[]/*new_heap*/(bool max) -> void*
+	{
+		return &*heap_pool.emplace(max);
+	},
+	+[]/*delete_heap*/(void *heap) -> void
+	{
+		heap_pool.remove(static_cast<heap_t*>(heap));
+	},
+	+[]/*heap_get_id*/(void *heap) -> cell
+	{
+		return heap_pool.get_id(static_cast<heap_t*>(heap));
+	},
+	+[]/*heap_from_id*/(cell id) -> void*
+	{
+		heap_t *ptr;
+		if(heap_pool.get_by_id(id, ptr))
+		{
+			return ptr;
+		}
+		return nullptr;
+	},
+	+[]/*heap_get_size*/(const void *heap) -> cell
+	{
+		return static_cast<const heap_t*>(heap)->size();
+	},
+	+[]/*heap_push_copy*/(void *heap, const void *key, const void *value) -> cell
+	{
+		return static_cast<heap_t*>(heap)->push(dyn_object(*static_cast<const dyn_object*>(key)), dyn_object(*static_cast<const dyn_object*>(value)));
+	},
+	+[]/*heap_push_move*/(void *heap, void *key, void *value) -> cell
+	{
+		return static_cast<heap_t*>(heap)->push(std::move(*static_cast<dyn_object*>(key)), std::move(*static_cast<dyn_object*>(value)));
+	},
+	+[]/*heap_top*/(void *heap) -> void*
+	{
+		auto ptr = static_cast<heap_t*>(heap);
+		if(ptr->size() == 0)
+		{
+			return nullptr;
+		}
+		return const_cast<dyn_object*>(&ptr->top().value);
+	},
+	+[]/*heap_top_key*/(const void *heap, void *key) -> bool
+	{
+		auto ptr = static_cast<const heap_t*>(heap);
+		if(ptr->size() == 0)
+		{
+			return false;
+		}
+		*static_cast<dyn_object*>(key) = ptr->key_of(ptr->top());
+		return true;
+	},
+	+[]/*heap_pop*/(void *heap, void *value) -> bool
+	{
+		auto ptr = static_cast<heap_t*>(heap);
+		if(ptr->size() == 0)
+		{
+			return false;
+		}
+		*static_cast<dyn_object*>(value) = std::move(ptr->pop().value);
+		return true;
+	},
+	+[]/*heap_update*/(void *heap, cell handle, const void *key) -> bool
+	{
+		return static_cast<heap_t*>(heap)->update(static_cast<ucell>(handle), dyn_object(*static_cast<const dyn_object*>(key)));
+	},
+	+[]/*heap_remove*/(void *heap, cell handle) -> bool
+	{
+		return static_cast<heap_t*>(heap)->remove(static_cast<ucell>(handle));
+	},
+	+[]/*heap_clear*/(void *heap) -> void
+	{
+		static_cast<heap_t*>(heap)->clear();
+	},
+	+[]/*heap_get_handle*/(void *heap) -> void*
+	{
+		auto ptr = heap_pool.get(static_cast<heap_t*>(heap));
+		if(ptr)
+		{
+			return new std::weak_ptr<const void>(ptr);
+		}
+		return nullptr;
+	},
+	nullptr
+};
+
 static void *func_table[] = {
 	&main_functions,
 	&tag_functions,
@@ -654,6 +745,7 @@ static void *func_table[] = {
 	&string_functions,
 	&variant_functions,
 	&task_functions,
+	&heap_functions,
 	nullptr
 };
 
@@ -1,29 +1,165 @@
 #include "containers.h"
 
+#include <stdexcept>
+
 aux::shared_id_set_pool<list_t> list_pool;
 aux::shared_id_set_pool<map_t> map_pool;
 aux::shared_id_set_pool<linked_list_t> linked_list_pool;
 aux::shared_id_set_pool<pool_t> pool_pool;
-object_pool<dyn_iterator> iter_pool;
-object_pool<handle_t> handle_pool;
+aux::shared_id_set_pool<heap_t> heap_pool;
+aux::shared_id_set_pool<spatial_t> spatial_pool;
+aux::sync_id_set_pool<frozen_list_t> frozen_list_pool;
+aux::sync_id_set_pool<frozen_map_t> frozen_map_pool;
+object_pool<dyn_iterator> iter_pool(true);
+object_pool<handle_t> handle_pool(true);
 
-void list_t::push_back(dyn_object &&value)
+static bool plain_tag(tag_ptr tag)
 {
-	bool invalidate = data.size() == data.capacity();
-	data.push_back(std::move(value));
-	if(invalidate)
+	switch(tag->uid)
+	{
+		case tags::tag_cell:
+		case tags::tag_bool:
+		case tags::tag_char:
+		case tags::tag_float:
+			return true;
+	}
+	return false;
+}
+
+bool list_t::packs(const dyn_object &value) const
+{
+	if(!value.is_cell())
+	{
+		return false;
+	}
+	if(packed())
+	{
+		return value.get_tag() == cell_tag;
+	}
+	return data.empty() && plain_tag(value.get_tag());
+}
+
+bool list_t::pack()
+{
+	if(packed())
+	{
+		return true;
+	}
+	if(data.empty())
+	{
+		return false;
+	}
+	tag_ptr tag = data[0].get_tag();
+	if(!plain_tag(tag))
+	{
+		return false;
+	}
+	for(const auto &obj : data)
 	{
+		if(!obj.is_cell() || obj.get_tag() != tag)
+		{
+			return false;
+		}
+	}
+	cells.reserve(data.size());
+	for(const auto &obj : data)
+	{
+		cells.push_back(obj.get_cell(0));
+	}
+	std::vector<dyn_object>().swap(data);
+	cell_tag = tag;
+	bool live = index_current() && index_plain;
+	++revision;
+	if(live)
+	{
+		index_revision = revision;
+	}
+	return true;
+}
+
+void list_t::unpack()
+{
+	if(packed())
+	{
+		data.reserve(cells.size());
+		for(cell value : cells)
+		{
+			data.emplace_back(value, cell_tag);
+		}
+		std::vector<cell>().swap(cells);
+		cell_tag = nullptr;
+	}
+}
+
+void list_t::clear()
+{
+	if(packed())
+	{
+		std::vector<cell>().swap(cells);
+		cell_tag = nullptr;
 		++revision;
+	}else{
+		collection_base::clear();
+	}
+}
+
+void list_t::push_back(dyn_object &&value)
+{
+	bool live = index_current();
+	if(live)
+	{
+		index_add(value, size());
+	}
+	if(packs(value))
+	{
+		if(!packed())
+		{
+			cell_tag = value.get_tag();
+			++revision;
+		}
+		cells.push_back(value.get_cell(0));
+	}else{
+		unpack();
+		bool invalidate = data.size() == data.capacity();
+		data.push_back(std::move(value));
+		if(invalidate)
+		{
+			++revision;
+		}
+	}
+	if(live)
+	{
+		index_revision = revision;
 	}
 }
 
 void list_t::push_back(const dyn_object &value)
 {
-	bool invalidate = data.size() == data.capacity();
-	data.push_back(value);
-	if(invalidate)
+	bool live = index_current();
+	if(live)
 	{
-		++revision;
+		index_add(value, size());
+	}
+	if(packs(value))
+	{
+		if(!packed())
+		{
+			cell_tag = value.get_tag();
+			++revision;
+		}
+		cells.push_back(value.get_cell(0));
+	}else{
+		unpack();
+		bool invalidate = data.size() == data.capacity();
+		data.push_back(value);
+		if(invalidate)
+		{
+			++revision;
+		}
+	}
+	if(live)
+	{
+		index_revision = revision;
 	}
 }
 
@@ -69,8 +205,122 @@ bool list_t::insert_dyn(iterator position, const std::type_info &type, const voi
 	return false;
 }
 
+void list_t::insert_at(size_t index, dyn_object &&value)
+{
+	if(index == size())
+	{
+		push_back(std::move(value));
+	}else if(packed() && packs(value))
+	{
+		cells.insert(cells.begin() + index, value.get_cell(0));
+		++revision;
+	}else{
+		unpack();
+		insert(data.begin() + index, std::move(value));
+	}
+}
+
+void list_t::set_at(size_t index, dyn_object &&value)
+{
+	if(index_current())
+	{
+		if(index_plain)
+		{
+			index_remove(index);
+			index_add(value, index);
+		}else{
+			// the replaced value may have been the only one preventing the index
+			invalidate_index();
+		}
+	}
+	if(packed())
+	{
+		if(packs(value))
+		{
+			cells[index] = value.get_cell(0);
+			return;
+		}
+		unpack();
+	}
+	data[index] = std::move(value);
+}
+
+void list_t::erase_at(size_t first, size_t last)
+{
+	// only removing from the end keeps the other positions
+	bool live = index_current() && index_plain && last == size();
+	if(live)
+	{
+		for(size_t i = first; i < last; i++)
+		{
+			index_remove(i);
+		}
+	}
+	if(packed())
+	{
+		cells.erase(cells.begin() + first, cells.begin() + last);
+		++revision;
+	}else{
+		erase(data.begin() + first, data.begin() + last);
+	}
+	if(live)
+	{
+		index_revision = revision;
+	}
+}
+
+void list_t::set_range(size_t index, const cell *values, size_t count, tag_ptr tag)
+{
+	if(count == 0)
+	{
+		return;
+	}
+	invalidate_index();
+	size_t end = index + count;
+	if(packed() ? tag == cell_tag : data.empty() && plain_tag(tag))
+	{
+		bool invalidate = !packed() || end > cells.capacity();
+		cell_tag = tag;
+		if(end > cells.size())
+		{
+			cells.resize(end);
+		}
+		std::copy(values, values + count, cells.begin() + index);
+		if(invalidate)
+		{
+			++revision;
+		}
+		return;
+	}
+	unpack();
+	bool invalidate = end > data.capacity();
+	if(end > data.size())
+	{
+		data.resize(end);
+	}
+	for(size_t i = 0; i < count; i++)
+	{
+		data[index + i] = dyn_object(values[i], tag);
+	}
+	if(invalidate)
+	{
+		++revision;
+	}
+}
+
 void list_t::resize(size_t count)
 {
+	invalidate_index();
+	if(packed() && count <= cells.size())
+	{
+		if(count < cells.size())
+		{
+			cells.resize(count);
+			++revision;
+		}
+		return;
+	}
+	unpack();
 	bool invalidate = count < data.size() || count > data.capacity();
 	data.resize(count);
 	if(invalidate)
@@ -81,7 +331,24 @@ void list_t::resize(size_t count)
 
 void list_t::resize(size_t count, const dyn_object &value)
 {
-	bool invalidate = count < data.size() || count > data.capacity();
+	invalidate_index();
+	if(count <= size())
+	{
+		resize(count);
+		return;
+	}
+	if(packs(value))
+	{
+		if(!packed())
+		{
+			cell_tag = value.get_tag();
+		}
+		cells.resize(count, value.get_cell(0));
+		++revision;
+		return;
+	}
+	unpack();
+	bool invalidate = count > data.capacity();
 	data.resize(count, value);
 	if(invalidate)
 	{
@@ -89,70 +356,228 @@ void list_t::resize(size_t count, const dyn_object &value)
 	}
 }
 
+void list_t::reserve(size_t count)
+{
+	if(packed())
+	{
+		cells.reserve(count);
+		return;
+	}
+	if(count > data.capacity())
+	{
+		++revision;
+	}
+	data.reserve(count);
+}
+
+size_t list_t::memory_size() const
+{
+	size_t bytes = packed() ? cells.size() * sizeof(cell) : collection_base::memory_size();
+	for(const auto &pair : index)
+	{
+		bytes += sizeof(pair) + pair.first.heap_size() + pair.second.capacity() * sizeof(size_t);
+	}
+	return bytes;
+}
+
+void list_t::set_indexed(bool indexed)
+{
+	this->indexed = indexed;
+	if(!indexed)
+	{
+		std::unordered_map<dyn_object, std::vector<size_t>>().swap(index);
+	}
+	invalidate_index();
+}
+
+void list_t::index_add(const dyn_object &value, size_t pos)
+{
+	if(!index_plain)
+	{
+		return;
+	}
+	if(!plain_tag(value.get_tag()))
+	{
+		// the hash of a string or a handle changes with the object it refers to
+		index.clear();
+		index_plain = false;
+		return;
+	}
+	auto &positions = index[value];
+	if(positions.empty() || positions.back() < pos)
+	{
+		positions.push_back(pos);
+	}else{
+		positions.insert(std::lower_bound(positions.begin(), positions.end(), pos), pos);
+	}
+}
+
+void list_t::index_remove(size_t pos)
+{
+	auto it = packed() ? index.find(dyn_object(cells[pos], cell_tag)) : index.find(data[pos]);
+	if(it != index.end())
+	{
+		auto &positions = it->second;
+		auto found = std::lower_bound(positions.begin(), positions.end(), pos);
+		if(found != positions.end() && *found == pos)
+		{
+			positions.erase(found);
+		}
+		if(positions.empty())
+		{
+			index.erase(it);
+		}
+	}
+}
+
+const std::vector<size_t> *list_t::find_index(const dyn_object &value)
+{
+	if(!indexed || !plain_tag(value.get_tag()))
+	{
+		return nullptr;
+	}
+	if(index_revision != revision)
+	{
+		index.clear();
+		index_plain = true;
+		if(packed())
+		{
+			for(size_t i = 0; i < cells.size(); i++)
+			{
+				index[dyn_object(cells[i], cell_tag)].push_back(i);
+			}
+		}else{
+			for(size_t i = 0; i < data.size() && index_plain; i++)
+			{
+				index_add(data[i], i);
+			}
+		}
+		index_revision = revision;
+	}
+	if(!index_plain)
+	{
+		return nullptr;
+	}
+	static const std::vector<size_t> none;
+	auto it = index.find(value);
+	if(it != index.end())
+	{
+		return &it->second;
+	}
+	return &none;
+}
+
+str_key::str_key(const cell *str) : str(str), size(0)
+{
+	// the same cells dyn_object copies from a string
+	if(str != nullptr && str[0])
+	{
+		int len;
+		amx_StrLen(str, &len);
+		if(str[0] & 0xFF000000)
+		{
+			size = 1 + ((len - 1) / sizeof(cell));
+		}else{
+			size = len;
+		}
+	}
+}
 
+static void intern_key(const dyn_object &key)
+{
+	if(dyn_object::intern_keys)
+	{
+		// interning does not change the value or the hash of the key
+		const_cast<dyn_object&>(key).intern();
+	}
+}
 
 dyn_object &map_t::operator[](const dyn_object &key)
 {
-	bool invalidate = data.size() == data.capacity();
+	bool invalidate = data.insert_relocates();
 	auto pair = data.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
-	if(pair.second && invalidate)
+	if(pair.second)
 	{
-		++revision;
+		intern_key(pair.first->first);
+		if(invalidate)
+		{
+			++revision;
+		}
 	}
 	return pair.first->second;
 }
 
 dyn_object &map_t::operator[](dyn_object &&key)
 {
-	bool invalidate = data.size() == data.capacity();
+	bool invalidate = data.insert_relocates();
 	auto pair = data.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
-	if(pair.second && invalidate)
+	if(pair.second)
 	{
-		++revision;
+		intern_key(pair.first->first);
+		if(invalidate)
+		{
+			++revision;
+		}
 	}
 	return pair.first->second;
 }
 
 auto map_t::insert(const dyn_object &key, dyn_object const &value) -> std::pair<iterator, bool>
 {
-	bool invalidate = data.size() == data.capacity();
+	bool invalidate = data.insert_relocates();
 	auto pair = data.emplace(key, value);
-	if(pair.second && invalidate)
+	if(pair.second)
 	{
-		++revision;
+		intern_key(pair.first->first);
+		if(invalidate)
+		{
+			++revision;
+		}
 	}
 	return pair;
 }
 
 auto map_t::insert(const dyn_object &key, dyn_object &&value) -> std::pair<iterator, bool>
 {
-	bool invalidate = data.size() == data.capacity();
+	bool invalidate = data.insert_relocates();
 	auto pair = data.emplace(key, std::move(value));
-	if(pair.second && invalidate)
+	if(pair.second)
 	{
-		++revision;
+		intern_key(pair.first->first);
+		if(invalidate)
+		{
+			++revision;
+		}
 	}
 	return pair;
 }
 
 auto map_t::insert(dyn_object &&key, const dyn_object &value) -> std::pair<iterator, bool>
 {
-	bool invalidate = data.size() == data.capacity();
+	bool invalidate = data.insert_relocates();
 	auto pair = data.emplace(std::move(key), value);
-	if(pair.second && invalidate)
+	if(pair.second)
 	{
-		++revision;
+		intern_key(pair.first->first);
+		if(invalidate)
+		{
+			++revision;
+		}
 	}
 	return pair;
 }
 
 auto map_t::insert(dyn_object &&key, dyn_object &&value) -> std::pair<iterator, bool>
 {
-	bool invalidate = data.size() == data.capacity();
+	bool invalidate = data.insert_relocates();
 	auto pair = data.emplace(std::move(key), std::move(value));
-	if(pair.second && invalidate)
+	if(pair.second)
 	{
-		++revision;
+		intern_key(pair.first->first);
+		if(invalidate)
+		{
+			++revision;
+		}
 	}
 	return pair;
 }
@@ -162,6 +587,11 @@ auto map_t::find(const dyn_object &key) -> iterator
 	return data.find(key);
 }
 
+auto map_t::find(const dyn_object &key) const -> const_iterator
+{
+	return data.find(key);
+}
+
 size_t map_t::erase(const dyn_object &key)
 {
 	size_t size = data.erase(key);
@@ -184,37 +614,344 @@ bool map_t::insert_dyn(iterator position, const std::type_info &type, const void
 	return false;
 }
 
+constexpr size_t heap_t::npos;
+
+bool heap_t::pack_key(const dyn_object &key)
+{
+	if(data.empty())
+	{
+		key_tag = nullptr;
+		if(key.is_cell())
+		{
+			cell uid = key.get_tag()->uid;
+			if(uid == tags::tag_cell || uid == tags::tag_float)
+			{
+				key_tag = key.get_tag();
+			}
+		}
+		return key_tag != nullptr;
+	}
+	if(key_tag)
+	{
+		if(key.is_cell() && key.get_tag() == key_tag)
+		{
+			return true;
+		}
+		unpack();
+	}
+	return false;
+}
+
+void heap_t::unpack()
+{
+	if(key_tag)
+	{
+		for(auto &entry : data)
+		{
+			entry.key = dyn_object(entry.key_cell, key_tag);
+		}
+		key_tag = nullptr;
+	}
+}
+
+void heap_t::set_key(heap_entry &entry, dyn_object &&key)
+{
+	if(pack_key(key))
+	{
+		entry.key_cell = key.get_cell(0);
+		entry.key = dyn_object();
+	}else{
+		entry.key = std::move(key);
+	}
+}
+
+void heap_t::sift_up(size_t index)
+{
+	heap_entry entry = std::move(data[index]);
+	while(index > 0)
+	{
+		size_t parent = (index - 1) / 2;
+		if(!before(entry, data[parent]))
+		{
+			break;
+		}
+		data[index] = std::move(data[parent]);
+		slots[data[index].handle] = index;
+		index = parent;
+	}
+	slots[entry.handle] = index;
+	data[index] = std::move(entry);
+}
+
+void heap_t::sift_down(size_t index)
+{
+	size_t size = data.size();
+	heap_entry entry = std::move(data[index]);
+	while(true)
+	{
+		size_t child = 2 * index + 1;
+		if(child >= size)
+		{
+			break;
+		}
+		if(child + 1 < size && before(data[child + 1], data[child]))
+		{
+			child++;
+		}
+		if(!before(data[child], entry))
+		{
+			break;
+		}
+		data[index] = std::move(data[child]);
+		slots[data[index].handle] = index;
+		index = child;
+	}
+	slots[entry.handle] = index;
+	data[index] = std::move(entry);
+}
+
+void heap_t::restore(size_t index)
+{
+	if(index > 0 && before(data[index], data[(index - 1) / 2]))
+	{
+		sift_up(index);
+	}else{
+		sift_down(index);
+	}
+}
+
+size_t heap_t::push(dyn_object &&key, dyn_object &&value)
+{
+	cell handle = slots.add(data.size());
+	heap_entry entry;
+	set_key(entry, std::move(key));
+	entry.value = std::move(value);
+	entry.handle = slots.index_of(handle);
+	data.push_back(std::move(entry));
+	sift_up(data.size() - 1);
+	++revision;
+	return static_cast<ucell>(handle);
+}
+
+heap_entry heap_t::extract(size_t index)
+{
+	heap_entry entry = std::move(data[index]);
+	slots.release(entry.handle);
+	if(index + 1 < data.size())
+	{
+		data[index] = std::move(data.back());
+		data.pop_back();
+		restore(index);
+	}else{
+		data.pop_back();
+	}
+	if(key_tag)
+	{
+		// the entry no longer knows the tag of its key
+		entry.key = dyn_object(entry.key_cell, key_tag);
+	}
+	++revision;
+	return entry;
+}
+
+bool heap_t::update(size_t handle, dyn_object &&key)
+{
+	heap_entry *entry = find(handle);
+	if(!entry)
+	{
+		return false;
+	}
+	size_t index = index_of(*entry);
+	set_key(data[index], std::move(key));
+	restore(index);
+	++revision;
+	return true;
+}
+
+bool heap_t::remove(size_t handle)
+{
+	heap_entry *entry = find(handle);
+	if(!entry)
+	{
+		return false;
+	}
+	extract(index_of(*entry));
+	return true;
+}
+
+bool heap_t::erase_at(size_t index)
+{
+	size_t moved = data.back().handle;
+	extract(index);
+	// the last entry takes the place and may rise above it
+	return index >= data.size() || slots[moved] >= index;
+}
+
+auto heap_t::erase(iterator position) -> iterator
+{
+	size_t index = position - data.begin();
+	erase_at(index);
+	return data.begin() + index;
+}
+
+void heap_t::clear()
+{
+	data.clear();
+	// the generations are kept, so handles from before stay invalid
+	slots.clear();
+	key_tag = nullptr;
+	++revision;
+}
+
+size_t heap_t::memory_size() const
+{
+	size_t bytes = data.size() * sizeof(heap_entry) + slots.memory_size();
+	for_each_object([&](const dyn_object &obj)
+	{
+		bytes += obj.heap_size();
+	});
+	return bytes;
+}
+
+size_t spatial_t::memory_size() const
+{
+	size_t bytes = spatial_grid::memory_size();
+	for_each_object([&](const dyn_object &obj)
+	{
+		bytes += obj.heap_size();
+	});
+	return bytes;
+}
+
+frozen_list_t::frozen_list_t(const list_t &list) : cell_tag(list.get_cell_tag())
+{
+	if(packed())
+	{
+		cells = list.get_cells();
+	}else{
+		data = list.get_data();
+	}
+}
+
+size_t frozen_list_t::memory_size() const
+{
+	if(packed())
+	{
+		return cells.size() * sizeof(cell);
+	}
+	size_t bytes = data.size() * sizeof(dyn_object);
+	for(const auto &obj : data)
+	{
+		bytes += obj.heap_size();
+	}
+	return bytes;
+}
+
+frozen_map_t::frozen_map_t(const map_t &map)
+{
+	std::vector<std::pair<size_t, const map_t::value_type*>> order;
+	order.reserve(map.size());
+	for(auto it = map.cbegin(); it != map.cend(); ++it)
+	{
+		const dyn_object &key = it->first;
+		order.emplace_back(key_hash(key.get_tag()->uid, key.get_rank(), key.begin(), key.end()), &*it);
+	}
+	std::stable_sort(order.begin(), order.end(), [](const std::pair<size_t, const map_t::value_type*> &a, const std::pair<size_t, const map_t::value_type*> &b)
+	{
+		return a.first < b.first;
+	});
+	data.reserve(order.size());
+	hashes.reserve(order.size());
+	for(const auto &entry : order)
+	{
+		data.emplace_back(entry.second->first, entry.second->second);
+		hashes.push_back(entry.first);
+	}
+}
+
+bool frozen_map_t::key_supported(const dyn_object &key)
+{
+	return !key.is_null() && plain_tag(key.get_tag());
+}
+
+size_t frozen_map_t::key_hash(cell tag_uid, cell rank, const cell *begin, const cell *end)
+{
+	while(end != begin && *(end - 1) == 0)
+	{
+		--end;
+	}
+	size_t hash = std::hash<cell>()(tag_uid);
+	hash ^= std::hash<cell>()(rank) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	for(auto it = begin; it != end; ++it)
+	{
+		hash ^= std::hash<cell>()(*it) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	}
+	return hash;
+}
+
+auto frozen_map_t::find(const dyn_object &key) const -> const value_type*
+{
+	if(key.is_null())
+	{
+		return nullptr;
+	}
+	cell uid = key.get_tag()->uid;
+	cell rank = key.get_rank();
+	const cell *begin = key.begin(), *end = key.end();
+	size_t hash = key_hash(uid, rank, begin, end);
+	for(auto it = std::lower_bound(hashes.begin(), hashes.end(), hash); it != hashes.end() && *it == hash; ++it)
+	{
+		const value_type &pair = data[it - hashes.begin()];
+		const dyn_object &other = pair.first;
+		if(other.get_tag()->uid == uid && other.get_rank() == rank && other.end() - other.begin() == end - begin && std::equal(begin, end, other.begin()))
+		{
+			return &pair;
+		}
+	}
+	return nullptr;
+}
+
+size_t frozen_map_t::memory_size() const
+{
+	size_t bytes = data.size() * (sizeof(value_type) + sizeof(size_t));
+	for_each_object([&](const dyn_object &obj)
+	{
+		bytes += obj.heap_size();
+	});
+	return bytes;
+}
+
 
 
 dyn_object &linked_list_t::operator[](size_t index)
 {
 	auto it = data.begin();
 	std::advance(it, index);
-	return **it;
+	return *it;
 }
 
 void linked_list_t::push_back(dyn_object &&value)
 {
-	data.push_back(std::make_shared<dyn_object>(std::move(value)));
+	data.push_back(std::move(value));
 	++revision;
 }
 
 void linked_list_t::push_back(const dyn_object &value)
 {
-	data.push_back(std::make_shared<dyn_object>(value));
+	data.push_back(value);
 	++revision;
 }
 
 auto linked_list_t::insert(iterator position, dyn_object &&value) -> iterator
 {
-	auto it = data.insert(position, std::make_shared<dyn_object>(std::move(value)));
+	auto it = data.insert(position, std::move(value));
 	++revision;
 	return it;
 }
 
 auto linked_list_t::insert(iterator position, const dyn_object &value) -> iterator
 {
-	auto it = data.insert(position, std::make_shared<dyn_object>(value));
+	auto it = data.insert(position, value);
 	++revision;
 	return it;
 }
@@ -371,12 +1108,32 @@ bool dyn_iterator::insert_dyn(const std::type_info &type, const void *value)
 }
 
 
+bool map_iterator_t::extract_dyn(const std::type_info &type, void *value) const
+{
+	if(type == typeid(const value_type*))
+	{
+		if(_state != state::outside && valid())
+		{
+			// reading through a const iterator leaves persistent storage shared
+			*reinterpret_cast<const value_type**>(value) = &*map_t::const_iterator(_position);
+			return true;
+		}
+		return false;
+	}
+	return iterator_impl::extract_dyn(type, value);
+}
+
 bool list_iterator_t::extract_dyn(const std::type_info &type, void *value) const
 {
 	if(_state == state::at_element && valid())
 	{
 		if(type == typeid(value_type*))
 		{
+			if(auto source = _source.lock())
+			{
+				// the element may be written through the pointer
+				source->invalidate_index();
+			}
 			*reinterpret_cast<value_type**>(value) = &*_position;
 			return true;
 		}else if(type == typeid(const value_type*))
@@ -443,7 +1200,7 @@ bool linked_list_iterator_t::empty() const
 {
 	if(auto source = lock_same())
 	{
-		return _position != source->end() && !_before;
+		return _position == source->end() || _before;
 	}
 	return false;
 }
@@ -462,7 +1219,7 @@ bool linked_list_iterator_t::move_next()
 			++_position;
 			if(_position != source->end())
 			{
-				_current = *_position;
+				_current = linked_list_t::pin(_position);
 				return true;
 			}else{
 				_current.reset();
@@ -487,7 +1244,7 @@ bool linked_list_iterator_t::move_previous()
 			return false;
 		}
 		--_position;
-		_current = *_position;
+		_current = linked_list_t::pin(_position);
 		return true;
 	}
 	return false;
@@ -501,7 +1258,7 @@ bool linked_list_iterator_t::set_to_first()
 		_before = false;
 		if(_position != source->end())
 		{
-			_current = *_position;
+			_current = linked_list_t::pin(_position);
 			return true;
 		}else{
 			_current.reset();
@@ -519,7 +1276,7 @@ bool linked_list_iterator_t::set_to_last()
 		if(_position != source->begin())
 		{
 			--_position;
-			_current = *_position;
+			_current = linked_list_t::pin(_position);
 			return true;
 		}else{
 			_current.reset();
@@ -563,7 +1320,7 @@ bool linked_list_iterator_t::erase(bool stay)
 			_position = source->erase(_position);
 			if(_position != source->end())
 			{
-				_current = *_position;
+				_current = linked_list_t::pin(_position);
 				if(stay)
 				{
 					_before = true;
@@ -615,7 +1372,7 @@ bool linked_list_iterator_t::operator==(const dyn_iterator &obj) const
 	auto other = dynamic_cast<const linked_list_iterator_t*>(&obj);
 	if(other != nullptr)
 	{
-		return !_source.owner_before(other->_source) && !other->_source.owner_before(_source) && _position == other->_position && !_current.owner_before(other->_current) && !other->_current.owner_before(_current) && _before == other->_before;
+		return !_source.owner_before(other->_source) && !other->_source.owner_before(_source) && _position == other->_position && _current == other->_current && _before == other->_before;
 	}
 	return false;
 }
@@ -626,15 +1383,11 @@ bool linked_list_iterator_t::extract_dyn(const std::type_info &type, void *value
 	{
 		if(type == typeid(dyn_object*))
 		{
-			*reinterpret_cast<dyn_object**>(value) = &**_position;
+			*reinterpret_cast<dyn_object**>(value) = &*_position;
 			return true;
 		}else if(type == typeid(const dyn_object*))
 		{
-			*reinterpret_cast<const dyn_object**>(value) = &**_position;
-			return true;
-		}else if(type == typeid(value_type*))
-		{
-			*reinterpret_cast<value_type**>(value) = &*_position;
+			*reinterpret_cast<const dyn_object**>(value) = &*_position;
 			return true;
 		}
 	}
@@ -647,7 +1400,7 @@ bool linked_list_iterator_t::insert_dyn(const std::type_info &type, void *value)
 	{
 		if(source->insert_dyn(_position, type, value, _position))
 		{
-			_current = *_position;
+			_current = linked_list_t::pin(_position);
 			_before = false;
 			return true;
 		}
@@ -661,7 +1414,7 @@ bool linked_list_iterator_t::insert_dyn(const std::type_info &type, const void *
 	{
 		if(source->insert_dyn(_position, type, value, _position))
 		{
-			_current = *_position;
+			_current = linked_list_t::pin(_position);
 			_before = false;
 			return true;
 		}
@@ -696,3 +1449,31 @@ bool pool_iterator_t::extract_dyn(const std::type_info &type, void *value) const
 	}
 	return false;
 }
+
+bool heap_iterator_t::extract_dyn(const std::type_info &type, void *value) const
+{
+	if(_state == state::at_element && valid())
+	{
+		if(type == typeid(dyn_object*))
+		{
+			*reinterpret_cast<dyn_object**>(value) = &_position->value;
+			return true;
+		}else if(type == typeid(const dyn_object*))
+		{
+			*reinterpret_cast<const dyn_object**>(value) = &_position->value;
+			return true;
+		}else if(type == typeid(std::shared_ptr<const std::pair<const dyn_object, dyn_object>>))
+		{
+			if(auto source = lock_same())
+			{
+				if(_position != source->end())
+				{
+					auto fake_pair = std::make_shared<std::pair<const dyn_object, dyn_object>>(std::pair<const dyn_object, dyn_object>(source->key_of(*_position), _position->value));
+					*reinterpret_cast<std::shared_ptr<const std::pair<const dyn_object, dyn_object>>*>(value) = std::move(fake_pair);
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
@@ -4,8 +4,12 @@
 #include "objects/object_pool.h"
 #include "objects/dyn_object.h"
 #include "utils/shared_id_set_pool.h"
+#include "utils/sync_id_set_pool.h"
 #include "utils/hybrid_map.h"
 #include "utils/hybrid_pool.h"
+#include "utils/node_list.h"
+#include "utils/handle_table.h"
+#include "utils/spatial_grid.h"
 #include "fixes/linux.h"
 
 #include "sdk/amx/amx.h"
@@ -13,11 +17,29 @@
 #include <vector>
 #include <unordered_map>
 #include <list>
+#include <deque>
 #include <memory>
 #include <exception>
 #include <typeinfo>
 #include <functional>
 #include <iterator>
+#include <cmath>
+
+namespace impl
+{
+	template <class Func>
+	void visit_objects(const dyn_object &obj, Func &func)
+	{
+		func(obj);
+	}
+
+	template <class Key, class Value, class Func>
+	void visit_objects(const std::pair<Key, Value> &pair, Func &func)
+	{
+		visit_objects(pair.first, func);
+		visit_objects(pair.second, func);
+	}
+}
 
 template <class Type>
 class collection_base
@@ -104,6 +126,28 @@ public:
 		return revision;
 	}
 
+	// Calls the function on every stored object, including map keys
+	template <class Func>
+	void for_each_object(Func func) const
+	{
+		// not all of the underlying containers provide const iteration
+		for(const auto &value : const_cast<Type&>(data))
+		{
+			impl::visit_objects(value, func);
+		}
+	}
+
+	// Approximate number of bytes held by the elements
+	size_t memory_size() const
+	{
+		size_t bytes = data.size() * sizeof(value_type);
+		for_each_object([&](const dyn_object &obj)
+		{
+			bytes += obj.heap_size();
+		});
+		return bytes;
+	}
+
 	void swap(collection_base<Type> &other)
 	{
 		std::swap(data, other.data);
@@ -124,24 +168,93 @@ public:
 
 class list_t : public collection_base<std::vector<dyn_object>>
 {
+	// single cells with a common plain tag are stored without dyn_object
+	std::vector<cell> cells;
+	tag_ptr cell_tag = nullptr;
+
+	// positions of every value, valid only while index_revision matches revision
+	std::unordered_map<dyn_object, std::vector<size_t>> index;
+	bool indexed = false;
+	// false if some value has a tag whose equality may depend on other objects, so the index is not used
+	bool index_plain = true;
+	int index_revision = 0;
+
+	bool packs(const dyn_object &value) const;
+
+	bool index_current() const
+	{
+		return indexed && index_revision == revision;
+	}
+	void index_add(const dyn_object &value, size_t pos);
+	void index_remove(size_t pos);
+
 public:
+	void invalidate_index()
+	{
+		// elements may be modified in place without a new revision
+		index_revision = revision - 1;
+	}
+
 	typedef typename std::vector<dyn_object>::reverse_iterator reverse_iterator;
+	iterator begin()
+	{
+		unpack();
+		invalidate_index();
+		return data.begin();
+	}
+	iterator end()
+	{
+		unpack();
+		invalidate_index();
+		return data.end();
+	}
+	const_iterator cbegin()
+	{
+		unpack();
+		return data.cbegin();
+	}
+	const_iterator cend()
+	{
+		unpack();
+		return data.cend();
+	}
 	reverse_iterator rbegin()
 	{
+		unpack();
+		invalidate_index();
 		return data.rbegin();
 	}
 	reverse_iterator rend()
 	{
+		unpack();
+		invalidate_index();
 		return data.rend();
 	}
 	dyn_object &operator[](size_t index)
 	{
+		unpack();
+		invalidate_index();
 		return data[index];
 	}
+	// const access never unpacks, so it only reads lists that are not packed
 	const dyn_object &operator[](size_t index) const
 	{
 		return data[index];
 	}
+	// Copy of an element, read from the cells of a packed list
+	dyn_object value_at(size_t index) const
+	{
+		if(packed())
+		{
+			return dyn_object(cells[index], cell_tag);
+		}
+		return data[index];
+	}
+	size_t size() const
+	{
+		return packed() ? cells.size() : data.size();
+	}
+	void clear();
 	void push_back(dyn_object &&value);
 	void push_back(const dyn_object &value);
 	iterator insert(iterator position, dyn_object &&value);
@@ -156,21 +269,133 @@ public:
 		++revision;
 	}
 
+	// Index-based access which keeps the list packed if possible
+	void insert_at(size_t index, dyn_object &&value);
+	void set_at(size_t index, dyn_object &&value);
+	void erase_at(size_t first, size_t last);
+	// Overwrites or appends single cells, starting at an index not past the end
+	void set_range(size_t index, const cell *values, size_t count, tag_ptr tag);
+
 	void resize(size_t count);
 	void resize(size_t count, const dyn_object &value);
 
-	void reserve(size_t count)
+	void reserve(size_t count);
+	size_t capacity() const
+	{
+		return packed() ? cells.capacity() : data.capacity();
+	}
+
+	bool packed() const
+	{
+		return cell_tag != nullptr;
+	}
+	tag_ptr get_cell_tag() const
+	{
+		return cell_tag;
+	}
+	std::vector<cell> &get_cells()
+	{
+		invalidate_index();
+		return cells;
+	}
+	const std::vector<cell> &get_cells() const
+	{
+		return cells;
+	}
+	bool pack();
+	void unpack();
+
+	void set_indexed(bool indexed);
+	bool is_indexed() const
+	{
+		return indexed;
+	}
+	// Ascending positions of elements equal to the value, or null if the list is not indexed
+	const std::vector<size_t> *find_index(const dyn_object &value);
+
+	template <class Func>
+	void for_each_object(Func func) const
 	{
-		if(count > data.capacity())
+		if(packed())
 		{
-			++revision;
+			for(cell value : cells)
+			{
+				func(dyn_object(value, cell_tag));
+			}
+		}else{
+			collection_base::for_each_object(func);
 		}
-		data.reserve(count);
 	}
 
-	size_t capacity() const
+	size_t memory_size() const;
+
+	void swap(list_t &other)
 	{
-		return data.capacity();
+		collection_base::swap(other);
+		std::swap(cells, other.cells);
+		std::swap(cell_tag, other.cell_tag);
+		std::swap(index, other.index);
+		std::swap(indexed, other.indexed);
+		std::swap(index_plain, other.index_plain);
+		std::swap(index_revision, other.index_revision);
+	}
+
+	std::vector<dyn_object> &get_data()
+	{
+		unpack();
+		invalidate_index();
+		return collection_base::get_data();
+	}
+
+	// only for lists that are not packed
+	const std::vector<dyn_object> &get_data() const
+	{
+		return collection_base::get_data();
+	}
+};
+
+// Key of a single untagged cell, looked up without creating a dyn_object
+struct cell_key
+{
+	cell value;
+
+	size_t hash() const
+	{
+		return dyn_object::cell_hash(value);
+	}
+
+	bool matches(const dyn_object &key) const
+	{
+		return key.equals_cell(value);
+	}
+
+	dyn_object key() const
+	{
+		return dyn_object(value, tags::find_tag(tags::tag_cell));
+	}
+};
+
+// Key of an AMX string, looked up without copying the string into a dyn_object
+struct str_key
+{
+	const cell *str;
+	cell size;
+
+	str_key(const cell *str);
+
+	size_t hash() const
+	{
+		return dyn_object::str_hash(str, size);
+	}
+
+	bool matches(const dyn_object &key) const
+	{
+		return key.equals_str(str, size);
+	}
+
+	dyn_object key() const
+	{
+		return dyn_object(str);
 	}
 };
 
@@ -187,6 +412,11 @@ public:
 
 	}
 
+	map_t(aux::hybrid_map_mode mode) : collection_base<aux::hybrid_map<dyn_object, dyn_object>>(mode)
+	{
+
+	}
+
 	dyn_object &operator[](const dyn_object &key);
 	dyn_object &operator[](dyn_object &&key);
 	std::pair<iterator, bool> insert(const dyn_object &key, const dyn_object &value);
@@ -194,6 +424,18 @@ public:
 	std::pair<iterator, bool> insert(dyn_object &&key, const dyn_object &value);
 	std::pair<iterator, bool> insert(dyn_object &&key, dyn_object &&value);
 	iterator find(const dyn_object &key);
+	const_iterator find(const dyn_object &key) const;
+
+	template <class Probe>
+	iterator find_as(const Probe &key)
+	{
+		return data.find_as(key);
+	}
+	template <class Probe>
+	const_iterator find_as(const Probe &key) const
+	{
+		return data.find_as(key);
+	}
 	size_t erase(const dyn_object &key);
 	iterator erase(iterator position);
 	bool insert_dyn(iterator position, const std::type_info &type, void *value, iterator &result);
@@ -206,6 +448,21 @@ public:
 		++revision;
 	}
 
+	iterator nth(size_t index)
+	{
+		return data.nth(index);
+	}
+
+	size_t index_of(iterator position)
+	{
+		return data.index_of(position);
+	}
+
+	size_t rank(const dyn_object &key) const
+	{
+		return data.rank(key);
+	}
+
 	void set_ordered(bool ordered)
 	{
 		if(data.set_ordered(ordered))
@@ -219,6 +476,19 @@ public:
 		return data.is_ordered();
 	}
 
+	void set_mode(aux::hybrid_map_mode mode)
+	{
+		if(data.set_mode(mode))
+		{
+			++revision;
+		}
+	}
+
+	aux::hybrid_map_mode mode() const
+	{
+		return data.get_mode();
+	}
+
 	void reserve(size_t count)
 	{
 		data.reserve(count);
@@ -229,11 +499,33 @@ public:
 	{
 		return data.capacity();
 	}
+
+	// mutable access to persistent storage unshares the nodes, so objects are visited through const iterators
+	template <class Func>
+	void for_each_object(Func func) const
+	{
+		for(auto it = data.cbegin(); it != data.cend(); ++it)
+		{
+			impl::visit_objects(*it, func);
+		}
+	}
+
+	size_t memory_size() const
+	{
+		size_t bytes = data.size() * sizeof(value_type);
+		for_each_object([&](const dyn_object &obj)
+		{
+			bytes += obj.heap_size();
+		});
+		return bytes;
+	}
 };
 
-class linked_list_t : public collection_base<std::list<std::shared_ptr<dyn_object>>>
+class linked_list_t : public collection_base<aux::node_list<dyn_object>>
 {
 public:
+	typedef aux::node_list<dyn_object>::pin pin;
+
 	dyn_object &operator[](size_t index);
 	void push_back(dyn_object &&value);
 	void push_back(const dyn_object &value);
@@ -333,6 +625,285 @@ public:
 	}
 };
 
+struct heap_entry
+{
+	// the priority, unless the heap stores it in key_cell
+	dyn_object key;
+	dyn_object value;
+	cell key_cell;
+	// the slot of the handle, without its generation
+	size_t handle;
+};
+
+// Binary heap of values ordered by priority, with stable handles to its entries
+class heap_t : public collection_base<std::vector<heap_entry>>
+{
+	// the position of the entry under each handle
+	aux::slot_table<size_t> slots;
+	// single cell priorities with a common cell or Float tag are compared without dyn_object
+	tag_ptr key_tag = nullptr;
+	bool max = false;
+
+	bool before(const heap_entry &a, const heap_entry &b) const
+	{
+		if(key_tag)
+		{
+			if(key_tag->uid == tags::tag_float)
+			{
+				float x = amx_ctof(a.key_cell), y = amx_ctof(b.key_cell);
+				return max ? y < x : x < y;
+			}
+			return max ? b.key_cell < a.key_cell : a.key_cell < b.key_cell;
+		}
+		return max ? b.key < a.key : a.key < b.key;
+	}
+
+	bool pack_key(const dyn_object &key);
+	void unpack();
+	void set_key(heap_entry &entry, dyn_object &&key);
+	void sift_up(size_t index);
+	void sift_down(size_t index);
+	void restore(size_t index);
+
+public:
+	static constexpr size_t npos = -1;
+
+	heap_t()
+	{
+
+	}
+
+	heap_t(bool max) : max(max)
+	{
+
+	}
+
+	bool is_max() const
+	{
+		return max;
+	}
+
+	tag_ptr get_key_tag() const
+	{
+		return key_tag;
+	}
+
+	// Adds a value and returns the handle of its entry
+	size_t push(dyn_object &&key, dyn_object &&value);
+
+	const heap_entry &top() const
+	{
+		return data.front();
+	}
+
+	dyn_object key_of(const heap_entry &entry) const
+	{
+		if(key_tag)
+		{
+			return dyn_object(entry.key_cell, key_tag);
+		}
+		return entry.key;
+	}
+
+	size_t index_of(const heap_entry &entry) const
+	{
+		return &entry - data.data();
+	}
+
+	// Removes the entry at a position, freeing its handle
+	heap_entry extract(size_t index);
+
+	heap_entry pop()
+	{
+		return extract(0);
+	}
+
+	size_t handle_of(const heap_entry &entry) const
+	{
+		return static_cast<ucell>(slots.handle_of(entry.handle));
+	}
+
+	heap_entry *find(size_t handle)
+	{
+		size_t *position = slots.find(static_cast<cell>(handle));
+		return position ? &data[*position] : nullptr;
+	}
+
+	const heap_entry *find(size_t handle) const
+	{
+		return const_cast<heap_t*>(this)->find(handle);
+	}
+
+	// Changes the priority of an entry, moving it up or down
+	bool update(size_t handle, dyn_object &&key);
+	bool remove(size_t handle);
+	// Removes the entry at a position, returning false if another entry was moved before it
+	bool erase_at(size_t index);
+	iterator erase(iterator position);
+	void clear();
+
+	bool insert_dyn(iterator position, const std::type_info &type, void *value, iterator &result)
+	{
+		return false;
+	}
+
+	bool insert_dyn(iterator position, const std::type_info &type, const void *value, iterator &result)
+	{
+		return false;
+	}
+
+	template <class Func>
+	void for_each_object(Func func) const
+	{
+		for(const auto &entry : data)
+		{
+			if(key_tag)
+			{
+				func(dyn_object(entry.key_cell, key_tag));
+			}else{
+				func(entry.key);
+			}
+			func(entry.value);
+		}
+	}
+
+	size_t memory_size() const;
+
+	void swap(heap_t &other)
+	{
+		collection_base::swap(other);
+		std::swap(slots, other.slots);
+		std::swap(key_tag, other.key_tag);
+		std::swap(max, other.max);
+	}
+};
+
+typedef aux::spatial_grid<dyn_object>::entry spatial_entry;
+
+// Spatial collection of dynamic objects
+class spatial_t : public aux::spatial_grid<dyn_object>
+{
+public:
+	explicit spatial_t(float cell_size) : spatial_grid(cell_size)
+	{
+
+	}
+
+	size_t memory_size() const;
+
+	void swap(spatial_t &other)
+	{
+		spatial_grid::swap(other);
+	}
+};
+
+// Immutable copy of a list which may be read from any thread
+class frozen_list_t
+{
+	std::vector<dyn_object> data;
+	std::vector<cell> cells;
+	tag_ptr cell_tag = nullptr;
+
+public:
+	explicit frozen_list_t(const list_t &list);
+
+	size_t size() const
+	{
+		return packed() ? cells.size() : data.size();
+	}
+
+	bool packed() const
+	{
+		return cell_tag != nullptr;
+	}
+
+	// The element at the index, created on demand for packed lists
+	template <class Func>
+	auto visit(size_t index, Func func) const -> decltype(func(std::declval<const dyn_object&>()))
+	{
+		if(packed())
+		{
+			return func(dyn_object(cells[index], cell_tag));
+		}
+		return func(data[index]);
+	}
+
+	template <class Func>
+	void for_each_object(Func func) const
+	{
+		if(packed())
+		{
+			for(cell value : cells)
+			{
+				func(dyn_object(value, cell_tag));
+			}
+		}else{
+			for(const auto &obj : data)
+			{
+				func(obj);
+			}
+		}
+	}
+
+	size_t memory_size() const;
+};
+
+// Immutable copy of a map which may be read from any thread, with the pairs
+// stored in one array ordered by the hashes of their keys
+class frozen_map_t
+{
+public:
+	typedef std::pair<const dyn_object, dyn_object> value_type;
+
+private:
+	std::vector<value_type> data;
+	std::vector<size_t> hashes;
+
+public:
+	explicit frozen_map_t(const map_t &map);
+
+	// Keys are limited to cells and arrays with plain tags, which are hashed and compared
+	// by their cells instead of tag operations, so lookups do not touch any shared state
+	static bool key_supported(const dyn_object &key);
+	// Trailing zeros are not hashed, so a string can be hashed without its terminator
+	static size_t key_hash(cell tag_uid, cell rank, const cell *begin, const cell *end);
+
+	size_t size() const
+	{
+		return data.size();
+	}
+
+	const value_type *find(const dyn_object &key) const;
+
+	// Finds a key by a probe with hash() and matches(key), hashed by key_hash
+	template <class Probe>
+	const value_type *find_as(const Probe &probe) const
+	{
+		size_t hash = probe.hash();
+		for(auto it = std::lower_bound(hashes.begin(), hashes.end(), hash); it != hashes.end() && *it == hash; ++it)
+		{
+			const value_type &pair = data[it - hashes.begin()];
+			if(probe.matches(pair.first))
+			{
+				return &pair;
+			}
+		}
+		return nullptr;
+	}
+
+	template <class Func>
+	void for_each_object(Func func) const
+	{
+		for(const auto &pair : data)
+		{
+			func(pair.first);
+			func(pair.second);
+		}
+	}
+
+	size_t memory_size() const;
+};
+
 namespace std
 {
 	template <>
@@ -358,6 +929,18 @@ namespace std
 	{
 		a.swap(b);
 	}
+
+	template <>
+	inline void swap<heap_t>(heap_t &a, heap_t &b) noexcept
+	{
+		a.swap(b);
+	}
+
+	template <>
+	inline void swap<spatial_t>(spatial_t &a, spatial_t &b) noexcept
+	{
+		a.swap(b);
+	}
 }
 
 class dyn_iterator
@@ -822,6 +1405,8 @@ public:
 	{
 		return std::make_shared<map_iterator_t>(*this);
 	}
+
+	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
 };
 
 class linked_list_iterator_t : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
@@ -831,7 +1416,7 @@ protected:
 	typedef typename linked_list_t::value_type value_type;
 	std::weak_ptr<linked_list_t> _source;
 	iterator _position;
-	std::weak_ptr<dyn_object> _current;
+	linked_list_t::pin _current;
 	bool _before;
 
 	virtual std::shared_ptr<linked_list_t> lock_same();
@@ -848,7 +1433,7 @@ public:
 
 	}
 
-	linked_list_iterator_t(const std::shared_ptr<linked_list_t> source, iterator position) : _source(source), _position(position), _current(position != source->end() ? *position : nullptr), _before(false)
+	linked_list_iterator_t(const std::shared_ptr<linked_list_t> source, iterator position) : _source(source), _position(position), _current(position != source->end() ? linked_list_t::pin(position) : linked_list_t::pin()), _before(false)
 	{
 
 	}
@@ -963,6 +1548,104 @@ public:
 	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
 };
 
+// Iterates the entries of a heap in storage order, with priorities as keys
+class heap_iterator_t : public iterator_impl<heap_t>
+{
+public:
+	heap_iterator_t(const std::shared_ptr<heap_t> source) : iterator_impl(source)
+	{
+
+	}
+
+	heap_iterator_t(const std::shared_ptr<heap_t> source, iterator position) : iterator_impl(source, position)
+	{
+
+	}
+
+	heap_iterator_t(const heap_iterator_t &iter) : iterator_impl(iter)
+	{
+
+	}
+
+	virtual bool move_previous() override
+	{
+		if(auto source = lock_same())
+		{
+			if(_position == source->end())
+			{
+				return false;
+			}else if(_position == source->begin())
+			{
+				_position = source->end();
+				_state = state::outside;
+				return false;
+			}else{
+				--_position;
+				_state = state::at_element;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	virtual bool set_to_last() override
+	{
+		if(auto source = _source.lock())
+		{
+			_revision = source->get_revision();
+			_position = source->end();
+			if(_position != source->begin())
+			{
+				--_position;
+				_state = state::at_element;
+				return true;
+			}else{
+				_state = state::outside;
+			}
+		}
+		return false;
+	}
+
+	virtual std::unique_ptr<dyn_iterator> clone() const override
+	{
+		return std::make_unique<heap_iterator_t>(*this);
+	}
+
+	virtual std::shared_ptr<dyn_iterator> clone_shared() const override
+	{
+		return std::make_shared<heap_iterator_t>(*this);
+	}
+
+	virtual bool erase(bool stay) override
+	{
+		if(auto source = lock_same())
+		{
+			if(_state == state::at_element)
+			{
+				size_t index = _position - source->begin();
+				if(!source->erase_at(index))
+				{
+					// an unvisited entry was moved before the position, so the iterator becomes invalid
+					return true;
+				}
+				_position = source->begin() + index;
+				_revision = source->get_revision();
+				if(_position == source->end())
+				{
+					_state = state::outside;
+				}else if(stay)
+				{
+					_state = state::before_element;
+				}
+			}
+			return true;
+		}
+		return false;
+	}
+
+	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
+};
+
 class handle_t
 {
 	dyn_object object;
@@ -1061,6 +1744,10 @@ extern aux::shared_id_set_pool<list_t> list_pool;
 extern aux::shared_id_set_pool<map_t> map_pool;
 extern aux::shared_id_set_pool<linked_list_t> linked_list_pool;
 extern aux::shared_id_set_pool<pool_t> pool_pool;
+extern aux::shared_id_set_pool<heap_t> heap_pool;
+extern aux::shared_id_set_pool<spatial_t> spatial_pool;
+extern aux::sync_id_set_pool<frozen_list_t> frozen_list_pool;
+extern aux::sync_id_set_pool<frozen_map_t> frozen_map_pool;
 extern object_pool<dyn_iterator> iter_pool;
 extern object_pool<handle_t> handle_pool;
 
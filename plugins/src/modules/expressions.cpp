@@ -9,7 +9,7 @@
 #include <stdarg.h>
 #include <cstring>
 
-object_pool<expression> expression_pool;
+object_pool<expression> expression_pool(true);
 
 void amx_ExpressionError(const char *format, ...)
 {
@@ -192,8 +192,9 @@ std::tuple<cell*, size_t, tag_ptr> expression::address(const args_type &args, co
 		}
 		cell_indices.push_back(index.get_cell(0));
 	}
-	auto value = execute(args, info);
-	cell *arr, size;
+	const auto value = execute(args, info);
+	const cell *arr;
+	cell size;
 	arr = value.get_array(cell_indices.data(), cell_indices.size(), size);
 	cell amx_addr, *addr;
 	amx_AllotSafe(info.amx, size ? size : 1, &amx_addr, &addr);
@@ -3727,7 +3728,7 @@ dyn_object extract_expression::assign(const args_type &args, const exec_info &in
 			obj.clear();
 			obj.push_back(value.get_cell(0));
 		}else{
-			obj = strings::convert(value.begin());
+			obj = strings::convert(static_cast<const dyn_object&>(value).begin());
 		}
 		return value;
 	}else if(var_value.tag_assignable(tags::find_tag(tags::tag_string)->base))
@@ -3890,7 +3891,7 @@ decltype(expression_pool)::object_ptr variant_expression::clone() const
 
 cell string_expression::execute_inner(const args_type &args, const exec_info &info) const
 {
-	auto value = this->value->execute(args, info);
+	const auto value = this->value->execute(args, info);
 	if(!value.tag_assignable(tags::find_tag(tags::tag_char)))
 	{
 		amx_ExpressionError("string argument tag mismatch (%s: required, %s: provided)", tags::find_tag(tags::tag_char)->format_name(), value.get_tag()->format_name());
@@ -636,7 +636,7 @@ void replace(cell_string &target, StringIter &begin, StringIter end, const std::
 			const auto &capture = *it;
 			if(capture.matched && index <= replacement.size())
 			{
-				const dyn_object &repl = replacement[index - 1];
+				dyn_object repl = replacement.value_at(index - 1);
 
 				auto begin = it;
 				++it;
@@ -33,8 +33,9 @@ bool serialize_value(cell value, tag_ptr tag, void(*binary_writer)(void*, const
 			binary_writer(binary_writer_cookie, &static_cast<const char&>(1), sizeof(char));
 			binary_writer(binary_writer_cookie, reinterpret_cast<const char*>(&static_cast<const cell&>(ptr->size())), sizeof(cell));
 			binary_writer(binary_writer_cookie, reinterpret_cast<const char*>(&static_cast<const cell&>(ptr->ordered())), sizeof(cell));
-			for(const auto &elem : *ptr)
+			for(auto it = ptr->cbegin(); it != ptr->cend(); ++it)
 			{
+				const auto &elem = *it;
 				object_writer(object_writer_cookie, &elem.first);
 				object_writer(object_writer_cookie, &elem.second);
 			}
@@ -10,7 +10,7 @@
 
 using namespace strings;
 
-object_pool<cell_string> strings::pool;
+object_pool<cell_string> strings::pool(true);
 
 cell strings::null_value1[1] = {0};
 cell strings::null_value2[2] = {0, 1};
@@ -101,6 +101,70 @@ cell strings::create(const std::string &str)
 	return pool.get_id(pool.emplace(convert(str)));
 }
 
+struct cell_string_hash
+{
+	size_t operator()(const cell_string &str) const
+	{
+		size_t hash = 2166136261u;
+		for(cell c : str)
+		{
+			hash = (hash ^ static_cast<ucell>(c)) * 16777619u;
+		}
+		return hash;
+	}
+};
+
+// Maps the contents of interned strings to their global instances
+static std::unordered_map<cell_string, cell, cell_string_hash> &interned_strings()
+{
+	static std::unordered_map<cell_string, cell, cell_string_hash> table;
+	return table;
+}
+
+cell strings::intern(const cell_string &str)
+{
+	auto &table = interned_strings();
+	auto it = table.find(str);
+	if(it != table.end())
+	{
+		// the string might have been modified since, in which case the table gives up its reference
+		decltype(pool)::ref_container *ptr;
+		if(pool.get_by_id(it->second, ptr) && !ptr->local())
+		{
+			if(**ptr == str)
+			{
+				return it->second;
+			}
+			pool.release_ref(*ptr);
+		}
+		table.erase(it);
+	}
+	auto &ptr = pool.emplace(str);
+	pool.acquire_ref(ptr);
+	cell id = pool.get_id(ptr);
+	table.emplace(str, id);
+	return id;
+}
+
+bool strings::unintern(cell id)
+{
+	decltype(pool)::ref_container *ptr;
+	if(!pool.get_by_id(id, ptr) || !is_interned(id, **ptr))
+	{
+		return false;
+	}
+	interned_strings().erase(**ptr);
+	pool.release_ref(*ptr);
+	return true;
+}
+
+bool strings::is_interned(cell id, const cell_string &str)
+{
+	auto &table = interned_strings();
+	auto it = table.find(str);
+	return it != table.end() && it->second == id;
+}
+
 bool strings::clamp_range(const cell_string &str, cell &start, cell &end)
 {
 	clamp_pos(str, start);
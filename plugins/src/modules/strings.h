@@ -293,6 +293,9 @@ namespace strings
 	cell create(const cell *addr, bool truncate, bool fixnulls);
 	cell create(const cell *addr, size_t length, bool packed, bool truncate, bool fixnulls);
 	cell create(const std::string &str);
+	cell intern(const cell_string &str);
+	bool unintern(cell id);
+	bool is_interned(cell id, const cell_string &str);
 
 	cell_string convert(const cell *str);
 	cell_string convert(const cell *str, size_t length, bool packed);
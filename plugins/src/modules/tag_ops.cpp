@@ -853,13 +853,16 @@ struct string_operations : public null_operations<string_operations>
 
 	virtual bool del(tag_ptr tag, cell arg) const override
 	{
-		return strings::pool.remove_by_id(arg);
+		decltype(strings::pool)::ref_container *str;
+		if(!strings::pool.get_by_id(arg, str) || strings::is_interned(arg, **str)) return false;
+		return strings::pool.remove(*str);
 	}
 
 	virtual bool release(tag_ptr tag, cell arg) const override
 	{
 		decltype(strings::pool)::ref_container *str;
 		if(!strings::pool.get_by_id(arg, str)) return false;
+		if(str->last_ref() && strings::is_interned(arg, **str)) return false;
 		if(!strings::pool.release_ref(*str)) return false;
 		return true;
 	}
@@ -1410,7 +1413,7 @@ struct linked_list_operations : public generic_operations<linked_list_operations
 			linked_list_pool.remove(l);
 			for(auto &obj : old)
 			{
-				obj->release();
+				obj.release();
 			}
 			return true;
 		}
@@ -1439,7 +1442,7 @@ struct linked_list_operations : public generic_operations<linked_list_operations
 			linked_list_t *l2 = linked_list_pool.add().get();
 			for(auto &obj : tmp)
 			{
-				l2->push_back(obj->clone());
+				l2->push_back(obj.clone());
 			}
 			std::swap(*l, tmp);
 			return linked_list_pool.get_id(l2);
@@ -1501,7 +1504,7 @@ struct map_operations : public generic_operations<map_operations, tags::tag_map>
 		map_t *m;
 		if(map_pool.get_by_id(arg, m))
 		{
-			map_t old(m->ordered());
+			map_t old(m->mode());
 			std::swap(*m, old);
 			map_pool.remove(m);
 			for(auto &pair : old)
@@ -1534,10 +1537,10 @@ struct map_operations : public generic_operations<map_operations, tags::tag_map>
 			map_t tmp;
 			std::swap(*m, tmp);
 			map_t *m2 = map_pool.add().get();
-			m2->set_ordered(m->ordered());
-			for(auto &pair : tmp)
+			m2->set_mode(m->mode());
+			for(auto it = tmp.cbegin(); it != tmp.cend(); ++it)
 			{
-				m2->insert(pair.first.clone(), pair.second.clone());
+				m2->insert(it->first.clone(), it->second.clone());
 			}
 			std::swap(*m, tmp);
 			return map_pool.get_id(m2);
@@ -1955,6 +1958,287 @@ struct pool_operations : public generic_operations<pool_operations, tags::tag_po
 	}
 };
 
+struct heap_operations : public generic_operations<heap_operations, tags::tag_heap>
+{
+	heap_operations() : generic_operations<heap_operations, tags::tag_heap>()
+	{
+
+	}
+
+	heap_operations(tag_ptr element) : generic_operations(element)
+	{
+
+	}
+
+	virtual bool eq(tag_ptr tag, cell a, cell b) const override
+	{
+		return a == b;
+	}
+
+	virtual bool not(tag_ptr tag, cell a) const override
+	{
+		heap_t *h;
+		return !heap_pool.get_by_id(a, h);
+	}
+
+	virtual bool del(tag_ptr tag, cell arg) const override
+	{
+		heap_t *h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			return heap_pool.remove(h);
+		}
+		return false;
+	}
+
+	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<heap_t> h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			return h;
+		}
+		return {};
+	}
+
+	virtual bool release(tag_ptr tag, cell arg) const override
+	{
+		heap_t *h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			heap_t old;
+			std::swap(*h, old);
+			heap_pool.remove(h);
+			old.for_each_object([](const dyn_object &obj)
+			{
+				obj.release();
+			});
+			return true;
+		}
+		return false;
+	}
+
+	virtual cell copy(tag_ptr tag, cell arg) const override
+	{
+		heap_t *h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			heap_t *h2 = heap_pool.add().get();
+			*h2 = *h;
+			return heap_pool.get_id(h2);
+		}
+		return 0;
+	}
+
+	virtual cell clone(tag_ptr tag, cell arg) const override
+	{
+		heap_t *h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			heap_t tmp;
+			std::swap(*h, tmp);
+			heap_t *h2 = heap_pool.add().get();
+			*h2 = tmp;
+			for(auto &entry : *h2)
+			{
+				entry.key = entry.key.clone();
+				entry.value = entry.value.clone();
+			}
+			std::swap(*h, tmp);
+			return heap_pool.get_id(h2);
+		}
+		return 0;
+	}
+};
+
+struct spatial_operations : public generic_operations<spatial_operations, tags::tag_spatial>
+{
+	spatial_operations() : generic_operations<spatial_operations, tags::tag_spatial>()
+	{
+
+	}
+
+	spatial_operations(tag_ptr element) : generic_operations(element)
+	{
+
+	}
+
+	virtual bool eq(tag_ptr tag, cell a, cell b) const override
+	{
+		return a == b;
+	}
+
+	virtual bool not(tag_ptr tag, cell a) const override
+	{
+		spatial_t *s;
+		return !spatial_pool.get_by_id(a, s);
+	}
+
+	virtual bool del(tag_ptr tag, cell arg) const override
+	{
+		spatial_t *s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			return spatial_pool.remove(s);
+		}
+		return false;
+	}
+
+	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<spatial_t> s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			return s;
+		}
+		return {};
+	}
+
+	virtual bool release(tag_ptr tag, cell arg) const override
+	{
+		spatial_t *s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			spatial_t old(s->get_cell_size());
+			std::swap(*s, old);
+			spatial_pool.remove(s);
+			old.for_each_object([](const dyn_object &obj)
+			{
+				obj.release();
+			});
+			return true;
+		}
+		return false;
+	}
+
+	virtual cell copy(tag_ptr tag, cell arg) const override
+	{
+		spatial_t *s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			return spatial_pool.get_id(spatial_pool.emplace(*s));
+		}
+		return 0;
+	}
+
+	virtual cell clone(tag_ptr tag, cell arg) const override
+	{
+		spatial_t *s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			spatial_t tmp(s->get_cell_size());
+			std::swap(*s, tmp);
+			auto s2 = spatial_pool.emplace(tmp);
+			s2->for_each_value([](dyn_object &obj)
+			{
+				obj = obj.clone();
+			});
+			std::swap(*s, tmp);
+			return spatial_pool.get_id(s2);
+		}
+		return 0;
+	}
+};
+
+struct frozen_list_operations : public generic_operations<frozen_list_operations, tags::tag_frozen_list>
+{
+	frozen_list_operations() : generic_operations<frozen_list_operations, tags::tag_frozen_list>()
+	{
+
+	}
+
+	frozen_list_operations(tag_ptr element) : generic_operations(element)
+	{
+
+	}
+
+	virtual bool eq(tag_ptr tag, cell a, cell b) const override
+	{
+		return a == b;
+	}
+
+	virtual bool not(tag_ptr tag, cell a) const override
+	{
+		std::shared_ptr<frozen_list_t> l;
+		return !frozen_list_pool.get_by_id(a, l);
+	}
+
+	virtual bool del(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<frozen_list_t> l;
+		if(frozen_list_pool.get_by_id(arg, l))
+		{
+			return frozen_list_pool.remove(l.get());
+		}
+		return false;
+	}
+
+	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<frozen_list_t> l;
+		if(frozen_list_pool.get_by_id(arg, l))
+		{
+			return l;
+		}
+		return {};
+	}
+
+	virtual cell copy(tag_ptr tag, cell arg) const override
+	{
+		// immutable, so the handle itself is a copy
+		return arg;
+	}
+};
+
+struct frozen_map_operations : public generic_operations<frozen_map_operations, tags::tag_frozen_map>
+{
+	frozen_map_operations() : generic_operations<frozen_map_operations, tags::tag_frozen_map>()
+	{
+
+	}
+
+	frozen_map_operations(tag_ptr element) : generic_operations(element)
+	{
+
+	}
+
+	virtual bool eq(tag_ptr tag, cell a, cell b) const override
+	{
+		return a == b;
+	}
+
+	virtual bool not(tag_ptr tag, cell a) const override
+	{
+		std::shared_ptr<frozen_map_t> m;
+		return !frozen_map_pool.get_by_id(a, m);
+	}
+
+	virtual bool del(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<frozen_map_t> m;
+		if(frozen_map_pool.get_by_id(arg, m))
+		{
+			return frozen_map_pool.remove(m.get());
+		}
+		return false;
+	}
+
+	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<frozen_map_t> m;
+		if(frozen_map_pool.get_by_id(arg, m))
+		{
+			return m;
+		}
+		return {};
+	}
+
+	virtual cell copy(tag_ptr tag, cell arg) const override
+	{
+		return arg;
+	}
+};
+
 struct expression_operations : public null_operations<expression_operations>
 {
 	expression_operations() : null_operations<expression_operations>(tags::tag_expression)
@@ -2021,6 +2305,8 @@ struct expression_operations : public null_operations<expression_operations>
 
 static const null_operations<signed_operations> unknown_ops(tags::tag_unknown);
 
+tag_ptr builtin_tags[tags::builtin_count];
+
 std::vector<std::unique_ptr<tag_info>> tag_list([]()
 {
 	std::vector<std::unique_ptr<tag_info>> v;
@@ -2056,6 +2342,14 @@ std::vector<std::unique_ptr<tag_info>> tag_list([]()
 	v.push_back(std::move(string_const));
 	v.push_back(std::move(variant_const));
 	v.push_back(std::make_unique<tag_info>(27, "char@", v[3].get(), std::make_unique<char_operations>()));
+	v.push_back(std::make_unique<tag_info>(28, "FrozenList", unknown_tag, std::make_unique<frozen_list_operations>()));
+	v.push_back(std::make_unique<tag_info>(29, "FrozenMap", unknown_tag, std::make_unique<frozen_map_operations>()));
+	v.push_back(std::make_unique<tag_info>(30, "Heap", unknown_tag, std::make_unique<heap_operations>()));
+	v.push_back(std::make_unique<tag_info>(31, "Spatial", unknown_tag, std::make_unique<spatial_operations>()));
+	for(size_t i = 0; i < v.size() && i < tags::builtin_count; i++)
+	{
+		builtin_tags[i] = v[i].get();
+	}
 	return v;
 }());
 
@@ -8,6 +8,8 @@
 #include <memory>
 
 extern std::vector<std::unique_ptr<tag_info>> tag_list;
+// built-in tags are found without tag_list, which may be reallocated while a detached thread reads it
+extern tag_ptr builtin_tags[tags::builtin_count];
 
 struct tag_map_info : public amx::extra
 {
@@ -104,6 +106,10 @@ tag_ptr tags::find_tag(AMX *amx, cell tag_id)
 
 tag_ptr tags::find_tag(cell tag_uid)
 {
+	if(tag_uid >= 0 && tag_uid < builtin_count && builtin_tags[tag_uid])
+	{
+		return builtin_tags[tag_uid];
+	}
 	if(tag_uid < 0 || (ucell)tag_uid >= ::tag_list.size()) return ::tag_list[tag_unknown].get();
 	return ::tag_list[tag_uid].get();
 }
@@ -383,6 +383,31 @@ namespace tasks
 		return pool.size();
 	}
 
+	size_t release_owner(AMX *amx)
+	{
+		return pool.release_owner(amx);
+	}
+
+	void forget_owner(AMX *amx)
+	{
+		pool.forget_owner(amx);
+	}
+
+	size_t owned_size(AMX *amx)
+	{
+		return pool.owned_size(amx);
+	}
+
+	const aux::pool_stats &get_stats()
+	{
+		return pool.get_stats();
+	}
+
+	void reset_stats()
+	{
+		pool.reset_stats();
+	}
+
 	void tick()
 	{
 		tick_count++;
@@ -3,6 +3,7 @@
 
 #include "objects/reset.h"
 #include "objects/dyn_object.h"
+#include "utils/pool_stats.h"
 #include "sdk/amx/amx.h"
 #include <list>
 #include <memory>
@@ -229,6 +230,11 @@ namespace tasks
 
 	void tick();
 	size_t size();
+	size_t release_owner(AMX *amx);
+	void forget_owner(AMX *amx);
+	size_t owned_size(AMX *amx);
+	const aux::pool_stats &get_stats();
+	void reset_stats();
 
 	extra &get_extra(AMX *amx, amx::object &owner);
 }
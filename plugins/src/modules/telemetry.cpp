@@ -0,0 +1,226 @@
+#include "telemetry.h"
+#include "main.h"
+#include "modules/strings.h"
+#include "modules/variants.h"
+#include "modules/containers.h"
+#include "modules/expressions.h"
+#include "modules/amxutils.h"
+#include "modules/tasks.h"
+#include "utils/pool_stats.h"
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <ctime>
+#include <cstdio>
+
+namespace telemetry
+{
+	const size_t max_tags = 10;
+
+	struct pool_info
+	{
+		const char *name;
+		const aux::pool_stats *stats;
+		size_t bytes;
+	};
+
+	template <class Type>
+	static size_t shallow_size(const aux::pool_stats &stats)
+	{
+		return stats.live() * sizeof(Type);
+	}
+
+	template <template <class> class Pool, class Type>
+	static size_t collection_size(const Pool<Type> &pool)
+	{
+		size_t bytes = 0;
+		pool.for_each([&](const Type &collection)
+		{
+			bytes += sizeof(Type) + collection.memory_size();
+		});
+		return bytes;
+	}
+
+	static std::vector<pool_info> collect()
+	{
+		std::vector<pool_info> pools;
+
+		size_t bytes = 0;
+		strings::pool.for_each([&](const strings::cell_string &str)
+		{
+			bytes += sizeof(str) + str.capacity() * sizeof(cell);
+		});
+		pools.push_back({"strings", &strings::pool.get_stats(), bytes});
+
+		bytes = 0;
+		variants::pool.for_each([&](const dyn_object &obj)
+		{
+			bytes += sizeof(obj) + obj.heap_size();
+		});
+		pools.push_back({"variants", &variants::pool.get_stats(), bytes});
+
+		pools.push_back({"lists", &list_pool.get_stats(), collection_size(list_pool)});
+		pools.push_back({"linked_lists", &linked_list_pool.get_stats(), collection_size(linked_list_pool)});
+		pools.push_back({"maps", &map_pool.get_stats(), collection_size(map_pool)});
+		pools.push_back({"pools", &pool_pool.get_stats(), collection_size(pool_pool)});
+		pools.push_back({"heaps", &heap_pool.get_stats(), collection_size(heap_pool)});
+		pools.push_back({"spatials", &spatial_pool.get_stats(), collection_size(spatial_pool)});
+		pools.push_back({"frozen_lists", &frozen_list_pool.get_stats(), collection_size(frozen_list_pool)});
+		pools.push_back({"frozen_maps", &frozen_map_pool.get_stats(), collection_size(frozen_map_pool)});
+		pools.push_back({"iterators", &iter_pool.get_stats(), shallow_size<dyn_iterator>(iter_pool.get_stats())});
+		pools.push_back({"handles", &handle_pool.get_stats(), shallow_size<handle_t>(handle_pool.get_stats())});
+		pools.push_back({"expressions", &expression_pool.get_stats(), shallow_size<expression>(expression_pool.get_stats())});
+		pools.push_back({"tasks", &tasks::get_stats(), shallow_size<tasks::task>(tasks::get_stats())});
+		pools.push_back({"amx_vars", &amx_var_pool.get_stats(), shallow_size<amx_var_info>(amx_var_pool.get_stats())});
+		return pools;
+	}
+
+	// The most frequent tags of objects stored in containers
+	static std::vector<std::pair<tag_ptr, size_t>> top_tags()
+	{
+		std::unordered_map<tag_ptr, size_t> counts;
+		auto visit = [&](const dyn_object &obj)
+		{
+			counts[obj.get_tag()]++;
+		};
+		list_pool.for_each([&](const list_t &list) { list.for_each_object(visit); });
+		linked_list_pool.for_each([&](const linked_list_t &list) { list.for_each_object(visit); });
+		map_pool.for_each([&](const map_t &map) { map.for_each_object(visit); });
+		pool_pool.for_each([&](const pool_t &pool) { pool.for_each_object(visit); });
+		heap_pool.for_each([&](const heap_t &heap) { heap.for_each_object(visit); });
+		spatial_pool.for_each([&](const spatial_t &spatial) { spatial.for_each_object(visit); });
+		frozen_list_pool.for_each([&](const frozen_list_t &list) { list.for_each_object(visit); });
+		frozen_map_pool.for_each([&](const frozen_map_t &map) { map.for_each_object(visit); });
+
+		std::vector<std::pair<tag_ptr, size_t>> result(counts.begin(), counts.end());
+		auto by_count = [](const std::pair<tag_ptr, size_t> &a, const std::pair<tag_ptr, size_t> &b)
+		{
+			return a.second > b.second;
+		};
+		if(result.size() > max_tags)
+		{
+			std::partial_sort(result.begin(), result.begin() + max_tags, result.end(), by_count);
+			result.resize(max_tags);
+		}else{
+			std::sort(result.begin(), result.end(), by_count);
+		}
+		return result;
+	}
+
+	static dyn_object make_key(const char *name)
+	{
+		return dyn_object(strings::convert(name).c_str());
+	}
+
+	static dyn_object make_value(size_t value)
+	{
+		return dyn_object(static_cast<cell>(value), tags::find_tag(tags::tag_cell));
+	}
+
+	static dyn_object make_value(double value)
+	{
+		float f = static_cast<float>(value);
+		return dyn_object(amx_ftoc(f), tags::find_tag(tags::tag_float));
+	}
+
+	cell create_map()
+	{
+		auto pools = collect();
+		auto frequent = top_tags();
+
+		auto &result = map_pool.add();
+		for(const auto &info : pools)
+		{
+			auto &entry = map_pool.add();
+			entry->insert(make_key("count"), make_value(info.stats->live()));
+			entry->insert(make_key("peak"), make_value(info.stats->peak()));
+			entry->insert(make_key("allocations"), make_value(info.stats->allocations()));
+			entry->insert(make_key("frees"), make_value(info.stats->frees()));
+			entry->insert(make_key("allocation_rate"), make_value(info.stats->allocation_rate()));
+			entry->insert(make_key("free_rate"), make_value(info.stats->free_rate()));
+			entry->insert(make_key("bytes"), make_value(info.bytes));
+			result->insert(make_key(info.name), dyn_object(map_pool.get_id(entry), tags::find_tag(tags::tag_map)));
+		}
+
+		auto &tag_map = map_pool.add();
+		for(const auto &pair : frequent)
+		{
+			tag_map->insert(make_key(pair.first->format_name()), make_value(pair.second));
+		}
+		result->insert(make_key("tags"), dyn_object(map_pool.get_id(tag_map), tags::find_tag(tags::tag_map)));
+
+		return map_pool.get_id(result);
+	}
+
+	bool dump(const char *file)
+	{
+		auto pools = collect();
+		auto frequent = top_tags();
+
+		std::vector<std::string> lines;
+		char buffer[256];
+		for(const auto &info : pools)
+		{
+			std::snprintf(buffer, sizeof(buffer), "%s: count=%u peak=%u allocations=%u (%.1f/s) frees=%u (%.1f/s) bytes=%u",
+				info.name,
+				static_cast<unsigned int>(info.stats->live()),
+				static_cast<unsigned int>(info.stats->peak()),
+				static_cast<unsigned int>(info.stats->allocations()),
+				info.stats->allocation_rate(),
+				static_cast<unsigned int>(info.stats->frees()),
+				info.stats->free_rate(),
+				static_cast<unsigned int>(info.bytes)
+			);
+			lines.push_back(buffer);
+		}
+		for(const auto &pair : frequent)
+		{
+			std::snprintf(buffer, sizeof(buffer), "tag %s: %u", pair.first->format_name(), static_cast<unsigned int>(pair.second));
+			lines.push_back(buffer);
+		}
+
+		if(file == nullptr || !file[0])
+		{
+			for(const auto &line : lines)
+			{
+				logprintf("[PawnPlus] %s", line.c_str());
+			}
+			return true;
+		}
+
+		std::ofstream stream(file, std::ios::app);
+		if(!stream)
+		{
+			return false;
+		}
+		std::time_t now = std::time(nullptr);
+		std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+		stream << "[" << buffer << "]" << std::endl;
+		for(const auto &line : lines)
+		{
+			stream << line << std::endl;
+		}
+		return static_cast<bool>(stream);
+	}
+
+	void reset()
+	{
+		strings::pool.reset_stats();
+		variants::pool.reset_stats();
+		list_pool.reset_stats();
+		linked_list_pool.reset_stats();
+		map_pool.reset_stats();
+		pool_pool.reset_stats();
+		heap_pool.reset_stats();
+		spatial_pool.reset_stats();
+		frozen_list_pool.reset_stats();
+		frozen_map_pool.reset_stats();
+		iter_pool.reset_stats();
+		handle_pool.reset_stats();
+		expression_pool.reset_stats();
+		tasks::reset_stats();
+		amx_var_pool.reset_stats();
+	}
+}
@@ -0,0 +1,13 @@
+#ifndef TELEMETRY_H_INCLUDED
+#define TELEMETRY_H_INCLUDED
+
+#include "sdk/amx/amx.h"
+
+namespace telemetry
+{
+	cell create_map();
+	bool dump(const char *file);
+	void reset();
+}
+
+#endif
@@ -3,7 +3,7 @@
 #include "strings.h"
 #include "errors.h"
 
-object_pool<dyn_object> variants::pool;
+object_pool<dyn_object> variants::pool(true);
 
 dyn_object dyn_func_str_s(AMX *amx, cell str)
 {
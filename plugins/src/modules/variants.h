@@ -101,6 +101,40 @@ inline cell dyn_func_var(AMX *amx, const dyn_object &obj)
 	return variants::create(obj);
 }
 
+// Row of a two-dimensional AMX array
+inline cell *amx_array_row(cell *addr, cell index)
+{
+	return reinterpret_cast<cell*>(reinterpret_cast<unsigned char*>(addr + index) + addr[index]);
+}
+
+// Copies a cell of consecutive objects into an array, up to the first object which lacks it or has an incompatible tag
+template <class Func>
+cell dyn_get_range(cell *addr, cell size, cell offset, tag_ptr tag, Func element)
+{
+	for(cell i = 0; i < size; i++)
+	{
+		const dyn_object *obj = element(i);
+		if(!obj || !obj->tag_assignable(tag)) return i;
+		const cell *value = obj->get_cell_addr(&offset, 1);
+		if(!value) return i;
+		addr[i] = *value;
+	}
+	return size;
+}
+
+// Copies consecutive objects into the rows of a two-dimensional array, up to the first object with an incompatible tag
+template <class Func>
+cell dyn_get_range_arr(cell *addr, cell size, cell size2, tag_ptr tag, Func element)
+{
+	for(cell i = 0; i < size; i++)
+	{
+		const dyn_object *obj = element(i);
+		if(!obj || !obj->tag_assignable(tag)) return i;
+		obj->get_array(amx_array_row(addr, i), size2);
+	}
+	return size;
+}
+
 template <size_t... Indices>
 class dyn_factory
 {
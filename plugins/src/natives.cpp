@@ -1,7 +1,7 @@
 #include "natives.h"
 #include "amxinfo.h"
 
-tag_ptr native_return_tag;
+thread_local tag_ptr native_return_tag;
 
 cell impl::handle_error(AMX *amx, const cell *params, const char *native, size_t native_size, const errors::native_error &error)
 {
@@ -36,7 +36,7 @@
     } while (0)
 #endif
 
-extern tag_ptr native_return_tag;
+extern thread_local tag_ptr native_return_tag;
 
 namespace impl
 {
@@ -113,6 +113,16 @@ struct native_error_level : public amx::extra
 	}
 };
 
+struct native_unload_cleanup : public amx::extra
+{
+	bool cleanup = false;
+
+	native_unload_cleanup(AMX *amx) : amx::extra(amx)
+	{
+
+	}
+};
+
 #define AMX_DEFINE_NATIVE(Name, ArgCount) \
 	cell AMX_NATIVE_CALL Name(AMX *amx, cell *params); \
 } \
@@ -168,6 +178,9 @@ int RegisterMathNatives(AMX *amx);
 int RegisterDebugNatives(AMX *amx);
 int RegisterPoolNatives(AMX *amx);
 int RegisterExprNatives(AMX *amx);
+int RegisterFrozenNatives(AMX *amx);
+int RegisterHeapNatives(AMX *amx);
+int RegisterSpatialNatives(AMX *amx);
 
 inline int RegisterNatives(AMX *amx)
 {
@@ -188,6 +201,9 @@ inline int RegisterNatives(AMX *amx)
 	RegisterDebugNatives(amx);
 	RegisterPoolNatives(amx);
 	RegisterExprNatives(amx);
+	RegisterFrozenNatives(amx);
+	RegisterHeapNatives(amx);
+	RegisterSpatialNatives(amx);
 	return AMX_ERR_NONE;
 }
 
@@ -0,0 +1,607 @@
+#include "natives.h"
+#include "errors.h"
+#include "modules/containers.h"
+#include "modules/variants.h"
+
+// Frozen collections are immutable and their pools are synchronized, so the natives reading them
+// (frozen_*_valid, _size, _get*, _has*key, _tagof and _sizeof) may be called from detached threads.
+// Tags from the AMX are matched by name and keys by their cells, since tags::find_tag may register
+// new tags and the tag ids of an AMX are cached in shared state. Freezing and deleting must still
+// happen on the main thread. Natives which would create strings or variants are not provided,
+// since those pools are not synchronized.
+
+static bool untagged(cell tag_id)
+{
+	return (tag_id & 0x7FFFFFFF) == 0 || tag_id == tags::tag_cell;
+}
+
+// Same as tags::find_tag(amx, tag_id) being the tag or one of its bases
+static bool frozen_tag_inherits(AMX *amx, tag_ptr tag, cell tag_id)
+{
+	if(untagged(tag_id))
+	{
+		return tag->inherits_from(tags::tag_cell);
+	}
+	if((tag_id & 0x80000000) == 0)
+	{
+		return tag->inherits_from(tag_id);
+	}
+	char *tagname = amx_NameBuffer(amx);
+	if(amx_FindTagId(amx, tag_id & 0x7FFFFFFF, tagname) != AMX_ERR_NONE)
+	{
+		return tag->inherits_from(tags::tag_unknown);
+	}
+	for(; tag != nullptr; tag = tag->base)
+	{
+		if(tag->name == tagname)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Same as obj.tag_assignable(amx, tag_id)
+static bool frozen_tag_assignable(AMX *amx, const dyn_object &obj, cell tag_id)
+{
+	if(untagged(tag_id) && !obj.get_tag()->strong())
+	{
+		return true;
+	}
+	return frozen_tag_inherits(amx, obj.get_tag(), tag_id);
+}
+
+// Same as obj.get_tag(amx), found in the tag table of the AMX
+static cell frozen_tag_id(AMX *amx, const dyn_object &obj)
+{
+	tag_ptr tag = obj.get_tag();
+	if(tag->uid == tags::tag_cell)
+	{
+		return 0x80000000;
+	}
+	char *tagname = amx_NameBuffer(amx);
+	int num;
+	amx_NumTags(amx, &num);
+	for(int i = 0; i < num; i++)
+	{
+		cell tag_id;
+		if(!amx_GetTag(amx, i, tagname, &tag_id) && tag->name == tagname)
+		{
+			return tag_id | 0x80000000;
+		}
+	}
+	return tag->uid;
+}
+
+// The plain tag of a key passed from the AMX, or tag_unknown if there is none
+static cell frozen_key_tag(AMX *amx, cell tag_id)
+{
+	if(untagged(tag_id))
+	{
+		return tags::tag_cell;
+	}
+	if((tag_id & 0x80000000) == 0)
+	{
+		switch(tag_id)
+		{
+			case tags::tag_bool:
+			case tags::tag_char:
+			case tags::tag_float:
+				return tag_id;
+		}
+		return tags::tag_unknown;
+	}
+	char *tagname = amx_NameBuffer(amx);
+	if(amx_FindTagId(amx, tag_id & 0x7FFFFFFF, tagname) == AMX_ERR_NONE)
+	{
+		if(!std::strcmp(tagname, "bool")) return tags::tag_bool;
+		if(!std::strcmp(tagname, "char")) return tags::tag_char;
+		if(!std::strcmp(tagname, "Float")) return tags::tag_float;
+	}
+	return tags::tag_unknown;
+}
+
+// Key of a frozen map given by its cells, ended by an implicit zero for strings
+struct frozen_key_cells
+{
+	cell tag_uid;
+	cell rank;
+	const cell *begin;
+	const cell *end;
+	bool terminated;
+
+	size_t hash() const
+	{
+		return frozen_map_t::key_hash(tag_uid, rank, begin, end);
+	}
+
+	bool matches(const dyn_object &key) const
+	{
+		if(key.get_tag()->uid != tag_uid || key.get_rank() != rank)
+		{
+			return false;
+		}
+		const cell *key_begin = key.begin(), *key_end = key.end();
+		if(key_end - key_begin != end - begin + (terminated ? 1 : 0))
+		{
+			return false;
+		}
+		return std::equal(begin, end, key_begin) && (!terminated || key_begin[end - begin] == 0);
+	}
+};
+
+// Looks up keys in a frozen map without creating the key
+template <class Factory, Factory KeyFactory>
+struct frozen_key;
+
+template <>
+struct frozen_key<dyn_object(&)(AMX*, cell, cell), dyn_func>
+{
+	static const frozen_map_t::value_type *find(const frozen_map_t &map, AMX *amx, cell value, cell tag_id)
+	{
+		cell uid = frozen_key_tag(amx, tag_id);
+		if(uid == tags::tag_unknown)
+		{
+			return nullptr;
+		}
+		return map.find_as(frozen_key_cells{uid, 0, &value, &value + 1, false});
+	}
+};
+
+template <>
+struct frozen_key<dyn_object(&)(AMX*, cell, cell, cell), dyn_func_arr>
+{
+	static const frozen_map_t::value_type *find(const frozen_map_t &map, AMX *amx, cell amx_addr, cell size, cell tag_id)
+	{
+		if(size < 0) amx_LogicError(errors::out_of_range, "size");
+		cell uid = frozen_key_tag(amx, tag_id);
+		if(uid == tags::tag_unknown)
+		{
+			return nullptr;
+		}
+		const cell *addr = amx_GetAddrSafe(amx, amx_addr);
+		return map.find_as(frozen_key_cells{uid, 1, addr, addr + size, false});
+	}
+};
+
+template <>
+struct frozen_key<dyn_object(&)(AMX*, cell), dyn_func_str>
+{
+	static const frozen_map_t::value_type *find(const frozen_map_t &map, AMX *amx, cell amx_addr)
+	{
+		str_key key(amx_GetAddrSafe(amx, amx_addr));
+		return map.find_as(frozen_key_cells{tags::tag_char, 1, key.str, key.str + key.size, true});
+	}
+};
+
+// Same as dyn_func(amx, obj, result, offset, tag_id)
+static cell frozen_func(AMX *amx, const dyn_object &obj, cell result, cell offset, cell tag_id)
+{
+	if(!frozen_tag_assignable(amx, obj, tag_id)) return 0;
+	cell *addr = amx_GetAddrSafe(amx, result);
+	*addr = obj.get_cell(offset);
+	return 1;
+}
+
+// Same as dyn_func_arr(amx, obj, amx_addr, size, tag_id)
+static cell frozen_func_arr(AMX *amx, const dyn_object &obj, cell amx_addr, cell size, cell tag_id)
+{
+	if(!frozen_tag_assignable(amx, obj, tag_id)) return 0;
+	cell *addr = amx_GetAddrSafe(amx, amx_addr);
+	return obj.get_array(addr, size);
+}
+
+// Same as dyn_func_str(amx, obj, amx_addr, size)
+static cell frozen_func_str(AMX *amx, const dyn_object &obj, cell amx_addr, cell size)
+{
+	if(!obj.get_tag()->inherits_from(tags::tag_char)) return 0;
+	cell *addr = amx_GetAddrSafe(amx, amx_addr);
+	return obj.get_array(addr, size);
+}
+
+template <size_t... Indices>
+class value_at
+{
+	using result_ftype = typename dyn_result<Indices...>::type;
+
+public:
+	// native frozen_list_get(FrozenList:list, index, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL frozen_list_get(AMX *amx, cell *params)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		std::shared_ptr<frozen_list_t> ptr;
+		if(!frozen_list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen list", params[1]);
+		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		return ptr->visit(params[2], [&](const dyn_object &obj)
+		{
+			return Factory(amx, obj, params[Indices]...);
+		});
+	}
+};
+
+template <size_t... KeyIndices>
+class key_at
+{
+	using key_ftype = typename dyn_factory<KeyIndices...>::type;
+
+public:
+	template <size_t... ValueIndices>
+	class value_at
+	{
+		using result_ftype = typename dyn_result<ValueIndices...>::type;
+
+	public:
+		// native frozen_map_get(FrozenMap:map, key, ...);
+		template <key_ftype KeyFactory, result_ftype ValueFactory>
+		static cell AMX_NATIVE_CALL frozen_map_get(AMX *amx, cell *params)
+		{
+			std::shared_ptr<frozen_map_t> ptr;
+			if(!frozen_map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen map", params[1]);
+			auto pair = frozen_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
+			if(pair)
+			{
+				return ValueFactory(amx, pair->second, params[ValueIndices]...);
+			}
+			amx_LogicError(errors::element_not_present);
+			return 0;
+		}
+	};
+
+	// native bool:frozen_map_has_key(FrozenMap:map, key, ...);
+	template <key_ftype KeyFactory>
+	static cell AMX_NATIVE_CALL frozen_map_has_key(AMX *amx, cell *params)
+	{
+		std::shared_ptr<frozen_map_t> ptr;
+		if(!frozen_map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen map", params[1]);
+		return frozen_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...) != nullptr;
+	}
+
+	// native frozen_map_tagof(FrozenMap:map, key, ...);
+	template <key_ftype KeyFactory>
+	static cell AMX_NATIVE_CALL frozen_map_tagof(AMX *amx, cell *params)
+	{
+		std::shared_ptr<frozen_map_t> ptr;
+		if(!frozen_map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen map", params[1]);
+		auto pair = frozen_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
+		if(pair)
+		{
+			return frozen_tag_id(amx, pair->second);
+		}
+		amx_LogicError(errors::element_not_present);
+		return 0;
+	}
+
+	// native frozen_map_sizeof(FrozenMap:map, key, ...);
+	template <key_ftype KeyFactory>
+	static cell AMX_NATIVE_CALL frozen_map_sizeof(AMX *amx, cell *params)
+	{
+		std::shared_ptr<frozen_map_t> ptr;
+		if(!frozen_map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen map", params[1]);
+		auto pair = frozen_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
+		if(pair)
+		{
+			return pair->second.get_size();
+		}
+		amx_LogicError(errors::element_not_present);
+		return 0;
+	}
+};
+
+namespace Natives
+{
+	// native FrozenList:list_freeze(List:list);
+	AMX_DEFINE_NATIVE_TAG(list_freeze, 1, frozen_list)
+	{
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		return frozen_list_pool.get_id(frozen_list_pool.emplace(*ptr));
+	}
+
+	// native bool:frozen_list_valid(FrozenList:list);
+	AMX_DEFINE_NATIVE_TAG(frozen_list_valid, 1, bool)
+	{
+		std::shared_ptr<frozen_list_t> ptr;
+		return frozen_list_pool.get_by_id(params[1], ptr);
+	}
+
+	// native frozen_list_delete(FrozenList:list);
+	AMX_DEFINE_NATIVE_TAG(frozen_list_delete, 1, cell)
+	{
+		std::shared_ptr<frozen_list_t> ptr;
+		if(!frozen_list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen list", params[1]);
+		return frozen_list_pool.remove(ptr.get());
+	}
+
+	// native frozen_list_size(FrozenList:list);
+	AMX_DEFINE_NATIVE_TAG(frozen_list_size, 1, cell)
+	{
+		std::shared_ptr<frozen_list_t> ptr;
+		if(!frozen_list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen list", params[1]);
+		return static_cast<cell>(ptr->size());
+	}
+
+	// native frozen_list_get(FrozenList:list, index, offset=0);
+	AMX_DEFINE_NATIVE(frozen_list_get, 3)
+	{
+		return value_at<3>::frozen_list_get<dyn_func>(amx, params);
+	}
+
+	// native frozen_list_get_arr(FrozenList:list, index, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_list_get_arr, 4, cell)
+	{
+		return value_at<3, 4>::frozen_list_get<dyn_func_arr>(amx, params);
+	}
+
+	// native bool:frozen_list_get_safe(FrozenList:list, index, &AnyTag:value, offset=0, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_list_get_safe, 5, bool)
+	{
+		return value_at<3, 4, 5>::frozen_list_get<frozen_func>(amx, params);
+	}
+
+	// native frozen_list_get_arr_safe(FrozenList:list, index, AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_list_get_arr_safe, 5, cell)
+	{
+		return value_at<3, 4, 5>::frozen_list_get<frozen_func_arr>(amx, params);
+	}
+
+	// native frozen_list_get_str_safe(FrozenList:list, index, value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_list_get_str_safe, 4, cell)
+	{
+		return value_at<3, 4>::frozen_list_get<frozen_func_str>(amx, params);
+	}
+
+	// native frozen_list_tagof(FrozenList:list, index);
+	AMX_DEFINE_NATIVE_TAG(frozen_list_tagof, 2, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		std::shared_ptr<frozen_list_t> ptr;
+		if(!frozen_list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen list", params[1]);
+		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		return ptr->visit(params[2], [&](const dyn_object &obj)
+		{
+			return frozen_tag_id(amx, obj);
+		});
+	}
+
+	// native frozen_list_sizeof(FrozenList:list, index);
+	AMX_DEFINE_NATIVE_TAG(frozen_list_sizeof, 2, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		std::shared_ptr<frozen_list_t> ptr;
+		if(!frozen_list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen list", params[1]);
+		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		return ptr->visit(params[2], [&](const dyn_object &obj)
+		{
+			return obj.get_size();
+		});
+	}
+
+	// native FrozenMap:map_freeze(Map:map);
+	AMX_DEFINE_NATIVE_TAG(map_freeze, 1, frozen_map)
+	{
+		map_t *ptr;
+		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+		for(auto it = ptr->cbegin(); it != ptr->cend(); ++it)
+		{
+			if(!frozen_map_t::key_supported(it->first)) amx_LogicError(errors::operation_not_supported, "map");
+		}
+		return frozen_map_pool.get_id(frozen_map_pool.emplace(*ptr));
+	}
+
+	// native bool:frozen_map_valid(FrozenMap:map);
+	AMX_DEFINE_NATIVE_TAG(frozen_map_valid, 1, bool)
+	{
+		std::shared_ptr<frozen_map_t> ptr;
+		return frozen_map_pool.get_by_id(params[1], ptr);
+	}
+
+	// native frozen_map_delete(FrozenMap:map);
+	AMX_DEFINE_NATIVE_TAG(frozen_map_delete, 1, cell)
+	{
+		std::shared_ptr<frozen_map_t> ptr;
+		if(!frozen_map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen map", params[1]);
+		return frozen_map_pool.remove(ptr.get());
+	}
+
+	// native frozen_map_size(FrozenMap:map);
+	AMX_DEFINE_NATIVE_TAG(frozen_map_size, 1, cell)
+	{
+		std::shared_ptr<frozen_map_t> ptr;
+		if(!frozen_map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "frozen map", params[1]);
+		return static_cast<cell>(ptr->size());
+	}
+
+	// native bool:frozen_map_has_key(FrozenMap:map, AnyTag:key, TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_has_key, 3, bool)
+	{
+		return key_at<2, 3>::frozen_map_has_key<dyn_func>(amx, params);
+	}
+
+	// native bool:frozen_map_has_arr_key(FrozenMap:map, const AnyTag:key[], key_size=sizeof(key), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_has_arr_key, 4, bool)
+	{
+		return key_at<2, 3, 4>::frozen_map_has_key<dyn_func_arr>(amx, params);
+	}
+
+	// native bool:frozen_map_has_str_key(FrozenMap:map, const key[]);
+	AMX_DEFINE_NATIVE_TAG(frozen_map_has_str_key, 2, bool)
+	{
+		return key_at<2>::frozen_map_has_key<dyn_func_str>(amx, params);
+	}
+
+	// native frozen_map_get(FrozenMap:map, AnyTag:key, offset=0, TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE(frozen_map_get, 4)
+	{
+		return key_at<2, 4>::value_at<3>::frozen_map_get<dyn_func, dyn_func>(amx, params);
+	}
+
+	// native frozen_map_get_arr(FrozenMap:map, AnyTag:key, AnyTag:value[], value_size=sizeof(value), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_get_arr, 5, cell)
+	{
+		return key_at<2, 5>::value_at<3, 4>::frozen_map_get<dyn_func, dyn_func_arr>(amx, params);
+	}
+
+	// native bool:frozen_map_get_safe(FrozenMap:map, AnyTag:key, &AnyTag:value, offset=0, TagTag:key_tag_id=tagof(key), TagTag:value_tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_get_safe, 6, bool)
+	{
+		return key_at<2, 5>::value_at<3, 4, 6>::frozen_map_get<dyn_func, frozen_func>(amx, params);
+	}
+
+	// native frozen_map_get_arr_safe(FrozenMap:map, AnyTag:key, AnyTag:value[], value_size=sizeof(value), TagTag:key_tag_id=tagof(key), TagTag:value_tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_get_arr_safe, 6, cell)
+	{
+		return key_at<2, 5>::value_at<3, 4, 6>::frozen_map_get<dyn_func, frozen_func_arr>(amx, params);
+	}
+
+	// native frozen_map_get_str_safe(FrozenMap:map, AnyTag:key, value[], value_size=sizeof(value), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_get_str_safe, 5, cell)
+	{
+		return key_at<2, 5>::value_at<3, 4>::frozen_map_get<dyn_func, frozen_func_str>(amx, params);
+	}
+
+	// native frozen_map_arr_get(FrozenMap:map, const AnyTag:key[], offset=0, key_size=sizeof(key), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE(frozen_map_arr_get, 5)
+	{
+		return key_at<2, 4, 5>::value_at<3>::frozen_map_get<dyn_func_arr, dyn_func>(amx, params);
+	}
+
+	// native frozen_map_arr_get_arr(FrozenMap:map, const AnyTag:key[], AnyTag:value[], value_size=sizeof(value), key_size=sizeof(key), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_arr_get_arr, 6, cell)
+	{
+		return key_at<2, 5, 6>::value_at<3, 4>::frozen_map_get<dyn_func_arr, dyn_func_arr>(amx, params);
+	}
+
+	// native bool:frozen_map_arr_get_safe(FrozenMap:map, const AnyTag:key[], &AnyTag:value, offset=0, key_size=sizeof(key), TagTag:key_tag_id=tagof(key), TagTag:value_tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_arr_get_safe, 7, bool)
+	{
+		return key_at<2, 5, 6>::value_at<3, 4, 7>::frozen_map_get<dyn_func_arr, frozen_func>(amx, params);
+	}
+
+	// native frozen_map_arr_get_arr_safe(FrozenMap:map, const AnyTag:key[], AnyTag:value[], value_size=sizeof(value), key_size=sizeof(key), TagTag:key_tag_id=tagof(key), TagTag:value_tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_arr_get_arr_safe, 7, cell)
+	{
+		return key_at<2, 5, 6>::value_at<3, 4, 7>::frozen_map_get<dyn_func_arr, frozen_func_arr>(amx, params);
+	}
+
+	// native frozen_map_arr_get_str_safe(FrozenMap:map, const AnyTag:key[], value[], value_size=sizeof(value), key_size=sizeof(key), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_arr_get_str_safe, 6, cell)
+	{
+		return key_at<2, 5, 6>::value_at<3, 4>::frozen_map_get<dyn_func_arr, frozen_func_str>(amx, params);
+	}
+
+	// native frozen_map_str_get(FrozenMap:map, const key[], offset=0);
+	AMX_DEFINE_NATIVE(frozen_map_str_get, 3)
+	{
+		return key_at<2>::value_at<3>::frozen_map_get<dyn_func_str, dyn_func>(amx, params);
+	}
+
+	// native frozen_map_str_get_arr(FrozenMap:map, const key[], AnyTag:value[], value_size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_str_get_arr, 4, cell)
+	{
+		return key_at<2>::value_at<3, 4>::frozen_map_get<dyn_func_str, dyn_func_arr>(amx, params);
+	}
+
+	// native bool:frozen_map_str_get_safe(FrozenMap:map, const key[], &AnyTag:value, offset=0, TagTag:value_tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_str_get_safe, 5, bool)
+	{
+		return key_at<2>::value_at<3, 4, 5>::frozen_map_get<dyn_func_str, frozen_func>(amx, params);
+	}
+
+	// native frozen_map_str_get_arr_safe(FrozenMap:map, const key[], AnyTag:value[], value_size=sizeof(value), TagTag:value_tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_str_get_arr_safe, 5, cell)
+	{
+		return key_at<2>::value_at<3, 4, 5>::frozen_map_get<dyn_func_str, frozen_func_arr>(amx, params);
+	}
+
+	// native frozen_map_str_get_str_safe(FrozenMap:map, const key[], value[], value_size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_str_get_str_safe, 4, cell)
+	{
+		return key_at<2>::value_at<3, 4>::frozen_map_get<dyn_func_str, frozen_func_str>(amx, params);
+	}
+
+	// native frozen_map_tagof(FrozenMap:map, AnyTag:key, TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_tagof, 3, cell)
+	{
+		return key_at<2, 3>::frozen_map_tagof<dyn_func>(amx, params);
+	}
+
+	// native frozen_map_sizeof(FrozenMap:map, AnyTag:key, TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_sizeof, 3, cell)
+	{
+		return key_at<2, 3>::frozen_map_sizeof<dyn_func>(amx, params);
+	}
+
+	// native frozen_map_arr_tagof(FrozenMap:map, const AnyTag:key[], key_size=sizeof(key), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_arr_tagof, 4, cell)
+	{
+		return key_at<2, 3, 4>::frozen_map_tagof<dyn_func_arr>(amx, params);
+	}
+
+	// native frozen_map_arr_sizeof(FrozenMap:map, const AnyTag:key[], key_size=sizeof(key), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(frozen_map_arr_sizeof, 4, cell)
+	{
+		return key_at<2, 3, 4>::frozen_map_sizeof<dyn_func_arr>(amx, params);
+	}
+
+	// native frozen_map_str_tagof(FrozenMap:map, const key[]);
+	AMX_DEFINE_NATIVE_TAG(frozen_map_str_tagof, 2, cell)
+	{
+		return key_at<2>::frozen_map_tagof<dyn_func_str>(amx, params);
+	}
+
+	// native frozen_map_str_sizeof(FrozenMap:map, const key[]);
+	AMX_DEFINE_NATIVE_TAG(frozen_map_str_sizeof, 2, cell)
+	{
+		return key_at<2>::frozen_map_sizeof<dyn_func_str>(amx, params);
+	}
+}
+
+static AMX_NATIVE_INFO native_list[] =
+{
+	AMX_DECLARE_NATIVE(list_freeze),
+	AMX_DECLARE_NATIVE(frozen_list_valid),
+	AMX_DECLARE_NATIVE(frozen_list_delete),
+	AMX_DECLARE_NATIVE(frozen_list_size),
+	AMX_DECLARE_NATIVE(frozen_list_get),
+	AMX_DECLARE_NATIVE(frozen_list_get_arr),
+	AMX_DECLARE_NATIVE(frozen_list_get_safe),
+	AMX_DECLARE_NATIVE(frozen_list_get_arr_safe),
+	AMX_DECLARE_NATIVE(frozen_list_get_str_safe),
+	AMX_DECLARE_NATIVE(frozen_list_tagof),
+	AMX_DECLARE_NATIVE(frozen_list_sizeof),
+
+	AMX_DECLARE_NATIVE(map_freeze),
+	AMX_DECLARE_NATIVE(frozen_map_valid),
+	AMX_DECLARE_NATIVE(frozen_map_delete),
+	AMX_DECLARE_NATIVE(frozen_map_size),
+	AMX_DECLARE_NATIVE(frozen_map_has_key),
+	AMX_DECLARE_NATIVE(frozen_map_has_arr_key),
+	AMX_DECLARE_NATIVE(frozen_map_has_str_key),
+	AMX_DECLARE_NATIVE(frozen_map_get),
+	AMX_DECLARE_NATIVE(frozen_map_get_arr),
+	AMX_DECLARE_NATIVE(frozen_map_get_safe),
+	AMX_DECLARE_NATIVE(frozen_map_get_arr_safe),
+	AMX_DECLARE_NATIVE(frozen_map_get_str_safe),
+	AMX_DECLARE_NATIVE(frozen_map_arr_get),
+	AMX_DECLARE_NATIVE(frozen_map_arr_get_arr),
+	AMX_DECLARE_NATIVE(frozen_map_arr_get_safe),
+	AMX_DECLARE_NATIVE(frozen_map_arr_get_arr_safe),
+	AMX_DECLARE_NATIVE(frozen_map_arr_get_str_safe),
+	AMX_DECLARE_NATIVE(frozen_map_str_get),
+	AMX_DECLARE_NATIVE(frozen_map_str_get_arr),
+	AMX_DECLARE_NATIVE(frozen_map_str_get_safe),
+	AMX_DECLARE_NATIVE(frozen_map_str_get_arr_safe),
+	AMX_DECLARE_NATIVE(frozen_map_str_get_str_safe),
+	AMX_DECLARE_NATIVE(frozen_map_tagof),
+	AMX_DECLARE_NATIVE(frozen_map_sizeof),
+	AMX_DECLARE_NATIVE(frozen_map_arr_tagof),
+	AMX_DECLARE_NATIVE(frozen_map_arr_sizeof),
+	AMX_DECLARE_NATIVE(frozen_map_str_tagof),
+	AMX_DECLARE_NATIVE(frozen_map_str_sizeof),
+};
+
+int RegisterFrozenNatives(AMX *amx)
+{
+	return amx_Register(amx, native_list, sizeof(native_list) / sizeof(*native_list));
+}
@@ -0,0 +1,381 @@
+#include "natives.h"
+#include "errors.h"
+#include "modules/containers.h"
+#include "modules/variants.h"
+
+template <size_t... Indices>
+class value_at
+{
+	using value_ftype = typename dyn_factory<Indices...>::type;
+	using result_ftype = typename dyn_result<Indices...>::type;
+
+public:
+	// native heap_push(Heap:heap, priority, value, ...);
+	template <value_ftype Factory, size_t KeyTagIndex>
+	static cell AMX_NATIVE_CALL heap_push(AMX *amx, cell *params)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return static_cast<cell>(ptr->push(dyn_object(amx, params[2], params[KeyTagIndex]), Factory(amx, params[Indices]...)));
+	}
+
+	// native heap_peek(Heap:heap, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL heap_peek(AMX *amx, cell *params)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		return Factory(amx, ptr->top().value, params[Indices]...);
+	}
+
+	// native heap_pop(Heap:heap, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL heap_pop(AMX *amx, cell *params)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		cell result = Factory(amx, ptr->top().value, params[Indices]...);
+		ptr->pop();
+		return result;
+	}
+
+	// native heap_get(Heap:heap, handle, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL heap_get(AMX *amx, cell *params)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		const heap_entry *entry = ptr->find(static_cast<ucell>(params[2]));
+		if(!entry) amx_LogicError(errors::element_not_present);
+		return Factory(amx, entry->value, params[Indices]...);
+	}
+};
+
+namespace Natives
+{
+	// native Heap:heap_new(bool:max=false);
+	AMX_DEFINE_NATIVE_TAG(heap_new, 0, heap)
+	{
+		return heap_pool.get_id(heap_pool.emplace(static_cast<bool>(optparam(1, 0))));
+	}
+
+	// native bool:heap_valid(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_valid, 1, bool)
+	{
+		heap_t *ptr;
+		return heap_pool.get_by_id(params[1], ptr);
+	}
+
+	// native heap_delete(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_delete, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return heap_pool.remove(ptr);
+	}
+
+	// native heap_delete_deep(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_delete_deep, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		heap_t old;
+		ptr->swap(old);
+		heap_pool.remove(ptr);
+		old.for_each_object([](const dyn_object &obj)
+		{
+			obj.release();
+		});
+		return 1;
+	}
+
+	// native Heap:heap_clone(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_clone, 1, heap)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		auto h = heap_pool.emplace(*ptr);
+		for(auto &entry : *h)
+		{
+			entry.key = entry.key.clone();
+			entry.value = entry.value.clone();
+		}
+		return heap_pool.get_id(h);
+	}
+
+	// native heap_size(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_size, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return static_cast<cell>(ptr->size());
+	}
+
+	// native bool:heap_is_max(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_is_max, 1, bool)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return ptr->is_max();
+	}
+
+	// native heap_clear(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_clear, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		ptr->clear();
+		return 1;
+	}
+
+	// native heap_clear_deep(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_clear_deep, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		heap_t old(ptr->is_max());
+		ptr->swap(old);
+		old.for_each_object([](const dyn_object &obj)
+		{
+			obj.release();
+		});
+		return 1;
+	}
+
+	// native heap_push(Heap:heap, AnyTag:priority, AnyTag:value, TagTag:priority_tag_id=tagof(priority), TagTag:value_tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_push, 5, cell)
+	{
+		return value_at<3, 5>::heap_push<dyn_func, 4>(amx, params);
+	}
+
+	// native heap_push_arr(Heap:heap, AnyTag:priority, const AnyTag:value[], size=sizeof(value), TagTag:priority_tag_id=tagof(priority), TagTag:value_tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_push_arr, 6, cell)
+	{
+		return value_at<3, 4, 6>::heap_push<dyn_func_arr, 5>(amx, params);
+	}
+
+	// native heap_push_str(Heap:heap, AnyTag:priority, const value[], TagTag:priority_tag_id=tagof(priority));
+	AMX_DEFINE_NATIVE_TAG(heap_push_str, 4, cell)
+	{
+		return value_at<3>::heap_push<dyn_func_str, 4>(amx, params);
+	}
+
+	// native heap_push_str_s(Heap:heap, AnyTag:priority, ConstStringTag:value, TagTag:priority_tag_id=tagof(priority));
+	AMX_DEFINE_NATIVE_TAG(heap_push_str_s, 4, cell)
+	{
+		return value_at<3>::heap_push<dyn_func_str_s, 4>(amx, params);
+	}
+
+	// native heap_push_var(Heap:heap, AnyTag:priority, ConstVariantTag:value, TagTag:priority_tag_id=tagof(priority));
+	AMX_DEFINE_NATIVE_TAG(heap_push_var, 4, cell)
+	{
+		return value_at<3>::heap_push<dyn_func_var, 4>(amx, params);
+	}
+
+	// native heap_peek(Heap:heap, offset=0);
+	AMX_DEFINE_NATIVE(heap_peek, 2)
+	{
+		return value_at<2>::heap_peek<dyn_func>(amx, params);
+	}
+
+	// native heap_peek_arr(Heap:heap, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_peek_arr, 3, cell)
+	{
+		return value_at<2, 3>::heap_peek<dyn_func_arr>(amx, params);
+	}
+
+	// native String:heap_peek_str_s(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_peek_str_s, 1, string)
+	{
+		return value_at<>::heap_peek<dyn_func_str_s>(amx, params);
+	}
+
+	// native Variant:heap_peek_var(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_peek_var, 1, variant)
+	{
+		return value_at<>::heap_peek<dyn_func_var>(amx, params);
+	}
+
+	// native bool:heap_peek_safe(Heap:heap, &AnyTag:value, offset=0, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_peek_safe, 4, bool)
+	{
+		return value_at<2, 3, 4>::heap_peek<dyn_func>(amx, params);
+	}
+
+	// native heap_peek_arr_safe(Heap:heap, AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_peek_arr_safe, 4, cell)
+	{
+		return value_at<2, 3, 4>::heap_peek<dyn_func_arr>(amx, params);
+	}
+
+	// native heap_peek_priority(Heap:heap, offset=0);
+	AMX_DEFINE_NATIVE(heap_peek_priority, 2)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		return dyn_func(amx, ptr->key_of(ptr->top()), params[2]);
+	}
+
+	// native heap_peek_handle(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_peek_handle, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		return static_cast<cell>(ptr->handle_of(ptr->top()));
+	}
+
+	// native heap_pop(Heap:heap, offset=0);
+	AMX_DEFINE_NATIVE(heap_pop, 2)
+	{
+		return value_at<2>::heap_pop<dyn_func>(amx, params);
+	}
+
+	// native heap_pop_arr(Heap:heap, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_pop_arr, 3, cell)
+	{
+		return value_at<2, 3>::heap_pop<dyn_func_arr>(amx, params);
+	}
+
+	// native String:heap_pop_str_s(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_pop_str_s, 1, string)
+	{
+		return value_at<>::heap_pop<dyn_func_str_s>(amx, params);
+	}
+
+	// native Variant:heap_pop_var(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_pop_var, 1, variant)
+	{
+		return value_at<>::heap_pop<dyn_func_var>(amx, params);
+	}
+
+	// native bool:heap_pop_safe(Heap:heap, &AnyTag:value, offset=0, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_pop_safe, 4, bool)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) return 0;
+		if(dyn_func(amx, ptr->top().value, params[2], params[3], params[4]))
+		{
+			ptr->pop();
+			return 1;
+		}
+		return 0;
+	}
+
+	// native heap_get(Heap:heap, handle, offset=0);
+	AMX_DEFINE_NATIVE(heap_get, 3)
+	{
+		return value_at<3>::heap_get<dyn_func>(amx, params);
+	}
+
+	// native heap_get_arr(Heap:heap, handle, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_get_arr, 4, cell)
+	{
+		return value_at<3, 4>::heap_get<dyn_func_arr>(amx, params);
+	}
+
+	// native Variant:heap_get_var(Heap:heap, handle);
+	AMX_DEFINE_NATIVE_TAG(heap_get_var, 2, variant)
+	{
+		return value_at<>::heap_get<dyn_func_var>(amx, params);
+	}
+
+	// native heap_get_priority(Heap:heap, handle, offset=0);
+	AMX_DEFINE_NATIVE(heap_get_priority, 3)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		const heap_entry *entry = ptr->find(static_cast<ucell>(params[2]));
+		if(!entry) amx_LogicError(errors::element_not_present);
+		return dyn_func(amx, ptr->key_of(*entry), params[3]);
+	}
+
+	// native bool:heap_set_priority(Heap:heap, handle, AnyTag:priority, TagTag:priority_tag_id=tagof(priority));
+	AMX_DEFINE_NATIVE_TAG(heap_set_priority, 4, bool)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return ptr->update(static_cast<ucell>(params[2]), dyn_object(amx, params[3], params[4]));
+	}
+
+	// native bool:heap_contains(Heap:heap, handle);
+	AMX_DEFINE_NATIVE_TAG(heap_contains, 2, bool)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return ptr->find(static_cast<ucell>(params[2])) != nullptr;
+	}
+
+	// native bool:heap_remove(Heap:heap, handle);
+	AMX_DEFINE_NATIVE_TAG(heap_remove, 2, bool)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return ptr->remove(static_cast<ucell>(params[2]));
+	}
+
+	// native bool:heap_remove_deep(Heap:heap, handle);
+	AMX_DEFINE_NATIVE_TAG(heap_remove_deep, 2, bool)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		const heap_entry *entry = ptr->find(static_cast<ucell>(params[2]));
+		if(!entry) return 0;
+		heap_entry old = ptr->extract(ptr->index_of(*entry));
+		old.key.release();
+		old.value.release();
+		return 1;
+	}
+}
+
+static AMX_NATIVE_INFO native_list[] =
+{
+	AMX_DECLARE_NATIVE(heap_new),
+	AMX_DECLARE_NATIVE(heap_valid),
+	AMX_DECLARE_NATIVE(heap_delete),
+	AMX_DECLARE_NATIVE(heap_delete_deep),
+	AMX_DECLARE_NATIVE(heap_clone),
+	AMX_DECLARE_NATIVE(heap_size),
+	AMX_DECLARE_NATIVE(heap_is_max),
+	AMX_DECLARE_NATIVE(heap_clear),
+	AMX_DECLARE_NATIVE(heap_clear_deep),
+
+	AMX_DECLARE_NATIVE(heap_push),
+	AMX_DECLARE_NATIVE(heap_push_arr),
+	AMX_DECLARE_NATIVE(heap_push_str),
+	AMX_DECLARE_NATIVE(heap_push_str_s),
+	AMX_DECLARE_NATIVE(heap_push_var),
+
+	AMX_DECLARE_NATIVE(heap_peek),
+	AMX_DECLARE_NATIVE(heap_peek_arr),
+	AMX_DECLARE_NATIVE(heap_peek_str_s),
+	AMX_DECLARE_NATIVE(heap_peek_var),
+	AMX_DECLARE_NATIVE(heap_peek_safe),
+	AMX_DECLARE_NATIVE(heap_peek_arr_safe),
+	AMX_DECLARE_NATIVE(heap_peek_priority),
+	AMX_DECLARE_NATIVE(heap_peek_handle),
+
+	AMX_DECLARE_NATIVE(heap_pop),
+	AMX_DECLARE_NATIVE(heap_pop_arr),
+	AMX_DECLARE_NATIVE(heap_pop_str_s),
+	AMX_DECLARE_NATIVE(heap_pop_var),
+	AMX_DECLARE_NATIVE(heap_pop_safe),
+
+	AMX_DECLARE_NATIVE(heap_get),
+	AMX_DECLARE_NATIVE(heap_get_arr),
+	AMX_DECLARE_NATIVE(heap_get_var),
+	AMX_DECLARE_NATIVE(heap_get_priority),
+	AMX_DECLARE_NATIVE(heap_set_priority),
+	AMX_DECLARE_NATIVE(heap_contains),
+	AMX_DECLARE_NATIVE(heap_remove),
+	AMX_DECLARE_NATIVE(heap_remove_deep),
+};
+
+int RegisterHeapNatives(AMX *amx)
+{
+	return amx_Register(amx, native_list, sizeof(native_list) / sizeof(*native_list));
+}
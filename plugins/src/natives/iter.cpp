@@ -285,20 +285,14 @@ namespace Natives
 		std::shared_ptr<map_t> ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		
-		auto &iter = iter_pool.emplace_derived<map_iterator_t>(ptr);
 		cell index = optparam(2, 0);
 		if(index < 0)
 		{
+			auto &iter = iter_pool.emplace_derived<map_iterator_t>(ptr);
 			iter->reset();
-		}else{
-			for(cell i = 0; i < index; i++)
-			{
-				if(!iter->move_next())
-				{
-					break;
-				}
-			}
+			return iter_pool.get_id(iter);
 		}
+		auto &iter = iter_pool.emplace_derived<map_iterator_t>(ptr, ptr->nth(index));
 		return iter_pool.get_id(iter);
 	}
 
@@ -446,6 +440,29 @@ namespace Natives
 		return iter_pool.get_id(iter);
 	}
 
+	// native Iter:heap_iter(Heap:heap, index=0);
+	AMX_DEFINE_NATIVE_TAG(heap_iter, 1, iter)
+	{
+		std::shared_ptr<heap_t> ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+
+		auto &iter = iter_pool.emplace_derived<heap_iterator_t>(ptr);
+		cell index = optparam(2, 0);
+		if(index < 0)
+		{
+			iter->reset();
+		}else{
+			for(cell i = 0; i < index; i++)
+			{
+				if(!iter->move_next())
+				{
+					break;
+				}
+			}
+		}
+		return iter_pool.get_id(iter);
+	}
+
 	// native bool:iter_valid(IterTag:iter);
 	AMX_DEFINE_NATIVE_TAG(iter_valid, 1, bool)
 	{
@@ -904,6 +921,33 @@ namespace Natives
 		return value_at<0>::iter_get<dyn_func_str_s>(amx, params);
 	}
 
+	// native iter_get_range(IterTag:iter, AnyTag:values[], size=sizeof(values), offset=0, TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(iter_get_range, 5, cell)
+	{
+		if(params[3] < 0) amx_LogicError(errors::out_of_range, "size");
+		dyn_iterator *iter;
+		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		cell *addr = amx_GetAddrSafe(amx, params[2]);
+		cell offset = params[4];
+		tag_ptr tag = tags::find_tag(amx, params[5]);
+		cell count = 0;
+		while(count < params[3] && !iter->empty())
+		{
+			bool read = value_read(iter, [&](const dyn_object &obj)
+			{
+				if(!obj.tag_assignable(tag)) return false;
+				const cell *value = obj.get_cell_addr(&offset, 1);
+				if(!value) return false;
+				addr[count] = *value;
+				return true;
+			});
+			if(!read) break;
+			count++;
+			iter->move_next();
+		}
+		return count;
+	}
+
 	// native bool:iter_set(IterTag:iter, AnyTag:value, TagTag:tag_id=tagof(value));
 	AMX_DEFINE_NATIVE_TAG(iter_set, 3, bool)
 	{
@@ -964,6 +1008,27 @@ namespace Natives
 		return ::iter_set_cells<5>(amx, params);
 	}
 
+	// native iter_set_range(IterTag:iter, const AnyTag:values[], size=sizeof(values), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(iter_set_range, 4, cell)
+	{
+		if(params[3] < 0) amx_LogicError(errors::out_of_range, "size");
+		dyn_iterator *iter;
+		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		cell *addr = amx_GetAddrSafe(amx, params[2]);
+		tag_ptr tag = tags::find_tag(amx, params[4]);
+		cell count = 0;
+		while(count < params[3] && !iter->empty())
+		{
+			value_write(iter, [&](dyn_object &obj)
+			{
+				obj = dyn_object(addr[count], tag);
+			});
+			count++;
+			iter->move_next();
+		}
+		return count;
+	}
+
 	// native iter_get_md(IterTag:iter, const offsets[], offsets_size=sizeof(offsets));
 	AMX_DEFINE_NATIVE(iter_get_md, 3)
 	{
@@ -1266,6 +1331,7 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(handle_iter),
 	AMX_DECLARE_NATIVE(pool_iter),
 	AMX_DECLARE_NATIVE(pool_iter_at),
+	AMX_DECLARE_NATIVE(heap_iter),
 
 	AMX_DECLARE_NATIVE(iter_valid),
 	AMX_DECLARE_NATIVE(iter_acquire),
@@ -1313,6 +1379,7 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(iter_get_arr_safe),
 	AMX_DECLARE_NATIVE(iter_get_str_safe),
 	AMX_DECLARE_NATIVE(iter_get_str_safe_s),
+	AMX_DECLARE_NATIVE(iter_get_range),
 
 	AMX_DECLARE_NATIVE(iter_set),
 	AMX_DECLARE_NATIVE(iter_set_arr),
@@ -1325,6 +1392,7 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(iter_set_cell_safe),
 	AMX_DECLARE_NATIVE(iter_set_cells),
 	AMX_DECLARE_NATIVE(iter_set_cells_safe),
+	AMX_DECLARE_NATIVE(iter_set_range),
 
 	AMX_DECLARE_NATIVE(iter_get_md),
 	AMX_DECLARE_NATIVE(iter_get_md_arr),
@@ -3,9 +3,35 @@
 #include "modules/containers.h"
 #include "modules/variants.h"
 #include "modules/expressions.h"
+#include "utils/radix_sort.h"
 
 #include <vector>
+#include <cstring>
 #include <algorithm>
+#include <functional>
+
+// Element of a packed list as an object
+static dyn_object packed_at(const list_t &list, size_t index)
+{
+	return dyn_object(list.get_cells()[index], list.get_cell_tag());
+}
+
+// The element at an index, copied to the buffer if the list is packed
+static const dyn_object &element_at(const list_t &list, size_t index, dyn_object &buffer)
+{
+	if(list.packed())
+	{
+		buffer = packed_at(list, index);
+		return buffer;
+	}
+	return list[index];
+}
+
+// Whether a packed list may be searched for the raw cell of the value
+static bool packed_raw(const list_t &list, const dyn_object &value)
+{
+	return value.is_cell() && value.get_tag() == list.get_cell_tag() && list.get_cell_tag()->uid == tags::tag_cell;
+}
 
 template <size_t... Indices>
 class value_at
@@ -31,7 +57,7 @@ public:
 			amx_LogicError(errors::out_of_range, "index");
 			return 0;
 		}else{
-			ptr->insert(ptr->begin() + index, Factory(amx, params[Indices]...));
+			ptr->insert_at(index, Factory(amx, params[Indices]...));
 			return index;
 		}
 	}
@@ -44,7 +70,7 @@ public:
 		list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-		(*ptr)[params[2]] = Factory(amx, params[Indices]...);
+		ptr->set_at(params[2], Factory(amx, params[Indices]...));
 		return 1;
 	}
 
@@ -56,7 +82,11 @@ public:
 		list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-		return Factory(amx, (*ptr)[params[2]], params[Indices]...);
+		if(ptr->packed())
+		{
+			return Factory(amx, packed_at(*ptr, params[2]), params[Indices]...);
+		}
+		return Factory(amx, static_cast<const list_t&>(*ptr)[params[2]], params[Indices]...);
 	}
 	
 	// native list_find(List:list, value, index=0, ...);
@@ -74,6 +104,28 @@ public:
 		{
 			if(index < 0 || static_cast<ucell>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
 			auto find = Factory(amx, params[Indices]...);
+			if(auto positions = ptr->find_index(find))
+			{
+				auto it = std::lower_bound(positions->begin(), positions->end(), static_cast<size_t>(index));
+				return it != positions->end() ? static_cast<cell>(*it) : -1;
+			}
+			if(ptr->packed())
+			{
+				const auto &cells = static_cast<const list_t*>(ptr)->get_cells();
+				if(packed_raw(*ptr, find))
+				{
+					auto it = std::find(cells.begin() + index, cells.end(), find.get_cell(0));
+					return it != cells.end() ? static_cast<cell>(it - cells.begin()) : -1;
+				}
+				for(size_t i = static_cast<size_t>(index); i < cells.size(); i++)
+				{
+					if(packed_at(*ptr, i) == find)
+					{
+						return static_cast<cell>(i);
+					}
+				}
+				return -1;
+			}
 			for(size_t i = static_cast<size_t>(index); i < ptr->size(); i++)
 			{
 				if((*ptr)[i] == find)
@@ -100,6 +152,26 @@ public:
 		{
 			if(index < 0 || static_cast<ucell>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
 			auto find = Factory(amx, params[Indices]...);
+			if(auto positions = ptr->find_index(find))
+			{
+				auto it = std::upper_bound(positions->begin(), positions->end(), static_cast<size_t>(index));
+				return it != positions->begin() ? static_cast<cell>(*--it) : -1;
+			}
+			if(ptr->packed())
+			{
+				const auto &cells = static_cast<const list_t*>(ptr)->get_cells();
+				bool raw = packed_raw(*ptr, find);
+				cell value = raw ? find.get_cell(0) : 0;
+				while(index >= 0)
+				{
+					if(raw ? cells[index] == value : packed_at(*ptr, index) == find)
+					{
+						return index;
+					}
+					index--;
+				}
+				return -1;
+			}
 			while(index >= 0)
 			{
 				if((*ptr)[index] == find)
@@ -135,7 +207,29 @@ public:
 	{
 		list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
-		return std::count(ptr->begin(), ptr->end(), Factory(amx, params[Indices]...));
+		auto find = Factory(amx, params[Indices]...);
+		if(auto positions = ptr->find_index(find))
+		{
+			return static_cast<cell>(positions->size());
+		}
+		if(ptr->packed())
+		{
+			const auto &cells = static_cast<const list_t*>(ptr)->get_cells();
+			if(packed_raw(*ptr, find))
+			{
+				return std::count(cells.begin(), cells.end(), find.get_cell(0));
+			}
+			cell count = 0;
+			for(size_t i = 0; i < cells.size(); i++)
+			{
+				if(packed_at(*ptr, i) == find)
+				{
+					count++;
+				}
+			}
+			return count;
+		}
+		return std::count(ptr->begin(), ptr->end(), find);
 	}
 };
 
@@ -148,12 +242,107 @@ static cell AMX_NATIVE_CALL list_set_cell(AMX *amx, cell *params)
 	list_t *ptr;
 	if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 	if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
+	if(ptr->packed() && params[3] == 0)
+	{
+		if(TagIndex && !packed_at(*ptr, params[2]).tag_assignable(amx, params[TagIndex])) return 0;
+		ptr->get_cells()[params[2]] = params[4];
+		return 1;
+	}
 	auto &obj = (*ptr)[params[2]];
 	if(TagIndex && !obj.tag_assignable(amx, params[TagIndex])) return 0;
 	obj.set_cell({params[3]}, params[4]);
 	return 1;
 }
 
+enum class sort_strategy
+{
+	automatic = 0,
+	comparison = 1,
+	radix = 2,
+	parallel = 3,
+};
+
+static sort_strategy sort_mode = sort_strategy::automatic;
+static size_t sort_threshold = 1024;
+
+// Splitting and merging cost about a tenth of a serial radix sort (bench/sort_bench.cpp),
+// so smaller parts cannot win it back
+constexpr size_t min_parallel_part = 16384;
+
+struct sort_entry
+{
+	std::uint64_t key;
+	size_t index;
+};
+
+// Sort keys of elements ordered by one untagged cell; elements without the cell come first
+static bool radix_keys(const list_t &list, cell offset, bool whole, bool reverse, std::vector<sort_entry> &keys)
+{
+	static tag_ptr cell_tag = tags::find_tag(tags::tag_cell);
+	keys.resize(list.size());
+	if(list.packed())
+	{
+		if(list.get_cell_tag() != cell_tag) return false;
+		const auto &cells = list.get_cells();
+		for(size_t i = 0; i < cells.size(); i++)
+		{
+			keys[i] = {aux::cell_key(offset == 0 ? &cells[i] : nullptr, reverse), i};
+		}
+	}else{
+		for(size_t i = 0; i < list.size(); i++)
+		{
+			const auto &obj = list[i];
+			if(obj.get_tag() != cell_tag || (whole && !obj.is_cell())) return false;
+			keys[i] = {aux::cell_key(obj.get_cell_addr(&offset, 1), reverse), i};
+		}
+	}
+	return true;
+}
+
+static bool radix_sort(list_t &list, cell offset, bool whole, bool reverse, bool parallel)
+{
+	std::vector<sort_entry> keys;
+	if(!radix_keys(list, offset, whole, reverse, keys))
+	{
+		return false;
+	}
+	std::vector<sort_entry> buffer(keys.size());
+	auto key = [](const sort_entry &entry) { return entry.key; };
+	size_t parts = 1;
+	if(parallel)
+	{
+		// every thread gets at least a threshold-sized part
+		parts = std::min<size_t>(std::thread::hardware_concurrency(), keys.size() / std::max(sort_threshold, min_parallel_part));
+	}
+	if(parts > 1)
+	{
+		aux::parallel_radix_sort(keys.data(), keys.data() + keys.size(), buffer.data(), key, aux::cell_key_bits, parts);
+	}else{
+		aux::radix_sort(keys.data(), keys.data() + keys.size(), buffer.data(), key, aux::cell_key_bits);
+	}
+	if(list.packed())
+	{
+		auto &cells = list.get_cells();
+		std::vector<cell> sorted;
+		sorted.reserve(cells.size());
+		for(const auto &entry : keys)
+		{
+			sorted.push_back(cells[entry.index]);
+		}
+		cells.swap(sorted);
+	}else{
+		auto &data = list.get_data();
+		std::vector<dyn_object> sorted;
+		sorted.reserve(data.size());
+		for(const auto &entry : keys)
+		{
+			sorted.push_back(std::move(data[entry.index]));
+		}
+		data.swap(sorted);
+	}
+	return true;
+}
+
 namespace Natives
 {
 	// native List:list_new();
@@ -299,6 +488,67 @@ namespace Natives
 		return static_cast<cell>(ptr->capacity());
 	}
 
+	// native bool:list_pack(List:list);
+	AMX_DEFINE_NATIVE_TAG(list_pack, 1, bool)
+	{
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		return ptr->pack();
+	}
+
+	// native bool:list_is_packed(List:list);
+	AMX_DEFINE_NATIVE_TAG(list_is_packed, 1, bool)
+	{
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		return ptr->packed();
+	}
+
+	// native list_set_indexed(List:list, bool:indexed);
+	AMX_DEFINE_NATIVE_TAG(list_set_indexed, 2, cell)
+	{
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		ptr->set_indexed(params[2]);
+		return 1;
+	}
+
+	// native bool:list_is_indexed(List:list);
+	AMX_DEFINE_NATIVE_TAG(list_is_indexed, 1, bool)
+	{
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		return ptr->is_indexed();
+	}
+
+	// native list_sum(List:list);
+	AMX_DEFINE_NATIVE(list_sum, 1)
+	{
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		if(ptr->size() == 0)
+		{
+			return 0;
+		}
+		if(ptr->packed() && ptr->get_cell_tag()->uid == tags::tag_cell)
+		{
+			ucell sum = 0;
+			for(cell value : static_cast<const list_t*>(ptr)->get_cells())
+			{
+				sum += value;
+			}
+			return static_cast<cell>(sum);
+		}
+		const list_t &list = *ptr;
+		dyn_object sum = list.packed() ? packed_at(list, 0) : list[0];
+		for(size_t i = 1; i < list.size(); i++)
+		{
+			sum = sum + (list.packed() ? packed_at(list, i) : list[i]);
+		}
+		if(!sum.is_cell()) amx_LogicError(errors::operation_not_supported, "list");
+		return sum.get_cell(0);
+	}
+
 	// native list_clear(List:list);
 	AMX_DEFINE_NATIVE_TAG(list_clear, 1, cell)
 	{
@@ -446,7 +696,7 @@ namespace Natives
 		list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-		ptr->erase(ptr->begin() + params[2]);
+		ptr->erase_at(params[2], params[2] + 1);
 		return 1;
 	}
 
@@ -475,7 +725,7 @@ namespace Natives
 		ucell end = params[3];
 		if(begin >= ptr->size()) amx_LogicError(errors::out_of_range, "begin");
 		if(end >= ptr->size() || end < begin) amx_LogicError(errors::out_of_range, "end");
-		ptr->erase(ptr->begin() + params[2], ptr->begin() + params[3]);
+		ptr->erase_at(begin, end);
 		return 1;
 	}
 
@@ -546,6 +796,63 @@ namespace Natives
 		return value_at<0>::list_get<dyn_func_str_s>(amx, params);
 	}
 
+	// native list_get_range(List:list, index, AnyTag:values[], size=sizeof(values), offset=0, TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(list_get_range, 6, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "size");
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		const list_t &list = *ptr;
+		if(static_cast<ucell>(params[2]) > list.size()) amx_LogicError(errors::out_of_range, "index");
+		size_t index = params[2];
+		cell count = static_cast<cell>(std::min<size_t>(params[4], list.size() - index));
+		if(count == 0)
+		{
+			return 0;
+		}
+		cell *addr = amx_GetAddrSafe(amx, params[3]);
+		tag_ptr tag = tags::find_tag(amx, params[6]);
+		if(list.packed())
+		{
+			if(params[5] != 0 || !packed_at(list, index).tag_assignable(tag)) return 0;
+			std::memcpy(addr, list.get_cells().data() + index, count * sizeof(cell));
+			return count;
+		}
+		return dyn_get_range(addr, count, params[5], tag, [&](cell i)
+		{
+			return &list[index + i];
+		});
+	}
+
+	// native list_get_range_arr(List:list, index, AnyTag:values[][], size=sizeof(values), size2=sizeof(values[]), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(list_get_range_arr, 6, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "size");
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		const list_t &list = *ptr;
+		if(static_cast<ucell>(params[2]) > list.size()) amx_LogicError(errors::out_of_range, "index");
+		size_t index = params[2];
+		cell count = static_cast<cell>(std::min<size_t>(params[4], list.size() - index));
+		cell *addr = amx_GetAddrSafe(amx, params[3]);
+		tag_ptr tag = tags::find_tag(amx, params[6]);
+		if(list.packed())
+		{
+			dyn_object obj;
+			return dyn_get_range_arr(addr, count, params[5], tag, [&](cell i)
+			{
+				obj = packed_at(list, index + i);
+				return &obj;
+			});
+		}
+		return dyn_get_range_arr(addr, count, params[5], tag, [&](cell i)
+		{
+			return &list[index + i];
+		});
+	}
+
 	// native list_set(List:list, index, AnyTag:value, TagTag:tag_id=tagof(value));
 	AMX_DEFINE_NATIVE_TAG(list_set, 4, cell)
 	{
@@ -582,6 +889,45 @@ namespace Natives
 		return ::list_set_cell<5>(amx, params);
 	}
 
+	// native list_set_range(List:list, index, const AnyTag:values[], size=sizeof(values), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(list_set_range, 5, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "size");
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		if(static_cast<ucell>(params[2]) > ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		cell *addr = amx_GetAddrSafe(amx, params[3]);
+		ptr->set_range(params[2], addr, params[4], tags::find_tag(amx, params[5]));
+		return params[4];
+	}
+
+	// native list_set_range_arr(List:list, index, const AnyTag:values[][], size=sizeof(values), size2=sizeof(values[]), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(list_set_range_arr, 6, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "size");
+		if(params[5] < 0) amx_LogicError(errors::out_of_range, "size2");
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		if(static_cast<ucell>(params[2]) > ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		size_t index = params[2];
+		cell *addr = amx_GetAddrSafe(amx, params[3]);
+		tag_ptr tag = tags::find_tag(amx, params[6]);
+		ptr->reserve(index + params[4]);
+		for(cell i = 0; i < params[4]; i++)
+		{
+			dyn_object value(amx_array_row(addr, i), params[5], tag);
+			if(index + i < ptr->size())
+			{
+				ptr->set_at(index + i, std::move(value));
+			}else{
+				ptr->push_back(std::move(value));
+			}
+		}
+		return params[4];
+	}
+
 	// native list_resize(List:list, newsize, AnyTag:padding, TagTag:tag_id=tagof(padding));
 	AMX_DEFINE_NATIVE_TAG(list_resize, 4, cell)
 	{
@@ -624,7 +970,11 @@ namespace Natives
 		list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-		auto &obj = (*ptr)[params[2]];
+		if(ptr->packed())
+		{
+			return ptr->get_cell_tag()->get_id(amx);
+		}
+		const auto &obj = static_cast<const list_t&>(*ptr)[params[2]];
 		return obj.get_tag(amx);
 	}
 
@@ -635,7 +985,11 @@ namespace Natives
 		list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-		auto &obj = (*ptr)[params[2]];
+		if(ptr->packed())
+		{
+			return packed_at(*ptr, params[2]).get_size();
+		}
+		const auto &obj = static_cast<const list_t&>(*ptr)[params[2]];
 		return obj.get_size();
 	}
 
@@ -702,14 +1056,14 @@ namespace Natives
 		if(index != ptr->size())
 		{
 			if(index < 0 || static_cast<ucell>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-			dyn_object key;
+			dyn_object key, element;
 			expression::args_type args;
 			args.push_back(std::cref(key));
 			args.push_back(std::cref(key));
 			expression::exec_info info(amx);
 			for(size_t i = static_cast<size_t>(index); i < ptr->size(); i++)
 			{
-				args[0] = std::cref((*ptr)[i]);
+				args[0] = std::cref(element_at(*ptr, i, element));
 				key = dyn_object(i, tags::find_tag(tags::tag_cell));
 				if(expr->execute_bool(args, info))
 				{
@@ -735,14 +1089,14 @@ namespace Natives
 		if(index != -1)
 		{
 			if(index < 0 || static_cast<ucell>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-			dyn_object key;
+			dyn_object key, element;
 			expression::args_type args;
 			args.push_back(std::cref(key));
 			args.push_back(std::cref(key));
 			expression::exec_info info(amx);
 			while(index >= 0)
 			{
-				args[0] = std::cref((*ptr)[index]);
+				args[0] = std::cref(element_at(*ptr, index, element));
 				key = dyn_object(index, tags::find_tag(tags::tag_cell));
 				if(expr->execute_bool(args, info))
 				{
@@ -921,6 +1275,28 @@ namespace Natives
 
 		bool simple = offset == 0 && size == -1;
 
+		if((simple || size == 1) && sort_mode != sort_strategy::comparison)
+		{
+			bool large = ptr->size() >= sort_threshold;
+			if((large || sort_mode == sort_strategy::radix) && radix_sort(*ptr, offset, simple, reverse, large && sort_mode == sort_strategy::parallel))
+			{
+				return 1;
+			}
+		}
+
+		if(simple && ptr->packed() && ptr->get_cell_tag()->uid == tags::tag_cell)
+		{
+			// equal cells are indistinguishable, so stability does not matter
+			auto &cells = ptr->get_cells();
+			if(!reverse)
+			{
+				std::sort(cells.begin(), cells.end());
+			}else{
+				std::sort(cells.begin(), cells.end(), std::greater<cell>());
+			}
+			return 1;
+		}
+
 		if(!reverse)
 		{
 			auto begin = ptr->begin(), end = ptr->end();
@@ -962,6 +1338,21 @@ namespace Natives
 		return 1;
 	}
 
+	// native sort_strategy:list_sort_strategy(sort_strategy:strategy, threshold=-1);
+	AMX_DEFINE_NATIVE_TAG(list_sort_strategy, 1, cell)
+	{
+		if(params[1] < 0 || params[1] > static_cast<cell>(sort_strategy::parallel)) amx_LogicError(errors::out_of_range, "strategy");
+		cell threshold = optparam(2, -1);
+		if(threshold < -1) amx_LogicError(errors::out_of_range, "threshold");
+		auto old = sort_mode;
+		sort_mode = static_cast<sort_strategy>(params[1]);
+		if(threshold != -1)
+		{
+			sort_threshold = threshold;
+		}
+		return static_cast<cell>(old);
+	}
+
 	struct expr_sorter
 	{
 		const expression *expr;
@@ -1037,6 +1428,11 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(list_clone),
 	AMX_DECLARE_NATIVE(list_size),
 	AMX_DECLARE_NATIVE(list_capacity),
+	AMX_DECLARE_NATIVE(list_pack),
+	AMX_DECLARE_NATIVE(list_is_packed),
+	AMX_DECLARE_NATIVE(list_set_indexed),
+	AMX_DECLARE_NATIVE(list_is_indexed),
+	AMX_DECLARE_NATIVE(list_sum),
 	AMX_DECLARE_NATIVE(list_reserve),
 	AMX_DECLARE_NATIVE(list_clear),
 	AMX_DECLARE_NATIVE(list_clear_deep),
@@ -1066,6 +1462,8 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(list_get_arr_safe),
 	AMX_DECLARE_NATIVE(list_get_str_safe),
 	AMX_DECLARE_NATIVE(list_get_str_safe_s),
+	AMX_DECLARE_NATIVE(list_get_range),
+	AMX_DECLARE_NATIVE(list_get_range_arr),
 
 	AMX_DECLARE_NATIVE(list_set),
 	AMX_DECLARE_NATIVE(list_set_arr),
@@ -1073,6 +1471,8 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(list_set_var),
 	AMX_DECLARE_NATIVE(list_set_cell),
 	AMX_DECLARE_NATIVE(list_set_cell_safe),
+	AMX_DECLARE_NATIVE(list_set_range),
+	AMX_DECLARE_NATIVE(list_set_range_arr),
 
 	AMX_DECLARE_NATIVE(list_resize),
 	AMX_DECLARE_NATIVE(list_resize_arr),
@@ -1097,6 +1497,7 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(list_count_if),
 
 	AMX_DECLARE_NATIVE(list_sort),
+	AMX_DECLARE_NATIVE(list_sort_strategy),
 	AMX_DECLARE_NATIVE(list_sort_expr),
 
 	AMX_DECLARE_NATIVE(list_tagof),
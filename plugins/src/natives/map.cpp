@@ -6,6 +6,86 @@
 #include <iterator>
 #include <algorithm>
 
+// Looks up keys in a map, avoiding creating the key where possible
+template <class Factory, Factory KeyFactory>
+struct map_key
+{
+	template <class... Args>
+	static map_t::iterator find(map_t &map, AMX *amx, Args... args)
+	{
+		return map.find(KeyFactory(amx, args...));
+	}
+
+	template <class... Args>
+	static map_t::const_iterator find(const map_t &map, AMX *amx, Args... args)
+	{
+		return map.find(KeyFactory(amx, args...));
+	}
+
+	template <class... Args>
+	static void set(map_t &map, dyn_object &&value, AMX *amx, Args... args)
+	{
+		map[KeyFactory(amx, args...)] = std::move(value);
+	}
+};
+
+template <>
+struct map_key<dyn_object(&)(AMX*, cell, cell), dyn_func>
+{
+	static bool untagged(cell tag_id)
+	{
+		return (tag_id & 0x7FFFFFFF) == 0 || tag_id == tags::tag_cell;
+	}
+
+	template <class Map>
+	static auto find(Map &map, AMX *amx, cell value, cell tag_id) -> decltype(map.find_as(cell_key{value}))
+	{
+		if(untagged(tag_id))
+		{
+			return map.find_as(cell_key{value});
+		}
+		return map.find(dyn_func(amx, value, tag_id));
+	}
+
+	static void set(map_t &map, dyn_object &&value, AMX *amx, cell key, cell tag_id)
+	{
+		if(untagged(tag_id))
+		{
+			auto it = map.find_as(cell_key{key});
+			if(it != map.end())
+			{
+				it->second = std::move(value);
+			}else{
+				map[cell_key{key}.key()] = std::move(value);
+			}
+			return;
+		}
+		map[dyn_func(amx, key, tag_id)] = std::move(value);
+	}
+};
+
+template <>
+struct map_key<dyn_object(&)(AMX*, cell), dyn_func_str>
+{
+	template <class Map>
+	static auto find(Map &map, AMX *amx, cell amx_addr) -> decltype(map.find_as(str_key(nullptr)))
+	{
+		return map.find_as(str_key(amx_GetAddrSafe(amx, amx_addr)));
+	}
+
+	static void set(map_t &map, dyn_object &&value, AMX *amx, cell amx_addr)
+	{
+		str_key key(amx_GetAddrSafe(amx, amx_addr));
+		auto it = map.find_as(key);
+		if(it != map.end())
+		{
+			it->second = std::move(value);
+		}else{
+			map[key.key()] = std::move(value);
+		}
+	}
+};
+
 template <size_t... KeyIndices>
 class key_at
 {
@@ -35,7 +115,7 @@ public:
 		{
 			map_t *ptr;
 			if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-			(*ptr)[KeyFactory(amx, params[KeyIndices]...)] = ValueFactory(amx, params[ValueIndices]...);
+			map_key<key_ftype, KeyFactory>::set(*ptr, ValueFactory(amx, params[ValueIndices]...), amx, params[KeyIndices]...);
 			return 1;
 		}
 
@@ -45,8 +125,9 @@ public:
 		{
 			map_t *ptr;
 			if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-			auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
-			if(it != ptr->end())
+			const map_t &map = *ptr;
+			auto it = map_key<key_ftype, KeyFactory>::find(map, amx, params[KeyIndices]...);
+			if(it != map.cend())
 			{
 				return ValueFactory(amx, it->second, params[ValueIndices]...);
 			}
@@ -61,7 +142,7 @@ public:
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 		if(it != ptr->end())
 		{
 			ptr->erase(it);
@@ -76,7 +157,7 @@ public:
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 		if(it != ptr->end())
 		{
 			it->first.release();
@@ -93,8 +174,9 @@ public:
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
-		if(it != ptr->end())
+		const map_t &map = *ptr;
+		auto it = map_key<key_ftype, KeyFactory>::find(map, amx, params[KeyIndices]...);
+		if(it != map.cend())
 		{
 			return 1;
 		}
@@ -108,7 +190,7 @@ public:
 		if(params[3] < 0) amx_LogicError(errors::out_of_range, "offset");
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 		if(it != ptr->end())
 		{
 			auto &obj = it->second;
@@ -120,14 +202,33 @@ public:
 		return 0;
 	}
 
+	// native map_key_rank(Map:map, key, ...);
+	template <key_ftype KeyFactory>
+	static cell AMX_NATIVE_CALL map_key_rank(AMX *amx, cell *params)
+	{
+		map_t *ptr;
+		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+		if(ptr->ordered())
+		{
+			return static_cast<cell>(ptr->rank(KeyFactory(amx, params[KeyIndices]...)));
+		}
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
+		if(it != ptr->end())
+		{
+			return static_cast<cell>(ptr->index_of(it));
+		}
+		return -1;
+	}
+
 	// native map_tagof(Map:map, key, ...);
 	template <key_ftype KeyFactory>
 	static cell AMX_NATIVE_CALL map_tagof(AMX *amx, cell *params)
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
-		if(it != ptr->end())
+		const map_t &map = *ptr;
+		auto it = map_key<key_ftype, KeyFactory>::find(map, amx, params[KeyIndices]...);
+		if(it != map.cend())
 		{
 			return it->second.get_tag(amx);
 		}
@@ -141,8 +242,9 @@ public:
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
-		if(it != ptr->end())
+		const map_t &map = *ptr;
+		auto it = map_key<key_ftype, KeyFactory>::find(map, amx, params[KeyIndices]...);
+		if(it != map.cend())
 		{
 			return it->second.get_size();
 		}
@@ -167,9 +269,8 @@ public:
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		if(static_cast<size_t>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-		auto it = ptr->begin();
-		std::advance(it, index);
-		if(it != ptr->end())
+		map_t::const_iterator it = ptr->nth(index);
+		if(it != ptr->cend())
 		{
 			return ValueFactory(amx, it->first, params[ValueIndices]...);
 		}
@@ -186,9 +287,8 @@ public:
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		if(static_cast<size_t>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-		auto it = ptr->begin();
-		std::advance(it, index);
-		if(it != ptr->end())
+		map_t::const_iterator it = ptr->nth(index);
+		if(it != ptr->cend())
 		{
 			return ValueFactory(amx, it->second, params[ValueIndices]...);
 		}
@@ -203,7 +303,7 @@ public:
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		auto find = ValueFactory(amx, params[ValueIndices]...);
-		return std::count_if(ptr->begin(), ptr->end(), [&](const std::pair<const dyn_object, dyn_object> &pair)
+		return std::count_if(ptr->cbegin(), ptr->cend(), [&](const std::pair<const dyn_object, dyn_object> &pair)
 		{
 			return pair.second == find;
 		});
@@ -219,6 +319,13 @@ namespace Natives
 		return map_pool.get_id(map_pool.emplace(ordered));
 	}
 
+	// native Map:map_new_storage(map_storage:storage);
+	AMX_DEFINE_NATIVE_TAG(map_new_storage, 1, map)
+	{
+		if(params[1] < 0 || params[1] > static_cast<cell>(aux::hybrid_map_mode::btree)) amx_LogicError(errors::out_of_range, "storage");
+		return map_pool.get_id(map_pool.emplace(static_cast<aux::hybrid_map_mode>(params[1])));
+	}
+
 	// native Map:map_new_args(key_tag_id=tagof(arg0), TagTag:value_tag_id=tagof(arg1), AnyTag:arg0, AnyTag:arg1, AnyTag:...);
 	AMX_DEFINE_NATIVE_TAG(map_new_args, 0, map)
 	{
@@ -541,7 +648,7 @@ namespace Natives
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		map_t old(ptr->ordered());
+		map_t old(ptr->mode());
 		ptr->swap(old);
 		return map_pool.remove(ptr);
 	}
@@ -551,7 +658,7 @@ namespace Natives
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		map_t old(ptr->ordered());
+		map_t old(ptr->mode());
 		ptr->swap(old);
 		map_pool.remove(ptr);
 		for(auto &pair : old)
@@ -568,14 +675,22 @@ namespace Natives
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		auto m = map_pool.add();
-		m->set_ordered(ptr->ordered());
-		for(auto &&pair : *ptr)
+		m->set_mode(ptr->mode());
+		for(auto it = ptr->cbegin(); it != ptr->cend(); ++it)
 		{
-			m->insert(pair.first.clone(), pair.second.clone());
+			m->insert(it->first.clone(), it->second.clone());
 		}
 		return map_pool.get_id(m);
 	}
 
+	// native Map:map_snapshot(Map:map);
+	AMX_DEFINE_NATIVE_TAG(map_snapshot, 1, map)
+	{
+		map_t *ptr;
+		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+		return map_pool.get_id(map_pool.emplace(*ptr));
+	}
+
 	// native map_size(Map:map);
 	AMX_DEFINE_NATIVE_TAG(map_size, 1, cell)
 	{
@@ -608,7 +723,7 @@ namespace Natives
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		map_t(ptr->ordered()).swap(*ptr);
+		map_t(ptr->mode()).swap(*ptr);
 		return 1;
 	}
 
@@ -617,7 +732,7 @@ namespace Natives
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		map_t old(ptr->ordered());
+		map_t old(ptr->mode());
 		ptr->swap(old);
 		for(auto &pair : old)
 		{
@@ -644,6 +759,24 @@ namespace Natives
 		return ptr->ordered();
 	}
 
+	// native map_set_storage(Map:map, map_storage:storage);
+	AMX_DEFINE_NATIVE_TAG(map_set_storage, 2, cell)
+	{
+		if(params[2] < 0 || params[2] > static_cast<cell>(aux::hybrid_map_mode::btree)) amx_LogicError(errors::out_of_range, "storage");
+		map_t *ptr;
+		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+		ptr->set_mode(static_cast<aux::hybrid_map_mode>(params[2]));
+		return 1;
+	}
+
+	// native map_storage:map_get_storage(Map:map);
+	AMX_DEFINE_NATIVE_TAG(map_get_storage, 1, cell)
+	{
+		map_t *ptr;
+		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+		return static_cast<cell>(ptr->mode());
+	}
+
 	// native bool:map_add(Map:map, AnyTag:key, AnyTag:value, TagTag:key_tag_id=tagof(key), TagTag:value_tag_id=tagof(value));
 	AMX_DEFINE_NATIVE_TAG(map_add, 5, bool)
 	{
@@ -754,7 +887,7 @@ namespace Natives
 				(*ptr)[pair.first] = pair.second;
 			}
 		}else{
-			ptr->insert(ptr2->begin(), ptr2->end());
+			ptr->insert(ptr2->cbegin(), ptr2->cend());
 		}
 		return ptr->size() - ptr2->size();
 	}
@@ -1146,13 +1279,15 @@ namespace Natives
 		auto it = ptr->begin();
 		while(it != ptr->end())
 		{
+			// the predicate only reads, so persistent storage is not unshared
+			const auto &pair = *map_t::const_iterator(it);
 			if(args.size() == 0)
 			{
-				args.push_back(std::cref(it->second));
-				args.push_back(std::cref(it->first));
+				args.push_back(std::cref(pair.second));
+				args.push_back(std::cref(pair.first));
 			}else{
-				args[0] = std::cref(it->second);
-				args[1] = std::cref(it->first);
+				args[0] = std::cref(pair.second);
+				args[1] = std::cref(pair.first);
 			}
 			if(expr->execute_bool(args, info))
 			{
@@ -1180,18 +1315,20 @@ namespace Natives
 		auto it = ptr->begin();
 		while(it != ptr->end())
 		{
+			// the predicate only reads, so persistent storage is not unshared
+			const auto &pair = *map_t::const_iterator(it);
 			if(args.size() == 0)
 			{
-				args.push_back(std::cref(it->second));
-				args.push_back(std::cref(it->first));
+				args.push_back(std::cref(pair.second));
+				args.push_back(std::cref(pair.first));
 			}else{
-				args[0] = std::cref(it->second);
-				args[1] = std::cref(it->first);
+				args[0] = std::cref(pair.second);
+				args[1] = std::cref(pair.first);
 			}
 			if(expr->execute_bool(args, info))
 			{
-				it->first.release();
-				it->second.release();
+				pair.first.release();
+				pair.second.release();
 				it = ptr->erase(it);
 				count++;
 			}else{
@@ -1225,6 +1362,30 @@ namespace Natives
 		return key_at<2>::map_has_key<dyn_func_var>(amx, params);
 	}
 
+	// native map_key_rank(Map:map, AnyTag:key, TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(map_key_rank, 3, cell)
+	{
+		return key_at<2, 3>::map_key_rank<dyn_func>(amx, params);
+	}
+
+	// native map_arr_key_rank(Map:map, const AnyTag:key[], key_size=sizeof(key), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(map_arr_key_rank, 4, cell)
+	{
+		return key_at<2, 3, 4>::map_key_rank<dyn_func_arr>(amx, params);
+	}
+
+	// native map_str_key_rank(Map:map, const key[]);
+	AMX_DEFINE_NATIVE_TAG(map_str_key_rank, 2, cell)
+	{
+		return key_at<2>::map_key_rank<dyn_func_str>(amx, params);
+	}
+
+	// native map_var_key_rank(Map:map, VariantTag:key);
+	AMX_DEFINE_NATIVE_TAG(map_var_key_rank, 2, cell)
+	{
+		return key_at<2>::map_key_rank<dyn_func_var>(amx, params);
+	}
+
 	// native map_get(Map:map, AnyTag:key, offset=0, TagTag:key_tag_id=tagof(key));
 	AMX_DEFINE_NATIVE(map_get, 4)
 	{
@@ -1657,7 +1818,7 @@ namespace Natives
 		expression::exec_info info(amx);
 
 		cell count = 0;
-		for(auto it = ptr->begin(); it != ptr->end(); ++it)
+		for(auto it = ptr->cbegin(); it != ptr->cend(); ++it)
 		{
 			if(args.size() == 0)
 			{
@@ -1727,6 +1888,7 @@ namespace Natives
 static AMX_NATIVE_INFO native_list[] =
 {
 	AMX_DECLARE_NATIVE(map_new),
+	AMX_DECLARE_NATIVE(map_new_storage),
 	AMX_DECLARE_NATIVE(map_new_args),
 	AMX_DECLARE_NATIVE(map_new_args_str),
 	AMX_DECLARE_NATIVE(map_new_args_var),
@@ -1746,6 +1908,7 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(map_delete),
 	AMX_DECLARE_NATIVE(map_delete_deep),
 	AMX_DECLARE_NATIVE(map_clone),
+	AMX_DECLARE_NATIVE(map_snapshot),
 	AMX_DECLARE_NATIVE(map_size),
 	AMX_DECLARE_NATIVE(map_capacity),
 	AMX_DECLARE_NATIVE(map_reserve),
@@ -1753,6 +1916,8 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(map_clear_deep),
 	AMX_DECLARE_NATIVE(map_set_ordered),
 	AMX_DECLARE_NATIVE(map_is_ordered),
+	AMX_DECLARE_NATIVE(map_set_storage),
+	AMX_DECLARE_NATIVE(map_get_storage),
 
 	AMX_DECLARE_NATIVE(map_add),
 	AMX_DECLARE_NATIVE(map_add_arr),
@@ -1799,6 +1964,10 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(map_has_arr_key),
 	AMX_DECLARE_NATIVE(map_has_str_key),
 	AMX_DECLARE_NATIVE(map_has_var_key),
+	AMX_DECLARE_NATIVE(map_key_rank),
+	AMX_DECLARE_NATIVE(map_arr_key_rank),
+	AMX_DECLARE_NATIVE(map_str_key_rank),
+	AMX_DECLARE_NATIVE(map_var_key_rank),
 
 	AMX_DECLARE_NATIVE(map_get),
 	AMX_DECLARE_NATIVE(map_get_arr),
@@ -6,6 +6,9 @@
 #include "modules/strings.h"
 #include "modules/containers.h"
 #include "modules/guards.h"
+#include "modules/variants.h"
+#include "modules/expressions.h"
+#include "modules/tasks.h"
 #include "utils/shared_id_set_pool.h"
 #include <limits>
 
@@ -664,6 +667,77 @@ namespace Natives
 
 		return amx_guards::free(amx, obj);
 	}
+
+	template <class Type>
+	static auto object_memory(const Type &obj, int) -> decltype(obj.memory_size())
+	{
+		return sizeof(Type) + obj.memory_size();
+	}
+
+	template <class Type>
+	static size_t object_memory(const Type &obj, long)
+	{
+		return sizeof(Type);
+	}
+
+	static size_t object_memory(const strings::cell_string &str, int)
+	{
+		return sizeof(str) + str.capacity() * sizeof(cell);
+	}
+
+	static size_t object_memory(const dyn_object &obj, int)
+	{
+		return sizeof(obj) + obj.heap_size();
+	}
+
+	template <class Type, class Pool>
+	static void amx_count_owned(Pool &pool, AMX *owner, cell &count, cell &memory)
+	{
+		count += static_cast<cell>(pool.owned_size(owner));
+		size_t bytes = 0;
+		pool.for_each_owned(owner, [&](const Type &obj)
+		{
+			bytes += object_memory(obj, 0);
+		});
+		memory += static_cast<cell>(bytes);
+	}
+
+	// native amx_num_owned(Amx:amx=INVALID_AMX, &memory=0);
+	AMX_DEFINE_NATIVE_TAG(amx_num_owned, 0, cell)
+	{
+		AMX *owner = amx;
+		if(optparam(1, 0) != 0)
+		{
+			owner = reinterpret_cast<AMX*>(params[1]);
+			if(!amx::valid(owner))
+			{
+				*optparamref(2, 0) = 0;
+				return 0;
+			}
+		}
+		owner = amx::load_lock(owner)->origin();
+
+		cell count = 0, memory = 0;
+		amx_count_owned<strings::cell_string>(strings::pool, owner, count, memory);
+		amx_count_owned<dyn_object>(variants::pool, owner, count, memory);
+		amx_count_owned<list_t>(list_pool, owner, count, memory);
+		amx_count_owned<map_t>(map_pool, owner, count, memory);
+		amx_count_owned<linked_list_t>(linked_list_pool, owner, count, memory);
+		amx_count_owned<pool_t>(pool_pool, owner, count, memory);
+		amx_count_owned<heap_t>(heap_pool, owner, count, memory);
+		amx_count_owned<spatial_t>(spatial_pool, owner, count, memory);
+		amx_count_owned<frozen_list_t>(frozen_list_pool, owner, count, memory);
+		amx_count_owned<frozen_map_t>(frozen_map_pool, owner, count, memory);
+		amx_count_owned<dyn_iterator>(iter_pool, owner, count, memory);
+		amx_count_owned<handle_t>(handle_pool, owner, count, memory);
+		amx_count_owned<expression>(expression_pool, owner, count, memory);
+		amx_count_owned<amx_var_info>(amx_var_pool, owner, count, memory);
+		cell tasks_count = static_cast<cell>(tasks::owned_size(owner));
+		count += tasks_count;
+		memory += tasks_count * static_cast<cell>(sizeof(tasks::task));
+		*optparamref(2, 0) = memory;
+		return count;
+	}
 }
 
 static AMX_NATIVE_INFO native_list[] =
@@ -726,6 +800,7 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(amx_guard_arr),
 	AMX_DECLARE_NATIVE(amx_guard_valid),
 	AMX_DECLARE_NATIVE(amx_guard_free),
+	AMX_DECLARE_NATIVE(amx_num_owned),
 };
 
 int RegisterAmxNatives(AMX *amx)
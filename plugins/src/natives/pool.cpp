@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <limits>
 
 template <size_t... Indices>
 class value_at
@@ -392,6 +393,36 @@ namespace Natives
 		return value_at<0>::pool_get<dyn_func_str_s>(amx, params);
 	}
 
+	// native pool_get_range(Pool:pool, index, AnyTag:values[], size=sizeof(values), offset=0, TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(pool_get_range, 6, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "size");
+		pool_t *ptr;
+		if(!pool_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "pool", params[1]);
+		cell *addr = amx_GetAddrSafe(amx, params[3]);
+		return dyn_get_range(addr, params[4], params[5], tags::find_tag(amx, params[6]), [&](cell i) -> const dyn_object*
+		{
+			auto it = ptr->find(params[2] + i);
+			return it != ptr->end() ? &*it : nullptr;
+		});
+	}
+
+	// native pool_get_range_arr(Pool:pool, index, AnyTag:values[][], size=sizeof(values), size2=sizeof(values[]), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(pool_get_range_arr, 6, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "size");
+		pool_t *ptr;
+		if(!pool_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "pool", params[1]);
+		cell *addr = amx_GetAddrSafe(amx, params[3]);
+		return dyn_get_range_arr(addr, params[4], params[5], tags::find_tag(amx, params[6]), [&](cell i) -> const dyn_object*
+		{
+			auto it = ptr->find(params[2] + i);
+			return it != ptr->end() ? &*it : nullptr;
+		});
+	}
+
 	// native pool_set(Pool:pool, index, AnyTag:value, TagTag:tag_id=tagof(value));
 	AMX_DEFINE_NATIVE_TAG(pool_set, 4, cell)
 	{
@@ -416,6 +447,43 @@ namespace Natives
 		return value_at<3>::pool_set<dyn_func_var>(amx, params);
 	}
 
+	// native pool_set_range(Pool:pool, index, const AnyTag:values[], size=sizeof(values), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(pool_set_range, 5, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "size");
+		if(static_cast<ucell>(params[2]) + static_cast<ucell>(params[4]) > static_cast<ucell>(std::numeric_limits<cell>::max())) amx_LogicError(errors::out_of_range, "size");
+		pool_t *ptr;
+		if(!pool_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "pool", params[1]);
+		cell *addr = amx_GetAddrSafe(amx, params[3]);
+		tag_ptr tag = tags::find_tag(amx, params[5]);
+		ptr->reserve(params[2] + params[4]);
+		for(cell i = 0; i < params[4]; i++)
+		{
+			ptr->insert_or_set(params[2] + i, dyn_object(addr[i], tag));
+		}
+		return params[4];
+	}
+
+	// native pool_set_range_arr(Pool:pool, index, const AnyTag:values[][], size=sizeof(values), size2=sizeof(values[]), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(pool_set_range_arr, 6, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "size");
+		if(static_cast<ucell>(params[2]) + static_cast<ucell>(params[4]) > static_cast<ucell>(std::numeric_limits<cell>::max())) amx_LogicError(errors::out_of_range, "size");
+		if(params[5] < 0) amx_LogicError(errors::out_of_range, "size2");
+		pool_t *ptr;
+		if(!pool_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "pool", params[1]);
+		cell *addr = amx_GetAddrSafe(amx, params[3]);
+		tag_ptr tag = tags::find_tag(amx, params[6]);
+		ptr->reserve(params[2] + params[4]);
+		for(cell i = 0; i < params[4]; i++)
+		{
+			ptr->insert_or_set(params[2] + i, dyn_object(amx_array_row(addr, i), params[5], tag));
+		}
+		return params[4];
+	}
+
 	// native pool_set_cell(Pool:pool, index, offset, AnyTag:value);
 	AMX_DEFINE_NATIVE_TAG(pool_set_cell, 3, cell)
 	{
@@ -650,6 +718,8 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(pool_get_arr_safe),
 	AMX_DECLARE_NATIVE(pool_get_str_safe),
 	AMX_DECLARE_NATIVE(pool_get_str_safe_s),
+	AMX_DECLARE_NATIVE(pool_get_range),
+	AMX_DECLARE_NATIVE(pool_get_range_arr),
 
 	AMX_DECLARE_NATIVE(pool_set),
 	AMX_DECLARE_NATIVE(pool_set_arr),
@@ -657,6 +727,8 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(pool_set_var),
 	AMX_DECLARE_NATIVE(pool_set_cell),
 	AMX_DECLARE_NATIVE(pool_set_cell_safe),
+	AMX_DECLARE_NATIVE(pool_set_range),
+	AMX_DECLARE_NATIVE(pool_set_range_arr),
 
 	AMX_DECLARE_NATIVE(pool_find),
 	AMX_DECLARE_NATIVE(pool_find_arr),
@@ -11,6 +11,7 @@
 #include "modules/containers.h"
 #include "modules/amxhook.h"
 #include "modules/expressions.h"
+#include "modules/telemetry.h"
 #include "utils/systools.h"
 
 #include <cstring>
@@ -80,6 +81,22 @@ namespace Natives
 		return orig;
 	}
 
+	// native bool:pp_copy_on_write(bool:enable);
+	AMX_DEFINE_NATIVE_TAG(pp_copy_on_write, 1, bool)
+	{
+		bool orig = dyn_object::copy_on_write;
+		dyn_object::copy_on_write = !!params[1];
+		return orig;
+	}
+
+	// native bool:pp_intern_keys(bool:intern);
+	AMX_DEFINE_NATIVE_TAG(pp_intern_keys, 1, bool)
+	{
+		bool orig = dyn_object::intern_keys;
+		dyn_object::intern_keys = !!params[1];
+		return orig;
+	}
+
 	// native pp_tick();
 	AMX_DEFINE_NATIVE_TAG(pp_tick, 0, cell)
 	{
@@ -105,6 +122,30 @@ namespace Natives
 		return strings::pool.global_size();
 	}
 
+	// native pp_string_cache_hits();
+	AMX_DEFINE_NATIVE_TAG(pp_string_cache_hits, 0, cell)
+	{
+		return static_cast<cell>(strings::pool.cache_hits());
+	}
+
+	// native pp_string_cache_misses();
+	AMX_DEFINE_NATIVE_TAG(pp_string_cache_misses, 0, cell)
+	{
+		return static_cast<cell>(strings::pool.cache_misses());
+	}
+
+	// native pp_num_interned_arrays();
+	AMX_DEFINE_NATIVE_TAG(pp_num_interned_arrays, 0, cell)
+	{
+		return static_cast<cell>(dyn_object::num_interned());
+	}
+
+	// native pp_collect_interned_arrays();
+	AMX_DEFINE_NATIVE_TAG(pp_collect_interned_arrays, 0, cell)
+	{
+		return static_cast<cell>(dyn_object::collect_interned());
+	}
+
 	// native pp_num_local_variants();
 	AMX_DEFINE_NATIVE_TAG(pp_num_local_variants, 0, cell)
 	{
@@ -141,6 +182,18 @@ namespace Natives
 		return pool_pool.size();
 	}
 
+	// native pp_num_heaps();
+	AMX_DEFINE_NATIVE_TAG(pp_num_heaps, 0, cell)
+	{
+		return heap_pool.size();
+	}
+
+	// native pp_num_spatials();
+	AMX_DEFINE_NATIVE_TAG(pp_num_spatials, 0, cell)
+	{
+		return spatial_pool.size();
+	}
+
 	// native pp_num_guards();
 	AMX_DEFINE_NATIVE_TAG(pp_num_guards, 0, cell)
 	{
@@ -258,6 +311,27 @@ namespace Natives
 		return 1;
 	}
 
+	// native Map:pp_stats();
+	AMX_DEFINE_NATIVE_TAG(pp_stats, 0, map)
+	{
+		return telemetry::create_map();
+	}
+
+	// native pp_stats_reset();
+	AMX_DEFINE_NATIVE_TAG(pp_stats_reset, 0, cell)
+	{
+		telemetry::reset();
+		return 1;
+	}
+
+	// native bool:pp_stats_dump(const file[]="");
+	AMX_DEFINE_NATIVE_TAG(pp_stats_dump, 0, bool)
+	{
+		const char *file;
+		amx_OptStrParam(amx, 1, file, nullptr);
+		return telemetry::dump(file);
+	}
+
 	// native pp_num_natives();
 	AMX_DEFINE_NATIVE_TAG(pp_num_natives, 0, cell)
 	{
@@ -280,6 +354,15 @@ namespace Natives
 		return old;
 	}
 
+	// native bool:pp_unload_cleanup(bool:cleanup);
+	AMX_DEFINE_NATIVE_TAG(pp_unload_cleanup, 1, bool)
+	{
+		auto &extra = amx::load_lock(amx)->get_extra<native_unload_cleanup>();
+		bool old = extra.cleanup;
+		extra.cleanup = !!params[1];
+		return old;
+	}
+
 	// native pp_raise_error(const message[], error_level:level=error_logic);
 	AMX_DEFINE_NATIVE_TAG(pp_raise_error, 1, cell)
 	{
@@ -536,16 +619,24 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(pp_hook_check_ref_args),
 	AMX_DECLARE_NATIVE(pp_public_min_index),
 	AMX_DECLARE_NATIVE(pp_use_funcidx),
+	AMX_DECLARE_NATIVE(pp_copy_on_write),
+	AMX_DECLARE_NATIVE(pp_intern_keys),
 	AMX_DECLARE_NATIVE(pp_tick),
 	AMX_DECLARE_NATIVE(pp_num_tasks),
 	AMX_DECLARE_NATIVE(pp_num_local_strings),
 	AMX_DECLARE_NATIVE(pp_num_global_strings),
+	AMX_DECLARE_NATIVE(pp_string_cache_hits),
+	AMX_DECLARE_NATIVE(pp_string_cache_misses),
+	AMX_DECLARE_NATIVE(pp_num_interned_arrays),
+	AMX_DECLARE_NATIVE(pp_collect_interned_arrays),
 	AMX_DECLARE_NATIVE(pp_num_local_variants),
 	AMX_DECLARE_NATIVE(pp_num_global_variants),
 	AMX_DECLARE_NATIVE(pp_num_lists),
 	AMX_DECLARE_NATIVE(pp_num_linked_lists),
 	AMX_DECLARE_NATIVE(pp_num_maps),
 	AMX_DECLARE_NATIVE(pp_num_pools),
+	AMX_DECLARE_NATIVE(pp_num_heaps),
+	AMX_DECLARE_NATIVE(pp_num_spatials),
 	AMX_DECLARE_NATIVE(pp_num_guards),
 	AMX_DECLARE_NATIVE(pp_num_amx_guards),
 	AMX_DECLARE_NATIVE(pp_num_local_iters),
@@ -559,9 +650,13 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(pp_entry),
 	AMX_DECLARE_NATIVE(pp_entry_s),
 	AMX_DECLARE_NATIVE(pp_collect),
+	AMX_DECLARE_NATIVE(pp_stats),
+	AMX_DECLARE_NATIVE(pp_stats_reset),
+	AMX_DECLARE_NATIVE(pp_stats_dump),
 	AMX_DECLARE_NATIVE(pp_num_natives),
 	AMX_DECLARE_NATIVE(pp_max_recursion),
 	AMX_DECLARE_NATIVE(pp_error_level),
+	AMX_DECLARE_NATIVE(pp_unload_cleanup),
 	AMX_DECLARE_NATIVE(pp_raise_error),
 	AMX_DECLARE_NATIVE(pp_module_name),
 	AMX_DECLARE_NATIVE(pp_module_name_s),
@@ -0,0 +1,386 @@
+#include "natives.h"
+#include "errors.h"
+#include "modules/containers.h"
+#include "modules/variants.h"
+
+template <size_t... Indices>
+class value_at
+{
+	using value_ftype = typename dyn_factory<Indices...>::type;
+	using result_ftype = typename dyn_result<Indices...>::type;
+
+public:
+	// native spatial_add(Spatial:spatial, Float:x, Float:y, Float:z, value, ...);
+	template <value_ftype Factory>
+	static cell AMX_NATIVE_CALL spatial_add(AMX *amx, cell *params)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		float pos[3] = {amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4])};
+		return static_cast<cell>(ptr->insert(pos, Factory(amx, params[Indices]...)));
+	}
+
+	// native spatial_get(Spatial:spatial, handle, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL spatial_get(AMX *amx, cell *params)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		const spatial_entry *entry = ptr->find(static_cast<ucell>(params[2]));
+		if(!entry) amx_LogicError(errors::element_not_present);
+		return Factory(amx, entry->value, params[Indices]...);
+	}
+};
+
+namespace Natives
+{
+	// native Spatial:spatial_new(Float:cell_size=50.0);
+	AMX_DEFINE_NATIVE_TAG(spatial_new, 1, spatial)
+	{
+		float cell_size = amx_ctof(params[1]);
+		if(!(cell_size > 0)) amx_LogicError(errors::out_of_range, "cell_size");
+		return spatial_pool.get_id(spatial_pool.emplace(cell_size));
+	}
+
+	// native bool:spatial_valid(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_valid, 1, bool)
+	{
+		spatial_t *ptr;
+		return spatial_pool.get_by_id(params[1], ptr);
+	}
+
+	// native spatial_delete(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_delete, 1, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		return spatial_pool.remove(ptr);
+	}
+
+	// native spatial_delete_deep(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_delete_deep, 1, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		spatial_t old(ptr->get_cell_size());
+		ptr->swap(old);
+		spatial_pool.remove(ptr);
+		old.for_each_object([](const dyn_object &obj)
+		{
+			obj.release();
+		});
+		return 1;
+	}
+
+	// native Spatial:spatial_clone(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_clone, 1, spatial)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		auto s = spatial_pool.emplace(*ptr);
+		s->for_each_value([](dyn_object &obj)
+		{
+			obj = obj.clone();
+		});
+		return spatial_pool.get_id(s);
+	}
+
+	// native spatial_size(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_size, 1, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		return static_cast<cell>(ptr->size());
+	}
+
+	// native Float:spatial_cell_size(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_cell_size, 1, float)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		float cell_size = ptr->get_cell_size();
+		return amx_ftoc(cell_size);
+	}
+
+	// native spatial_clear(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_clear, 1, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		ptr->clear();
+		return 1;
+	}
+
+	// native spatial_clear_deep(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_clear_deep, 1, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		spatial_t old(ptr->get_cell_size());
+		ptr->swap(old);
+		old.for_each_object([](const dyn_object &obj)
+		{
+			obj.release();
+		});
+		return 1;
+	}
+
+	// native spatial_add(Spatial:spatial, Float:x, Float:y, Float:z, AnyTag:value, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(spatial_add, 6, cell)
+	{
+		return value_at<5, 6>::spatial_add<dyn_func>(amx, params);
+	}
+
+	// native spatial_add_arr(Spatial:spatial, Float:x, Float:y, Float:z, const AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(spatial_add_arr, 7, cell)
+	{
+		return value_at<5, 6, 7>::spatial_add<dyn_func_arr>(amx, params);
+	}
+
+	// native spatial_add_str(Spatial:spatial, Float:x, Float:y, Float:z, const value[]);
+	AMX_DEFINE_NATIVE_TAG(spatial_add_str, 5, cell)
+	{
+		return value_at<5>::spatial_add<dyn_func_str>(amx, params);
+	}
+
+	// native spatial_add_str_s(Spatial:spatial, Float:x, Float:y, Float:z, ConstStringTag:value);
+	AMX_DEFINE_NATIVE_TAG(spatial_add_str_s, 5, cell)
+	{
+		return value_at<5>::spatial_add<dyn_func_str_s>(amx, params);
+	}
+
+	// native spatial_add_var(Spatial:spatial, Float:x, Float:y, Float:z, ConstVariantTag:value);
+	AMX_DEFINE_NATIVE_TAG(spatial_add_var, 5, cell)
+	{
+		return value_at<5>::spatial_add<dyn_func_var>(amx, params);
+	}
+
+	// native bool:spatial_move(Spatial:spatial, handle, Float:x, Float:y, Float:z);
+	AMX_DEFINE_NATIVE_TAG(spatial_move, 5, bool)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		float pos[3] = {amx_ctof(params[3]), amx_ctof(params[4]), amx_ctof(params[5])};
+		return ptr->move(static_cast<ucell>(params[2]), pos);
+	}
+
+	// native bool:spatial_get_pos(Spatial:spatial, handle, &Float:x, &Float:y, &Float:z);
+	AMX_DEFINE_NATIVE_TAG(spatial_get_pos, 5, bool)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		const spatial_entry *entry = ptr->find(static_cast<ucell>(params[2]));
+		if(!entry) return 0;
+		for(int i = 0; i < 3; i++)
+		{
+			float value = entry->pos[i];
+			*amx_GetAddrSafe(amx, params[3 + i]) = amx_ftoc(value);
+		}
+		return 1;
+	}
+
+	// native spatial_get(Spatial:spatial, handle, offset=0);
+	AMX_DEFINE_NATIVE(spatial_get, 3)
+	{
+		return value_at<3>::spatial_get<dyn_func>(amx, params);
+	}
+
+	// native spatial_get_arr(Spatial:spatial, handle, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(spatial_get_arr, 4, cell)
+	{
+		return value_at<3, 4>::spatial_get<dyn_func_arr>(amx, params);
+	}
+
+	// native String:spatial_get_str_s(Spatial:spatial, handle);
+	AMX_DEFINE_NATIVE_TAG(spatial_get_str_s, 2, string)
+	{
+		return value_at<>::spatial_get<dyn_func_str_s>(amx, params);
+	}
+
+	// native Variant:spatial_get_var(Spatial:spatial, handle);
+	AMX_DEFINE_NATIVE_TAG(spatial_get_var, 2, variant)
+	{
+		return value_at<>::spatial_get<dyn_func_var>(amx, params);
+	}
+
+	// native bool:spatial_contains(Spatial:spatial, handle);
+	AMX_DEFINE_NATIVE_TAG(spatial_contains, 2, bool)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		return ptr->find(static_cast<ucell>(params[2])) != nullptr;
+	}
+
+	// native bool:spatial_remove(Spatial:spatial, handle);
+	AMX_DEFINE_NATIVE_TAG(spatial_remove, 2, bool)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		return ptr->remove(static_cast<ucell>(params[2]));
+	}
+
+	// native bool:spatial_remove_deep(Spatial:spatial, handle);
+	AMX_DEFINE_NATIVE_TAG(spatial_remove_deep, 2, bool)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		size_t handle = static_cast<ucell>(params[2]);
+		if(!ptr->find(handle)) return 0;
+		ptr->extract(handle).release();
+		return 1;
+	}
+
+	// native spatial_query_radius(Spatial:spatial, Float:x, Float:y, Float:z, Float:radius, handles[], size=sizeof(handles));
+	AMX_DEFINE_NATIVE_TAG(spatial_query_radius, 7, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[7] < 0) amx_LogicError(errors::out_of_range, "size");
+		float center[3] = {amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4])};
+		cell *addr = amx_GetAddrSafe(amx, params[6]);
+		cell size = params[7], num = 0;
+		if(size > 0)
+		{
+			ptr->query_radius(center, amx_ctof(params[5]), [&](size_t handle)
+			{
+				addr[num++] = static_cast<cell>(handle);
+				return num < size;
+			});
+		}
+		return num;
+	}
+
+	// native spatial_query_radius_list(Spatial:spatial, Float:x, Float:y, Float:z, Float:radius, List:list);
+	AMX_DEFINE_NATIVE_TAG(spatial_query_radius_list, 6, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		list_t *list;
+		if(!list_pool.get_by_id(params[6], list)) amx_LogicError(errors::pointer_invalid, "list", params[6]);
+		float center[3] = {amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4])};
+		cell num = 0;
+		ptr->query_radius(center, amx_ctof(params[5]), [&](size_t handle)
+		{
+			list->push_back(ptr->find(handle)->value);
+			num++;
+			return true;
+		});
+		return num;
+	}
+
+	// native spatial_query_box(Spatial:spatial, Float:min_x, Float:min_y, Float:min_z, Float:max_x, Float:max_y, Float:max_z, handles[], size=sizeof(handles));
+	AMX_DEFINE_NATIVE_TAG(spatial_query_box, 9, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[9] < 0) amx_LogicError(errors::out_of_range, "size");
+		float min[3] = {amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4])};
+		float max[3] = {amx_ctof(params[5]), amx_ctof(params[6]), amx_ctof(params[7])};
+		cell *addr = amx_GetAddrSafe(amx, params[8]);
+		cell size = params[9], num = 0;
+		if(size > 0)
+		{
+			ptr->query_box(min, max, [&](size_t handle)
+			{
+				addr[num++] = static_cast<cell>(handle);
+				return num < size;
+			});
+		}
+		return num;
+	}
+
+	// native spatial_query_box_list(Spatial:spatial, Float:min_x, Float:min_y, Float:min_z, Float:max_x, Float:max_y, Float:max_z, List:list);
+	AMX_DEFINE_NATIVE_TAG(spatial_query_box_list, 8, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		list_t *list;
+		if(!list_pool.get_by_id(params[8], list)) amx_LogicError(errors::pointer_invalid, "list", params[8]);
+		float min[3] = {amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4])};
+		float max[3] = {amx_ctof(params[5]), amx_ctof(params[6]), amx_ctof(params[7])};
+		cell num = 0;
+		ptr->query_box(min, max, [&](size_t handle)
+		{
+			list->push_back(ptr->find(handle)->value);
+			num++;
+			return true;
+		});
+		return num;
+	}
+
+	// native spatial_nearest(Spatial:spatial, Float:x, Float:y, Float:z, handles[], count=sizeof(handles), Float:max_radius=-1.0);
+	AMX_DEFINE_NATIVE_TAG(spatial_nearest, 7, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[6] < 0) amx_LogicError(errors::out_of_range, "count");
+		float center[3] = {amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4])};
+		cell *addr = amx_GetAddrSafe(amx, params[5]);
+		std::vector<std::pair<float, size_t>> result;
+		ptr->nearest(center, params[6], amx_ctof(params[7]), result);
+		for(size_t i = 0; i < result.size(); i++)
+		{
+			addr[i] = static_cast<cell>(result[i].second);
+		}
+		return static_cast<cell>(result.size());
+	}
+
+	// native spatial_nearest_list(Spatial:spatial, Float:x, Float:y, Float:z, List:list, count, Float:max_radius=-1.0);
+	AMX_DEFINE_NATIVE_TAG(spatial_nearest_list, 7, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		list_t *list;
+		if(!list_pool.get_by_id(params[5], list)) amx_LogicError(errors::pointer_invalid, "list", params[5]);
+		if(params[6] < 0) amx_LogicError(errors::out_of_range, "count");
+		float center[3] = {amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4])};
+		std::vector<std::pair<float, size_t>> result;
+		ptr->nearest(center, params[6], amx_ctof(params[7]), result);
+		for(const auto &pair : result)
+		{
+			list->push_back(ptr->find(pair.second)->value);
+		}
+		return static_cast<cell>(result.size());
+	}
+}
+
+static AMX_NATIVE_INFO native_list[] =
+{
+	AMX_DECLARE_NATIVE(spatial_new),
+	AMX_DECLARE_NATIVE(spatial_valid),
+	AMX_DECLARE_NATIVE(spatial_delete),
+	AMX_DECLARE_NATIVE(spatial_delete_deep),
+	AMX_DECLARE_NATIVE(spatial_clone),
+	AMX_DECLARE_NATIVE(spatial_size),
+	AMX_DECLARE_NATIVE(spatial_cell_size),
+	AMX_DECLARE_NATIVE(spatial_clear),
+	AMX_DECLARE_NATIVE(spatial_clear_deep),
+
+	AMX_DECLARE_NATIVE(spatial_add),
+	AMX_DECLARE_NATIVE(spatial_add_arr),
+	AMX_DECLARE_NATIVE(spatial_add_str),
+	AMX_DECLARE_NATIVE(spatial_add_str_s),
+	AMX_DECLARE_NATIVE(spatial_add_var),
+	AMX_DECLARE_NATIVE(spatial_move),
+	AMX_DECLARE_NATIVE(spatial_get_pos),
+
+	AMX_DECLARE_NATIVE(spatial_get),
+	AMX_DECLARE_NATIVE(spatial_get_arr),
+	AMX_DECLARE_NATIVE(spatial_get_str_s),
+	AMX_DECLARE_NATIVE(spatial_get_var),
+	AMX_DECLARE_NATIVE(spatial_contains),
+	AMX_DECLARE_NATIVE(spatial_remove),
+	AMX_DECLARE_NATIVE(spatial_remove_deep),
+
+	AMX_DECLARE_NATIVE(spatial_query_radius),
+	AMX_DECLARE_NATIVE(spatial_query_radius_list),
+	AMX_DECLARE_NATIVE(spatial_query_box),
+	AMX_DECLARE_NATIVE(spatial_query_box_list),
+	AMX_DECLARE_NATIVE(spatial_nearest),
+	AMX_DECLARE_NATIVE(spatial_nearest_list),
+};
+
+int RegisterSpatialNatives(AMX *amx)
+{
+	return amx_Register(amx, native_list, sizeof(native_list) / sizeof(*native_list));
+}
@@ -140,6 +140,7 @@ namespace Natives
 	{
 		decltype(strings::pool)::ref_container *str;
 		if(!strings::pool.get_by_id(params[1], str)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(str->last_ref() && strings::is_interned(params[1], **str)) amx_LogicError(errors::cannot_release, "string", params[1]);
 		if(!strings::pool.release_ref(*str)) amx_LogicError(errors::cannot_release, "string", params[1]);
 		return params[1];
 	}
@@ -147,7 +148,10 @@ namespace Natives
 	// native str_delete(StringTag:str);
 	AMX_DEFINE_NATIVE_TAG(str_delete, 1, cell)
 	{
-		if(!strings::pool.remove_by_id(params[1])) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		decltype(strings::pool)::ref_container *str;
+		if(!strings::pool.get_by_id(params[1], str)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(strings::is_interned(params[1], **str)) amx_LogicError(errors::operation_not_supported, "string");
+		strings::pool.remove(*str);
 		return 1;
 	}
 
@@ -170,6 +174,24 @@ namespace Natives
 		return strings::pool.get_id(strings::pool.emplace(*str));
 	}
 
+	// native String:str_intern(ConstStringTag:str);
+	AMX_DEFINE_NATIVE_TAG(str_intern, 1, string)
+	{
+		cell_string *str;
+		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(str == nullptr)
+		{
+			return strings::intern(cell_string());
+		}
+		return strings::intern(*str);
+	}
+
+	// native bool:str_unintern(ConstStringTag:str);
+	AMX_DEFINE_NATIVE_TAG(str_unintern, 1, bool)
+	{
+		return strings::unintern(params[1]);
+	}
+
 
 	// native String:str_cat(StringTag:str1, StringTag:str2);
 	AMX_DEFINE_NATIVE_TAG(str_cat, 2, string)
@@ -1370,6 +1392,8 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(str_delete),
 	AMX_DECLARE_NATIVE(str_valid),
 	AMX_DECLARE_NATIVE(str_clone),
+	AMX_DECLARE_NATIVE(str_intern),
+	AMX_DECLARE_NATIVE(str_unintern),
 
 	AMX_DECLARE_NATIVE(str_len),
 	AMX_DECLARE_NATIVE(str_get),
@@ -10,13 +10,17 @@
 #include <type_traits>
 #include <algorithm>
 #include <functional>
+#include <unordered_map>
+
+bool dyn_object::copy_on_write = false;
+bool dyn_object::intern_keys = false;
 
 bool memequal(void const* ptr1, void const* ptr2, size_t size)
 {
 	return !std::memcmp(ptr1, ptr2, size);
 }
 
-dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell tag_id) : rank(1), tag(tags::find_tag(amx, tag_id))
+dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell tag_id) : rank(1), inline_array(false), tag(tags::find_tag(amx, tag_id))
 {
 	if(size < 0)
 	{
@@ -24,13 +28,13 @@ dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell tag_id) : rank
 	}
 	if(arr != nullptr)
 	{
-		array_data = new cell[size + 2];
-		std::memcpy(array_data + 1, arr, size * sizeof(cell));
-		array_data[size + 1] = 0;
+		set_array(allocate(size + 2));
+		std::memcpy(array_data() + 1, arr, size * sizeof(cell));
+		array_data()[size + 1] = 0;
 	}else{
-		array_data = new cell[size + 2]();
+		set_array(allocate_zero(size + 2));
 	}
-	array_data[0] = size + 1;
+	array_data()[0] = size + 1;
 	init_op();
 }
 
@@ -72,7 +76,7 @@ dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, cell ta
 
 }
 
-dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, tag_ptr tag) : rank(2), tag(tag)
+dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, tag_ptr tag) : rank(2), inline_array(false), tag(tag)
 {
 	if(size < 0)
 	{
@@ -100,18 +104,18 @@ dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, tag_ptr
 			find_array_end(amx, last);
 		}
 		cell length = last - arr;
-		array_data = new cell[length + 2];
-		std::memcpy(array_data + 1, arr, length * sizeof(cell));
-		array_data[length + 1] = 0;
-		array_data[0] = length + 1;
+		set_array(allocate(length + 2));
+		std::memcpy(array_data() + 1, arr, length * sizeof(cell));
+		array_data()[length + 1] = 0;
+		array_data()[0] = length + 1;
 	}else{
 		cell length = size + size * size2;
-		array_data = new cell[length + 2]();
+		set_array(allocate_zero(length + 2));
 		for(cell i = 0; i < size; i++)
 		{
-			array_data[1 + i] = (size + i * size2 - i) * sizeof(cell);
+			array_data()[1 + i] = (size + i * size2 - i) * sizeof(cell);
 		}
-		array_data[0] = length + 1;
+		array_data()[0] = length + 1;
 	}
 	init_op();
 }
@@ -121,7 +125,7 @@ dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, cell si
 
 }
 
-dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, cell size3, tag_ptr tag) : rank(3), tag(tag)
+dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, cell size3, tag_ptr tag) : rank(3), inline_array(false), tag(tag)
 {
 	if(size < 0)
 	{
@@ -149,32 +153,35 @@ dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, cell si
 			find_array_end(amx, last);
 		}
 		cell length = last - arr;
-		array_data = new cell[length + 2];
-		std::memcpy(array_data + 1, arr, length * sizeof(cell));
-		array_data[length + 1] = 0;
-		array_data[0] = length + 1;
+		set_array(allocate(length + 2));
+		std::memcpy(array_data() + 1, arr, length * sizeof(cell));
+		array_data()[length + 1] = 0;
+		array_data()[0] = length + 1;
 	}else{
 		cell length = size + size * size2 + size * size2 * size3;
-		array_data = new cell[length + 2]();
+		set_array(allocate_zero(length + 2));
 		for(cell i = 0; i < size; i++)
 		{
-			array_data[1 + i] = (size + i * size2 - i) * sizeof(cell);
+			array_data()[1 + i] = (size + i * size2 - i) * sizeof(cell);
 			for(cell j = 0; j < size2; j++)
 			{
 				cell ofs = size + i * size + j;
-				array_data[1 + ofs] = (size + size * size2 + i * size2 * size3 + j * size2 - ofs) * sizeof(cell);
+				array_data()[1 + ofs] = (size + size * size2 + i * size2 * size3 + j * size2 - ofs) * sizeof(cell);
 			}
 		}
-		array_data[0] = length + 1;
+		array_data()[0] = length + 1;
 	}
 	init_op();
 }
 
-dyn_object::dyn_object(const cell *str) : rank(1), tag(tags::find_tag(tags::tag_char))
+dyn_object::dyn_object(const cell *str) : rank(1), inline_array(false), tag(tags::find_tag(tags::tag_char))
 {
 	if(str == nullptr || !str[0])
 	{
-		array_data = new cell[3]{2, 0, 0};
+		set_array(allocate(3));
+		array_data()[0] = 2;
+		array_data()[1] = 0;
+		array_data()[2] = 0;
 		return;
 	}
 	int len;
@@ -186,14 +193,14 @@ dyn_object::dyn_object(const cell *str) : rank(1), tag(tags::find_tag(tags::tag_
 	}else{
 		size = len;
 	}
-	array_data = new cell[size + 3];
-	array_data[0] = size + 2;
-	std::memcpy(array_data + 1, str, size * sizeof(cell));
-	array_data[size + 2] = 0;
-	array_data[size + 1] = 0;
+	set_array(allocate(size + 3));
+	array_data()[0] = size + 2;
+	std::memcpy(array_data() + 1, str, size * sizeof(cell));
+	array_data()[size + 2] = 0;
+	array_data()[size + 1] = 0;
 }
 
-dyn_object::dyn_object(cell value, tag_ptr tag, bool assign) noexcept : rank(0), cell_value(value), tag(tag)
+dyn_object::dyn_object(cell value, tag_ptr tag, bool assign) noexcept : rank(0), inline_array(false), cell_value(value), tag(tag)
 {
 	if(assign)
 	{
@@ -201,32 +208,36 @@ dyn_object::dyn_object(cell value, tag_ptr tag, bool assign) noexcept : rank(0),
 	}
 }
 
-dyn_object::dyn_object(const cell *arr, cell size, tag_ptr tag) : rank(1), tag(tag)
+dyn_object::dyn_object(const cell *arr, cell size, tag_ptr tag) : rank(1), inline_array(false), tag(tag)
 {
 	if(arr != nullptr)
 	{
-		array_data = new cell[size + 2];
-		std::memcpy(array_data + 1, arr, size * sizeof(cell));
-		array_data[size + 1] = 0;
+		set_array(allocate(size + 2));
+		std::memcpy(array_data() + 1, arr, size * sizeof(cell));
+		array_data()[size + 1] = 0;
 	}else{
-		array_data = new cell[size + 2]();
+		set_array(allocate_zero(size + 2));
 	}
-	array_data[0] = size + 1;
+	array_data()[0] = size + 1;
 	init_op();
 }
 
-dyn_object::dyn_object(const dyn_object &obj, bool assign) : rank(obj.rank), tag(obj.tag)
+dyn_object::dyn_object(const dyn_object &obj, bool assign) : rank(obj.rank), inline_array(false), tag(obj.tag)
 {
 	if(rank > 0)
 	{
-		if(obj.array_data != nullptr)
+		if(obj.array_data() != nullptr)
 		{
+			if(share_array(obj, assign))
+			{
+				return;
+			}
 			cell size = obj.data_size();
-			array_data = new cell[size + 1];
-			std::memcpy(array_data, obj.array_data, size * sizeof(cell));
-			array_data[size] = 0;
+			set_array(allocate(size + 1));
+			std::memcpy(array_data(), obj.array_data(), size * sizeof(cell));
+			array_data()[size] = 0;
 		}else{
-			array_data = nullptr;
+			set_array(nullptr);
 		}
 	}else{
 		cell_value = obj.cell_value;
@@ -237,6 +248,34 @@ dyn_object::dyn_object(const dyn_object &obj, bool assign) : rank(obj.rank), tag
 	}
 }
 
+bool dyn_object::share_array(const dyn_object &obj, bool assign)
+{
+	// the payload can be shared only if copying it would not change its cells
+	if(obj.inline_array || (!copy_on_write && header(obj.array_data()).interned == nullptr) || (assign && obj.tag->get_ops().assign(obj.tag, nullptr, 0)))
+	{
+		return false;
+	}
+	header(obj.array_data()).refs.fetch_add(1, std::memory_order_relaxed);
+	set_array(obj.array_ptr);
+	return true;
+}
+
+void dyn_object::unshare()
+{
+	// interned arrays are always referenced by the intern table too
+	if(is_array() && !inline_array && header(array_ptr).refs.load(std::memory_order_acquire) > 1)
+	{
+		// the inline buffer overlaps the pointer
+		cell *old = array_ptr;
+		cell size = data_size();
+		cell *data = allocate(size + 1);
+		std::memcpy(data, old, size * sizeof(cell));
+		data[size] = 0;
+		deallocate(old);
+		set_array(data);
+	}
+}
+
 bool dyn_object::tag_assignable(tag_ptr test_tag) const noexcept
 {
 	if(test_tag->uid == tags::tag_cell)
@@ -253,7 +292,7 @@ cell dyn_object::data_size() const
 		case 0:
 			return 1;
 		default:
-			return array_data == nullptr ? 0 : array_data[0];
+			return array_data() == nullptr ? 0 : array_data()[0];
 	}
 }
 
@@ -263,14 +302,14 @@ cell dyn_object::array_start() const
 	{
 		return 0;
 	}else{
-		cell *b = array_data + 1;
+		const cell *b = array_data() + 1;
 		auto dim = rank;
 		while(dim > 1)
 		{
-			b = (cell*)((char*)b + *b);
+			b = (const cell*)((const char*)b + *b);
 			dim--;
 		}
-		return b - array_data;
+		return b - array_data();
 	}
 }
 
@@ -321,6 +360,7 @@ void dyn_object::set_cell(const cell *indices, cell num_indices, cell value)
 
 cell *dyn_object::get_array(const cell *indices, cell num_indices, cell &size)
 {
+	unshare();
 	return const_cast<cell*>(static_cast<const dyn_object*>(this)->get_array(indices, num_indices, size));
 }
 
@@ -354,7 +394,7 @@ const cell *dyn_object::get_array(const cell *indices, cell num_indices, cell &s
 			}
 		}
 
-		block = array_data + 1;
+		block = array_data() + 1;
 		cell data_begin = this->begin() - block, data_end = this->end() - block;
 		begin = 0;
 		end = rank >= 2 ? block[0] / sizeof(cell) : data_end;
@@ -410,6 +450,7 @@ cell dyn_object::get_array(const cell *indices, cell num_indices, cell *arr, cel
 
 cell *dyn_object::get_cell_addr(const cell *indices, cell num_indices)
 {
+	unshare();
 	return const_cast<cell*>(static_cast<const dyn_object*>(this)->get_cell_addr(indices, num_indices));
 }
 
@@ -427,7 +468,7 @@ const cell *dyn_object::get_cell_addr(const cell *indices, cell num_indices) con
 		return nullptr;
 	}
 
-	const cell *block = array_data + 1;
+	const cell *block = array_data() + 1;
 	cell data_begin = begin() - block, data_end = end() - block;
 	cell begin = 0, end = rank >= 2 ? block[0] / sizeof(cell) : data_end;
 	for(cell i = 0; i < num_indices; i++)
@@ -499,7 +540,7 @@ cell dyn_object::store(AMX *amx) const
 		cell size = data_size() - 1;
 		cell amx_addr, *addr;
 		amx_AllotSafe(amx, size, &amx_addr, &addr);
-		std::memcpy(addr, array_data + 1, size * sizeof(cell));
+		std::memcpy(addr, array_data() + 1, size * sizeof(cell));
 
 		cell begin = array_start() - 1;
 		assign_op(addr + begin, size - begin);
@@ -511,9 +552,10 @@ void dyn_object::load(AMX *amx, cell amx_addr)
 {
 	if(is_array())
 	{
+		unshare();
 		cell size = data_size() - 1;
 		cell *addr = amx_GetAddrSafe(amx, amx_addr);
-		std::memcpy(array_data + 1, addr, size * sizeof(cell));
+		std::memcpy(array_data() + 1, addr, size * sizeof(cell));
 
 		assign_op();
 	}
@@ -521,31 +563,34 @@ void dyn_object::load(AMX *amx, cell amx_addr)
 
 cell *dyn_object::begin()
 {
+	unshare();
 	if(is_cell())
 	{
 		return &cell_value;
 	}else{
-		return &array_data[array_start()];
+		return &array_data()[array_start()];
 	}
 }
 
 cell *dyn_object::end()
 {
+	unshare();
 	if(is_cell())
 	{
 		return &cell_value + 1;
 	}else{
-		return array_data + data_size();
+		return array_data() + data_size();
 	}
 }
 
 cell *dyn_object::data_begin()
 {
+	unshare();
 	if(is_cell())
 	{
 		return &cell_value;
 	}else{
-		return array_data + 1;
+		return array_data() + 1;
 	}
 }
 
@@ -555,7 +600,7 @@ const cell *dyn_object::begin() const
 	{
 		return &cell_value;
 	}else{
-		return &array_data[array_start()];
+		return &array_data()[array_start()];
 	}
 }
 
@@ -565,7 +610,7 @@ const cell *dyn_object::end() const
 	{
 		return &cell_value + 1;
 	}else{
-		return array_data + data_size();
+		return array_data() + data_size();
 	}
 }
 
@@ -575,7 +620,7 @@ const cell *dyn_object::data_begin() const
 	{
 		return &cell_value;
 	}else{
-		return array_data + 1;
+		return array_data() + 1;
 	}
 }
 
@@ -609,7 +654,7 @@ cell dyn_object::get_size(const cell *indices, cell num_indices) const
 		}
 	}
 
-	const cell *block = array_data + 1;
+	const cell *block = array_data() + 1;
 	cell data_begin = begin() - block, data_end = end() - block;
 	cell begin = 0, end = rank >= 2 ? block[0] / sizeof(cell) : data_end;
 	bool cells = false;
@@ -641,8 +686,66 @@ inline void hash_combine(size_t& seed, const T& v)
 	seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
+static tag_ptr default_cell_tag()
+{
+	static tag_ptr tag = tags::find_tag(tags::tag_cell);
+	return tag;
+}
+
+size_t dyn_object::cell_hash(cell value)
+{
+	size_t hash = 0;
+	hash_combine(hash, std::hash<cell>()(value));
+	hash_combine(hash, default_cell_tag());
+	return hash;
+}
+
+bool dyn_object::equals_cell(cell value) const
+{
+	return rank == 0 && cell_value == value && (tag == default_cell_tag() || tag->same_base(default_cell_tag()));
+}
+
+static tag_ptr default_char_tag()
+{
+	static tag_ptr tag = tags::find_tag(tags::tag_char);
+	return tag;
+}
+
+size_t dyn_object::str_hash(const cell *str, cell size)
+{
+	size_t hash = 0;
+	for(cell i = 0; i < size; i++)
+	{
+		hash_combine(hash, std::hash<cell>()(str[i]));
+	}
+	hash_combine(hash, std::hash<cell>()(0));
+	hash_combine(hash, default_char_tag());
+	return hash;
+}
+
+bool dyn_object::equals_str(const cell *str, cell size) const
+{
+	if(rank != 1 || array_data() == nullptr || array_data()[0] != size + 2 || array_data()[size + 1] != 0)
+	{
+		return false;
+	}
+	if(tag != default_char_tag() && !tag->same_base(default_char_tag()))
+	{
+		return false;
+	}
+	return !std::memcmp(array_data() + 1, str, size * sizeof(cell));
+}
+
 size_t dyn_object::get_hash() const
 {
+	if(rank == 0 && tag == default_cell_tag())
+	{
+		return cell_hash(cell_value);
+	}
+	if(is_interned_payload())
+	{
+		return header(array_data()).hash;
+	}
 	size_t hash = 0;
 	if(empty()) return 0;
 
@@ -719,6 +822,87 @@ dyn_object dyn_object::clone() const
 	return copy;
 }
 
+// Interned arrays by their hash; the table holds a reference to each of them
+static std::unordered_multimap<size_t, cell*> &interned_arrays()
+{
+	static std::unordered_multimap<size_t, cell*> table;
+	return table;
+}
+
+// The table is swept for unused arrays whenever it doubles in size
+static constexpr size_t interned_min_limit = 256;
+
+static size_t &interned_limit()
+{
+	static size_t limit = interned_min_limit;
+	return limit;
+}
+
+void dyn_object::intern()
+{
+	if(!is_array() || is_interned_payload() || tag->get_ops().assign(tag, nullptr, 0))
+	{
+		return;
+	}
+	size_t hash = get_hash();
+	cell size = data_size();
+	auto &table = interned_arrays();
+	auto range = table.equal_range(hash);
+	for(auto it = range.first; it != range.second; ++it)
+	{
+		cell *data = it->second;
+		if(header(data).interned == tag && header(data).rank == rank && data[0] == size && memequal(data, array_data(), size * sizeof(cell)))
+		{
+			header(data).refs.fetch_add(1, std::memory_order_relaxed);
+			deallocate(array_data());
+			set_array(data);
+			return;
+		}
+	}
+	if(table.size() >= interned_limit())
+	{
+		collect_interned();
+		interned_limit() = std::max(table.size() * 2, interned_min_limit);
+	}
+	cell *data = allocate_heap(size + 1);
+	std::memcpy(data, array_data(), size * sizeof(cell));
+	data[size] = 0;
+	auto &h = header(data);
+	h.interned = tag;
+	h.rank = rank;
+	h.hash = hash;
+	h.refs.fetch_add(1, std::memory_order_relaxed);
+	table.emplace(hash, data);
+	deallocate(array_data());
+	set_array(data);
+}
+
+size_t dyn_object::num_interned()
+{
+	return interned_arrays().size();
+}
+
+size_t dyn_object::collect_interned()
+{
+	auto &table = interned_arrays();
+	size_t count = 0;
+	for(auto it = table.begin(); it != table.end();)
+	{
+		auto &h = header(it->second);
+		// the reference held by the table is the last one
+		if(h.refs.load(std::memory_order_acquire) == 1)
+		{
+			h.~payload_header();
+			::operator delete(&h);
+			it = table.erase(it);
+			count++;
+		}else{
+			++it;
+		}
+	}
+	return count;
+}
+
 dyn_object dyn_object::call_op(op_type type, cell *args, size_t numargs, bool wrap) const
 {
 	dyn_object result = dyn_object(*this, false);
@@ -771,17 +955,17 @@ bool dyn_object::assign_op(cell *start, cell size) const
 	return ops.assign(tag, start, size);
 }
 
-bool dyn_object::collect_op()
+bool dyn_object::collect_op() const
 {
 	if(!empty())
 	{
-		cell *begin = this->begin();
+		const cell *begin = this->begin();
 		return collect_op(begin, end() - begin);
 	}
 	return false;
 }
 
-bool dyn_object::collect_op(cell *start, cell size) const
+bool dyn_object::collect_op(const cell *start, cell size) const
 {
 	const auto &ops = tag->get_ops();
 	return ops.collect(tag, start, size);
@@ -796,13 +980,28 @@ bool dyn_object::struct_compatible(const dyn_object &obj) const noexcept
 	{
 		cell ofs = array_start();
 		if(ofs != obj.array_start()) return false;
-		if(!memequal(array_data, obj.array_data, ofs * sizeof(cell))) return false;
+		if(!memequal(array_data(), obj.array_data(), ofs * sizeof(cell))) return false;
 	}
 	return true;
 }
 
+static bool bitwise_equality(tag_ptr tag)
+{
+	return tag->uid == tags::tag_cell || tag->uid == tags::tag_char;
+}
+
 bool dyn_object::operator==(const dyn_object &obj) const noexcept
 {
+	if(rank == 0 && obj.rank == 0 && tag == obj.tag && tag == default_cell_tag())
+	{
+		return cell_value == obj.cell_value;
+	}
+	if(tag == obj.tag && is_interned_payload() && obj.is_interned_payload())
+	{
+		// equal interned arrays share the same payload
+		if(array_data() == obj.array_data()) return true;
+		if(bitwise_equality(tag)) return false;
+	}
 	if(!tag_compatible(obj) || !struct_compatible(obj)) return false;
 	if(empty()) return true;
 	const cell *begin1 = begin();
@@ -820,6 +1019,15 @@ bool dyn_object::operator==(const dyn_object &obj) const noexcept
 
 bool dyn_object::operator!=(const dyn_object &obj) const noexcept
 {
+	if(rank == 0 && obj.rank == 0 && tag == obj.tag && tag == default_cell_tag())
+	{
+		return cell_value != obj.cell_value;
+	}
+	if(tag == obj.tag && is_interned_payload() && obj.is_interned_payload())
+	{
+		if(array_data() == obj.array_data()) return false;
+		if(bitwise_equality(tag)) return true;
+	}
 	if(!tag_compatible(obj) || !struct_compatible(obj)) return true;
 	if(empty()) return false;
 	const cell *begin1 = begin();
@@ -837,6 +1045,10 @@ bool dyn_object::operator!=(const dyn_object &obj) const noexcept
 
 bool dyn_object::operator<(const dyn_object &obj) const noexcept
 {
+	if(rank == 0 && obj.rank == 0 && tag == obj.tag && tag == default_cell_tag())
+	{
+		return cell_value < obj.cell_value;
+	}
 	cell this_tag = tag->find_top_base()->uid;
 	cell obj_tag = obj.tag->find_top_base()->uid;
 	if(this_tag < obj_tag) return true;
@@ -1193,22 +1405,27 @@ dyn_object &dyn_object::operator=(const dyn_object &obj)
 	collect_op();
 	if(is_array())
 	{
-		delete[] array_data;
+		deallocate(array_data());
 	}
 	rank = obj.rank;
 	tag = obj.tag;
 	if(rank > 0)
 	{
-		if(obj.array_data != nullptr)
+		if(obj.array_data() != nullptr)
 		{
+			if(share_array(obj, true))
+			{
+				return *this;
+			}
 			cell size = obj.data_size();
-			array_data = new cell[size + 1];
-			std::memcpy(array_data, obj.array_data, size * sizeof(cell));
-			array_data[size] = 0;
+			set_array(allocate(size + 1));
+			std::memcpy(array_data(), obj.array_data(), size * sizeof(cell));
+			array_data()[size] = 0;
 		}else{
-			array_data = nullptr;
+			set_array(nullptr);
 		}
 	}else{
+		inline_array = false;
 		cell_value = obj.cell_value;
 	}
 	assign_op();
@@ -1221,17 +1438,19 @@ dyn_object &dyn_object::operator=(dyn_object &&obj) noexcept
 	collect_op();
 	if(is_array())
 	{
-		delete[] array_data;
+		deallocate(array_data());
 	}
 	rank = obj.rank;
 	tag = obj.tag;
 	if(rank > 0)
 	{
-		array_data = obj.array_data;
+		take_array(obj);
 	}else{
+		inline_array = false;
 		cell_value = obj.cell_value;
 	}
-	obj.array_data = nullptr;
+	obj.inline_array = false;
+	obj.array_ptr = nullptr;
 	obj.rank = 1;
 	return *this;
 }
@@ -1240,26 +1459,29 @@ void dyn_object::swap(dyn_object &other) noexcept
 {
 	if(this != &other)
 	{
-		if(is_cell())
+		// inline arrays have to be moved along with the objects
+		dyn_object tmp(std::move(other));
+		other.rank = rank;
+		other.tag = tag;
+		if(rank > 0)
 		{
-			if(other.is_cell())
-			{
-				std::swap(cell_value, other.cell_value);
-			}else{
-				cell c = cell_value;
-				array_data = other.array_data;
-				other.cell_value = c;
-			}
-		}else if(other.is_cell())
+			other.take_array(*this);
+		}else{
+			other.inline_array = false;
+			other.cell_value = cell_value;
+		}
+		rank = tmp.rank;
+		tag = tmp.tag;
+		if(rank > 0)
 		{
-			cell c = other.cell_value;
-			other.array_data = array_data;
-			cell_value = c;
+			take_array(tmp);
 		}else{
-			std::swap(array_data, other.array_data);
+			inline_array = false;
+			cell_value = tmp.cell_value;
 		}
-		std::swap(rank, other.rank);
-		std::swap(tag, other.tag);
+		tmp.inline_array = false;
+		tmp.array_ptr = nullptr;
+		tmp.rank = 1;
 	}
 }
 
@@ -1269,17 +1491,26 @@ dyn_object::~dyn_object()
 	{
 		if(is_array())
 		{
-			cell *begin = this->begin();
-			cell *end = this->end();
-			cell *data = array_data;
+			// the inline buffer overlaps the pointer that is cleared
+			cell buffer[inline_size];
+			const dyn_object &self = *this;
+			const cell *begin = self.begin();
+			const cell *end = self.end();
+			cell *data = array_data();
+			if(inline_array)
+			{
+				std::memcpy(buffer, inline_data, sizeof(buffer));
+				begin = buffer + (begin - inline_data);
+				end = buffer + (end - inline_data);
+			}
 			rank = 1;
-			array_data = nullptr;
+			set_array(nullptr);
 			collect_op(begin, end - begin);
-			delete[] data;
+			deallocate(data);
 		}else{
 			cell value = cell_value;
 			rank = 1;
-			array_data = nullptr;
+			set_array(nullptr);
 			collect_op(&value, 1);
 		}
 	}
@@ -6,23 +6,31 @@
 #include <memory>
 #include <string>
 #include <cstring>
+#include <atomic>
+#include <new>
 
 class dyn_object
 {
+	// arrays up to this many cells (including the size and the terminator) are stored inline,
+	// in the space of the array pointer; that fits empty arrays on 64-bit targets and none on 32-bit
+	static constexpr cell inline_size = sizeof(cell*) / sizeof(cell);
+
 	unsigned char rank;
+	bool inline_array;
 	union{
 		cell cell_value;
-		cell *array_data;
+		cell *array_ptr;
+		cell inline_data[inline_size];
 	};
 	tag_ptr tag;
 
 public:
-	dyn_object() noexcept : rank(1), array_data(nullptr), tag(tags::find_tag(tags::tag_cell))
+	dyn_object() noexcept : rank(1), inline_array(false), array_ptr(nullptr), tag(tags::find_tag(tags::tag_cell))
 	{
 
 	}
 
-	dyn_object(AMX *amx, cell value, cell tag_id) noexcept : rank(0), cell_value(value), tag(tags::find_tag(amx, tag_id))
+	dyn_object(AMX *amx, cell value, cell tag_id) noexcept : rank(0), inline_array(false), cell_value(value), tag(tags::find_tag(amx, tag_id))
 	{
 		init_op();
 	}
@@ -51,15 +59,21 @@ public:
 		tag = new_tag;
 	}
 
-	dyn_object(dyn_object &&obj) noexcept : rank(obj.rank), tag(obj.tag)
+	// When enabled, copies share array payloads until one of them is modified
+	static bool copy_on_write;
+	// When enabled, array keys stored in maps are interned
+	static bool intern_keys;
+
+	dyn_object(dyn_object &&obj) noexcept : rank(obj.rank), inline_array(false), tag(obj.tag)
 	{
 		if(rank > 0)
 		{
-			array_data = obj.array_data;
+			take_array(obj);
 		}else{
 			cell_value = obj.cell_value;
 		}
-		obj.array_data = nullptr;
+		obj.inline_array = false;
+		obj.array_ptr = nullptr;
 		obj.rank = 1;
 	}
 
@@ -69,6 +83,7 @@ public:
 	void set_cell(const cell *indices, cell num_indices, cell value);
 	cell set_cells(const cell *indices, cell num_indices, const cell *values, cell size);
 	cell get_array(const cell *indices, cell num_indices, cell *arr, cell maxsize) const;
+	// mutable access unshares a copied payload, so read-only code should use the const overloads
 	cell *get_array(const cell *indices, cell num_indices, cell &size);
 	const cell *get_array(const cell *indices, cell num_indices, cell &size) const;
 	cell *get_cell_addr(const cell *indices, cell num_indices);
@@ -84,6 +99,16 @@ public:
 	void release() const;
 	std::weak_ptr<const void> handle() const;
 	dyn_object clone() const;
+	void intern();
+	static size_t num_interned();
+	// Frees interned arrays which are no longer used by any object
+	static size_t collect_interned();
+	// Same as the hash and equality of a single cell with the default cell tag
+	static size_t cell_hash(cell value);
+	bool equals_cell(cell value) const;
+	// Same as the hash and equality of a string of the given cells followed by a null
+	static size_t str_hash(const cell *str, cell size);
+	bool equals_str(const cell *str, cell size) const;
 	dyn_object call_op(op_type type, cell *args, size_t numargs, bool wrap) const;
 
 	bool tag_assignable(AMX *amx, cell tag_id) const
@@ -133,17 +158,17 @@ public:
 
 	bool empty() const
 	{
-		return rank > 0 ? array_data == nullptr || *array_data <= 1 : false;
+		return rank > 0 ? array_data() == nullptr || *array_data() <= 1 : false;
 	}
 
 	bool is_null() const
 	{
-		return rank > 0 && array_data == nullptr;
+		return rank > 0 && array_data() == nullptr;
 	}
 
 	bool is_array() const
 	{
-		return rank > 0 && array_data != nullptr;
+		return rank > 0 && array_data() != nullptr;
 	}
 
 	bool is_cell() const
@@ -151,6 +176,16 @@ public:
 		return rank == 0;
 	}
 
+	// Bytes held by the array outside of the object
+	size_t heap_size() const
+	{
+		if(is_array() && !inline_array)
+		{
+			return sizeof(payload_header) + (data_size() + 1) * sizeof(cell);
+		}
+		return 0;
+	}
+
 	cell get_rank() const
 	{
 		return is_null() ? -1 : static_cast<cell>(rank);
@@ -209,14 +244,107 @@ public:
 	~dyn_object();
 
 private:
+	// Arrays outside the object are preceded by a header
+	struct payload_header
+	{
+		std::atomic<cell> refs;
+		// interned arrays are immutable and have their hash computed for this tag and rank
+		tag_ptr interned;
+		cell rank;
+		size_t hash;
+	};
+
+	cell *allocate(cell size)
+	{
+		if(size <= inline_size)
+		{
+			return inline_data;
+		}
+		return allocate_heap(size);
+	}
+
+	cell *allocate_zero(cell size)
+	{
+		cell *data = allocate(size);
+		std::memset(data, 0, size * sizeof(cell));
+		return data;
+	}
+
+	static cell *allocate_heap(cell size)
+	{
+		char *block = static_cast<char*>(::operator new(sizeof(payload_header) + size * sizeof(cell)));
+		auto header = new (block) payload_header();
+		header->refs.store(1, std::memory_order_relaxed);
+		header->interned = nullptr;
+		header->rank = 0;
+		header->hash = 0;
+		return reinterpret_cast<cell*>(block + sizeof(payload_header));
+	}
+
+	static payload_header &header(const cell *data) noexcept
+	{
+		return *reinterpret_cast<payload_header*>(reinterpret_cast<char*>(const_cast<cell*>(data)) - sizeof(payload_header));
+	}
+
+	cell *array_data() noexcept
+	{
+		return inline_array ? inline_data : array_ptr;
+	}
+
+	const cell *array_data() const noexcept
+	{
+		return inline_array ? inline_data : array_ptr;
+	}
+
+	void set_array(cell *data) noexcept
+	{
+		inline_array = data == inline_data;
+		if(!inline_array)
+		{
+			array_ptr = data;
+		}
+	}
+
+	void deallocate(cell *data) noexcept
+	{
+		if(data != inline_data)
+		{
+			auto &h = header(data);
+			if(h.refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				h.~payload_header();
+				::operator delete(&h);
+			}
+		}
+	}
+
+	bool is_interned_payload() const
+	{
+		return is_array() && !inline_array && header(array_data()).interned == tag && header(array_data()).rank == rank;
+	}
+
+	bool share_array(const dyn_object &obj, bool assign);
+	void unshare();
+
+	void take_array(dyn_object &obj) noexcept
+	{
+		if(obj.inline_array)
+		{
+			std::memcpy(inline_data, obj.inline_data, sizeof(inline_data));
+			set_array(inline_data);
+		}else{
+			set_array(obj.array_data());
+		}
+	}
+
 	dyn_object(cell value, tag_ptr tag, bool assign) noexcept;
 	dyn_object(const dyn_object &obj, bool assign);
 	bool init_op();
 	bool init_op(cell *start, cell size) const;
 	bool assign_op();
 	bool assign_op(cell *start, cell size) const;
-	bool collect_op();
-	bool collect_op(cell *start, cell size) const;
+	bool collect_op() const;
+	bool collect_op(const cell *start, cell size) const;
 	template <cell(tag_operations::*OpFunc)(tag_ptr, cell, cell) const>
 	dyn_object operator_func(const dyn_object &obj) const;
 	template <cell(tag_operations::*OpFunc)(tag_ptr, cell) const>
@@ -229,6 +357,9 @@ private:
 	bool operator_log_func(const dyn_object &obj) const;
 };
 
+// the inline buffer is no larger than the array pointer, so values keep the original layout (12 bytes on 32-bit targets)
+static_assert(sizeof(dyn_object) <= 3 * sizeof(void*), "dyn_object must not grow beyond the original layout");
+
 namespace std
 {
 	template<>
@@ -3,6 +3,11 @@
 
 #include "main.h"
 #include "utils/shared_id_set_pool.h"
+#include "utils/handle_table.h"
+#include "utils/slab_allocator.h"
+#include "utils/owner_list.h"
+#include "utils/direct_cache.h"
+#include "utils/pool_stats.h"
 #include "sdk/amx/amx.h"
 #include <vector>
 #include <unordered_map>
@@ -17,6 +22,13 @@ public:
 	{
 		ObjType object;
 		unsigned int ref_count = 0;
+		cell pool_handle = 0;
+		size_t region_index = 0;
+		bool addressed = false;
+		size_t cache_slot = 0;
+		aux::owner_link<ref_container_simple> pool_owner;
+
+		friend class object_pool;
 
 	public:
 		ref_container_simple()
@@ -120,11 +132,23 @@ public:
 		{
 			return ref_count == 0;
 		}
+
+		bool last_ref() const
+		{
+			return ref_count == 1;
+		}
 	};
 
 	class ref_container_virtual
 	{
 		unsigned int ref_count = 0;
+		cell pool_handle = 0;
+		size_t region_index = 0;
+		bool addressed = false;
+		size_t cache_slot = 0;
+		aux::owner_link<ref_container_virtual> pool_owner;
+
+		friend class object_pool;
 
 	public:
 		ref_container_virtual()
@@ -215,6 +239,11 @@ public:
 		{
 			return ref_count == 0;
 		}
+
+		bool last_ref() const
+		{
+			return ref_count == 1;
+		}
 	};
 
 	typedef typename std::conditional<std::has_virtual_destructor<ObjType>::value, ref_container_virtual, ref_container_simple>::type ref_container;
@@ -227,50 +256,176 @@ public:
 	typedef aux::shared_id_set_pool<ref_container> list_type;
 
 private:
-	list_type global_object_list;
-	list_type local_object_list;
-	std::unordered_map<const_inner_ptr, const ref_container*> inner_cache;
+	list_type object_list;
+	aux::direct_cache<const_inner_ptr, const ref_container*> inner_cache;
+	aux::handle_table<ref_container> handle_list;
+	std::vector<ref_container*> local_region;
+	std::unordered_map<const ref_container*, cell> address_index;
+	aux::owner_table<ref_container> owners;
+	aux::pool_stats stats;
+	const bool handles;
+
+	// All objects are owned by a single registry (the handle table in handle mode),
+	// and local objects are additionally tracked in the region, which is released
+	// as a whole by clear_tmp. Acquiring or releasing a reference only moves the
+	// object in or out of the region, without touching the registry.
+	object_ptr add_local(std::shared_ptr<ref_container> &&ptr)
+	{
+		auto &obj = *ptr;
+		if(handles)
+		{
+			obj.pool_handle = handle_list.add(std::move(ptr));
+		}else{
+			object_list.add(std::move(ptr));
+		}
+		enter_region(obj);
+		owners.link(obj.pool_owner, &obj);
+		stats.allocated();
+		return obj;
+	}
+
+	template <class Type, class... Args>
+	static std::shared_ptr<ref_container> make_container(Args &&...args)
+	{
+		return std::allocate_shared<Type>(aux::slab_allocator<Type>(), std::forward<Args>(args)...);
+	}
+
+	void enter_region(object_ptr obj)
+	{
+		obj.region_index = local_region.size();
+		local_region.push_back(&obj);
+	}
+
+	bool in_region(const_object_ptr obj) const
+	{
+		return obj.region_index < local_region.size() && local_region[obj.region_index] == &obj;
+	}
+
+	void leave_region(object_ptr obj)
+	{
+		auto last = local_region.back();
+		last->region_index = obj.region_index;
+		local_region[obj.region_index] = last;
+		local_region.pop_back();
+	}
+
+	bool owns(const_object_ptr obj)
+	{
+		if(handles)
+		{
+			return handle_list.get(obj.pool_handle) == &obj;
+		}
+		return object_list.contains(&obj);
+	}
+
+	std::shared_ptr<ref_container> extract_registered(object_ptr obj)
+	{
+		owners.unlink(obj.pool_owner);
+		if(obj.cache_slot)
+		{
+			inner_cache.invalidate(obj.cache_slot - 1, &obj);
+		}
+		if(obj.addressed)
+		{
+			address_index.erase(&obj);
+		}
+		std::shared_ptr<ref_container> ptr;
+		if(handles)
+		{
+			ptr = handle_list.extract(obj.pool_handle);
+		}else{
+			auto it = object_list.find(&obj);
+			if(it != object_list.end())
+			{
+				ptr = object_list.extract(it);
+			}
+		}
+		if(ptr)
+		{
+			stats.freed();
+		}
+		return ptr;
+	}
+
+	std::shared_ptr<ref_container> extract(object_ptr obj)
+	{
+		if(in_region(obj))
+		{
+			leave_region(obj);
+		}
+		return extract_registered(obj);
+	}
+
+	ref_container *find_by_id(cell id)
+	{
+		if(handles)
+		{
+			return handle_list.get(id);
+		}
+		auto obj = reinterpret_cast<ref_container*>(id);
+		if(object_list.contains(obj))
+		{
+			return obj;
+		}
+		return nullptr;
+	}
 
 public:
+	object_pool() : object_list(false), handles(false)
+	{
+
+	}
+
+	// In handle mode, IDs are handle_table handles instead of the addresses of the containers
+	explicit object_pool(bool handles) : object_list(false), handles(handles)
+	{
+
+	}
+
 	object_ptr add()
 	{
-		return *local_object_list.add();
+		return add_local(make_container<ref_container>());
 	}
 
 	object_ptr add(ObjType &&obj)
 	{
-		return *local_object_list.emplace(std::move(obj));
+		return add_local(make_container<ref_container>(std::move(obj)));
 	}
 
 	object_ptr add(ref_container &&obj)
 	{
-		return *local_object_list.add(std::move(obj));
+		return add_local(make_container<ref_container>(std::move(obj)));
 	}
 
 	object_ptr add(std::shared_ptr<ref_container> &&obj)
 	{
-		return *local_object_list.add(std::move(obj));
+		return add_local(std::move(obj));
 	}
 
 	/*object_ptr add(std::unique_ptr<ref_container> &&obj)
 	{
-		return *local_object_list.add(std::move(obj));
+		return add_local(std::move(obj));
 	}*/
 
 	template <class... Args>
 	object_ptr emplace(Args &&...args)
 	{
-		return *local_object_list.emplace(std::forward<Args>(args)...);
+		return add_local(make_container<ref_container>(std::forward<Args>(args)...));
 	}
 
 	template <class Type, class... Args>
 	object_ptr emplace_derived(Args &&...args)
 	{
-		return *local_object_list.template emplace_derived<Type>(std::forward<Args>(args)...);
+		return add_local(make_container<Type>(std::forward<Args>(args)...));
 	}
 
-	cell get_address(AMX *amx, const_object_ptr obj) const
+	cell get_address(AMX *amx, object_ptr obj)
 	{
+		if(handles && !obj.addressed)
+		{
+			address_index[&obj] = obj.pool_handle;
+			obj.addressed = true;
+		}
 		unsigned char *data = amx_GetData(amx);
 		return reinterpret_cast<cell>(&obj) - reinterpret_cast<cell>(data);
 	}
@@ -299,17 +454,11 @@ public:
 
 	bool acquire_ref(object_ptr obj)
 	{
-		bool local = obj.local();
 		if(obj.acquire())
 		{
-			if(local)
+			if(in_region(obj))
 			{
-				auto it = local_object_list.find(&obj);
-				if(it != local_object_list.end())
-				{
-					auto ptr = local_object_list.extract(it);
-					global_object_list.add(std::move(ptr));
-				}
+				leave_region(obj);
 			}
 			return true;
 		}
@@ -320,48 +469,46 @@ public:
 	{
 		if(obj.release())
 		{
-			if(obj.local())
+			if(obj.local() && !in_region(obj) && owns(obj))
 			{
-				auto it = global_object_list.find(&obj);
-				if(it != global_object_list.end())
-				{
-					auto ptr = global_object_list.extract(it);
-					local_object_list.add(std::move(ptr));
-				}
+				enter_region(obj);
 			}
 			return true;
 		}
 		return false;
 	}
 
-	void set_cache(const_object_ptr obj)
+	void set_cache(object_ptr obj)
 	{
-		inner_cache[&obj->operator[](0)] = &obj;
+		// an object is cached in at most one slot, so that extract_registered can clear it
+		if(obj.cache_slot)
+		{
+			inner_cache.invalidate(obj.cache_slot - 1, &obj);
+		}
+		obj.cache_slot = inner_cache.set(&obj->operator[](0), &obj) + 1;
 	}
 
 	bool find_cache(const_inner_ptr ptr, const ref_container *&obj)
 	{
-		auto it = inner_cache.find(ptr);
-		if(it != inner_cache.end())
-		{
-			obj = it->second;
-			return true;
-		}
-		return false;
+		// the object may have reallocated its data since it was cached, in which case the entry is dropped
+		return inner_cache.find(ptr, obj, [=](const ref_container *cached) { return &(*cached)->operator[](0) == ptr; });
+	}
+
+	size_t cache_hits() const
+	{
+		return inner_cache.hits();
+	}
+
+	size_t cache_misses() const
+	{
+		return inner_cache.misses();
 	}
 
 	bool remove(object_ptr obj)
 	{
-		auto it = global_object_list.find(&obj);
-		if(it != global_object_list.end())
-		{
-			global_object_list.erase(it);
-			return true;
-		}
-		it = local_object_list.find(&obj);
-		if(it != local_object_list.end())
+		if(owns(obj))
 		{
-			local_object_list.erase(it);
+			extract(obj);
 			return true;
 		}
 		return false;
@@ -369,17 +516,10 @@ public:
 
 	bool remove_by_id(cell id)
 	{
-		auto obj = reinterpret_cast<ref_container*>(id);
-		auto it = global_object_list.find(obj);
-		if(it != global_object_list.end())
+		auto obj = find_by_id(id);
+		if(obj)
 		{
-			global_object_list.erase(it);
-			return true;
-		}
-		it = local_object_list.find(obj);
-		if(it != local_object_list.end())
-		{
-			local_object_list.erase(it);
+			extract(*obj);
 			return true;
 		}
 		return false;
@@ -388,44 +528,43 @@ public:
 	void clear()
 	{
 		inner_cache.clear();
-		auto tmp = std::move(local_object_list);
-		tmp.clear();
-		auto list = std::move(global_object_list);
+		local_region.clear();
+		address_index.clear();
+		owners.clear();
+		stats.freed(handle_list.size() + object_list.size());
+		handle_list.clear();
+		auto list = std::move(object_list);
 		list.clear();
 	}
 
 	void clear_tmp()
 	{
-		inner_cache.clear();
-		auto tmp = std::move(local_object_list);
-		tmp.clear();
+		// objects promoted by acquire_ref have already left the region
+		auto region = std::move(local_region);
+		local_region.clear();
+		std::vector<std::shared_ptr<ref_container>> released;
+		released.reserve(region.size());
+		for(auto obj : region)
+		{
+			released.push_back(extract_registered(*obj));
+		}
 	}
 
 	bool get_by_id(cell id, ref_container *&obj)
 	{
-		obj = reinterpret_cast<ref_container*>(id);
-
-		if(local_object_list.find(obj) != local_object_list.end())
-		{
-			return true;
-		}
-		if(global_object_list.find(obj) != global_object_list.end())
+		obj = find_by_id(id);
+		if(obj)
 		{
 			return true;
 		}
+		obj = reinterpret_cast<ref_container*>(id);
 		return false;
 	}
 
 	bool get_by_id(cell id, ObjType *&obj)
 	{
-		auto ptr = reinterpret_cast<ref_container*>(id);
-
-		if(local_object_list.find(ptr) != local_object_list.end())
-		{
-			obj = *ptr;
-			return true;
-		}
-		if(global_object_list.find(ptr) != global_object_list.end())
+		auto ptr = find_by_id(id);
+		if(ptr)
 		{
 			obj = *ptr;
 			return true;
@@ -436,15 +575,11 @@ public:
 
 	bool get_by_id(cell id, std::shared_ptr<ref_container> &obj)
 	{
-		if(local_object_list.get_by_id(id, obj))
-		{
-			return true;
-		}
-		if(global_object_list.get_by_id(id, obj))
+		if(handles)
 		{
-			return true;
+			return handle_list.get(id, obj);
 		}
-		return false;
+		return object_list.get_by_id(id, obj);
 	}
 
 	bool get_by_id(cell id, std::shared_ptr<ObjType> &obj)
@@ -471,49 +606,110 @@ public:
 
 	cell get_id(const_object_ptr obj) const
 	{
+		if(handles)
+		{
+			return obj.pool_handle;
+		}
 		return reinterpret_cast<cell>(&obj);
 	}
 
 	std::shared_ptr<ref_container> get(object_ptr obj)
 	{
-		auto it = local_object_list.find(&obj);
-		if(it != local_object_list.end())
-		{
-			return it->second;
-		}
-		it = global_object_list.find(&obj);
-		if(it != global_object_list.end())
+		if(handles)
 		{
-			return it->second;
+			std::shared_ptr<ref_container> ptr;
+			if(handle_list.get(obj.pool_handle, ptr) && ptr.get() == &obj)
+			{
+				return ptr;
+			}
+			return {};
 		}
-		return {};
+		return object_list.get(&obj);
 	}
 
 	bool get_by_addr(AMX *amx, cell addr, ref_container *&obj)
 	{
 		obj = reinterpret_cast<ref_container*>(amx_GetData(amx) + addr);
 
-		auto it = local_object_list.find(obj);
-		if(it != local_object_list.end())
+		if(handles)
 		{
-			return true;
+			// only objects whose address was obtained through get_address are indexed
+			auto it = address_index.find(obj);
+			return it != address_index.end() && handle_list.get(it->second) == obj;
 		}
-		it = global_object_list.find(obj);
-		if(it != global_object_list.end())
+		return object_list.contains(obj);
+	}
+
+	// Removes all objects created by the AMX
+	size_t release_owner(AMX *amx)
+	{
+		auto objects = owners.objects(amx);
+		std::vector<std::shared_ptr<ref_container>> released;
+		released.reserve(objects.size());
+		for(auto obj : objects)
 		{
-			return true;
+			released.push_back(extract(*obj));
+		}
+		owners.forget(amx);
+		return objects.size();
+	}
+
+	void forget_owner(AMX *amx)
+	{
+		owners.forget(amx);
+	}
+
+	size_t owned_size(AMX *amx) const
+	{
+		return owners.count(amx);
+	}
+
+	template <class Func>
+	void for_each_owned(AMX *amx, Func func) const
+	{
+		owners.for_each(amx, [&](const ref_container &obj)
+		{
+			func(*obj);
+		});
+	}
+
+	const aux::pool_stats &get_stats() const
+	{
+		return stats;
+	}
+
+	void reset_stats()
+	{
+		stats.reset();
+	}
+
+	template <class Func>
+	void for_each(Func func) const
+	{
+		auto call = [&](const ref_container &obj)
+		{
+			func(*obj);
+		};
+		if(handles)
+		{
+			handle_list.for_each(call);
+		}else{
+			object_list.for_each(call);
 		}
-		return false;
 	}
 
 	size_t local_size() const
 	{
-		return local_object_list.size();
+		return local_region.size();
 	}
 
 	size_t global_size() const
 	{
-		return global_object_list.size();
+		if(handles)
+		{
+			return handle_list.size() - local_region.size();
+		}
+		return object_list.size() - local_region.size();
 	}
 };
 
@@ -0,0 +1,82 @@
+#ifndef BITS_H_INCLUDED
+#define BITS_H_INCLUDED
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace aux
+{
+	// Index of the lowest set bit; the value must not be zero
+	inline unsigned int lowest_bit(std::uint32_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, value);
+		return static_cast<unsigned int>(index);
+#else
+		return static_cast<unsigned int>(__builtin_ctz(value));
+#endif
+	}
+
+	inline unsigned int lowest_bit(std::uint64_t value)
+	{
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return static_cast<unsigned int>(index);
+#elif defined(_MSC_VER)
+		auto low = static_cast<std::uint32_t>(value);
+		return low != 0 ? lowest_bit(low) : 32 + lowest_bit(static_cast<std::uint32_t>(value >> 32));
+#else
+		return static_cast<unsigned int>(__builtin_ctzll(value));
+#endif
+	}
+
+	// Index of the highest set bit; the value must not be zero
+	inline unsigned int highest_bit(std::uint32_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse(&index, value);
+		return static_cast<unsigned int>(index);
+#else
+		return 31 - static_cast<unsigned int>(__builtin_clz(value));
+#endif
+	}
+
+	inline unsigned int highest_bit(std::uint64_t value)
+	{
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return static_cast<unsigned int>(index);
+#elif defined(_MSC_VER)
+		auto high = static_cast<std::uint32_t>(value >> 32);
+		return high != 0 ? 32 + highest_bit(high) : highest_bit(static_cast<std::uint32_t>(value));
+#else
+		return 63 - static_cast<unsigned int>(__builtin_clzll(value));
+#endif
+	}
+
+	inline unsigned int count_bits(std::uint32_t value)
+	{
+#ifdef _MSC_VER
+		// __popcnt requires a CPU with POPCNT
+		value = value - ((value >> 1) & 0x55555555);
+		value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+		return static_cast<unsigned int>((((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+#else
+		return static_cast<unsigned int>(__builtin_popcount(value));
+#endif
+	}
+
+	inline unsigned int count_bits(std::uint64_t value)
+	{
+		return count_bits(static_cast<std::uint32_t>(value)) + count_bits(static_cast<std::uint32_t>(value >> 32));
+	}
+}
+
+#endif
@@ -2,14 +2,18 @@
 #define BLOCK_POOL_H_INCLUDED
 
 #include <vector>
-#include <array>
+#include <algorithm>
 #include <memory>
-#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
 
+#include "bits.h"
 #include "fixes/linux.h"
 
 namespace aux
 {
+	// Pool of indexed slots with occupancy kept in a bitmap, 64 slots per word
 	template <class Type, size_t BlockSize>
 	class block_pool
 	{
@@ -20,119 +24,198 @@ namespace aux
 		typedef Type value_type;
 
 	private:
-		struct element_type;
-		struct block_info;
-		std::vector<element_type> data;
-		std::unique_ptr<block_info> block;
-		size_t level = 0;
-		size_type last_set;
+		typedef typename std::aligned_storage<sizeof(Type), alignof(Type)>::type slot;
+		typedef std::uint64_t word;
+		static constexpr size_type word_bits = 64;
 
-		struct element_type
+		std::vector<slot> data;
+		std::vector<word> bits;
+		size_type count = 0;
+		size_type free_hint = 0;
+		size_type last_set = 0;
+
+		static size_type words_for(size_type size)
 		{
-			bool assigned;
-			union {
-				Type value;
-			};
+			return (size + word_bits - 1) / word_bits;
+		}
 
-			element_type() : assigned(false)
-			{
+		static size_type padded(size_type size)
+		{
+			size_type pad = BlockSize - size % BlockSize;
+			return pad < BlockSize ? size + pad : size;
+		}
 
-			}
+		Type &value_at(size_type index)
+		{
+			return *reinterpret_cast<Type*>(&data[index]);
+		}
+
+		const Type &value_at(size_type index) const
+		{
+			return *reinterpret_cast<const Type*>(&data[index]);
+		}
+
+		bool assigned(size_type index) const
+		{
+			return (bits[index / word_bits] >> (index % word_bits)) & 1;
+		}
 
-			element_type(const element_type &obj) : assigned(obj.assigned)
+		void mark(size_type index)
+		{
+			bits[index / word_bits] |= word(1) << (index % word_bits);
+			count++;
+		}
+
+		void unmark(size_type index)
+		{
+			bits[index / word_bits] &= ~(word(1) << (index % word_bits));
+			count--;
+			if(index / word_bits < free_hint)
 			{
-				if(assigned)
-				{
-					new (&value) Type(obj.value);
-				}
+				free_hint = index / word_bits;
 			}
+		}
 
-			element_type(element_type &&obj) noexcept(noexcept(new(nullptr) Type(std::move(obj.value)))) : assigned(obj.assigned)
+		template <class Func>
+		void for_each_assigned(size_type first, Func func)
+		{
+			for(size_type w = first / word_bits; w < bits.size(); w++)
 			{
-				if(assigned)
+				word value = bits[w];
+				if(w == first / word_bits)
+				{
+					value &= ~word(0) << (first % word_bits);
+				}
+				while(value != 0)
 				{
-					new (&value) Type(std::move(obj.value));
+					func(w * word_bits + lowest_bit(value));
+					value &= value - 1;
 				}
 			}
+		}
 
-			element_type &operator=(const element_type &obj)
+		// Changes the number of slots; returns true if the storage was moved
+		bool resize_slots(size_type newsize)
+		{
+			if(newsize <= data.capacity())
 			{
-				if(this != &obj)
-				{
-					if(assigned && obj.assigned)
-					{
-						value = obj.value;
-					}else if(assigned)
-					{
-						value.~Type();
-					}else if(obj.assigned)
-					{
-						new (&value) Type(obj.value);
-					}
-					assigned = obj.assigned;
-				}
-				return *this;
+				data.resize(newsize);
+				return false;
 			}
+			std::vector<slot> next;
+			next.reserve(std::max(newsize, data.capacity() * 2));
+			next.resize(newsize);
+			for_each_assigned(0, [&](size_type i)
+			{
+				new (&next[i]) Type(std::move(value_at(i)));
+				value_at(i).~Type();
+			});
+			data.swap(next);
+			bits.resize(words_for(data.capacity()));
+			return true;
+		}
 
-			element_type &operator=(element_type &&obj)
+		void destroy(size_type first)
+		{
+			for_each_assigned(first, [&](size_type i)
 			{
-				if(this != &obj)
+				value_at(i).~Type();
+				bits[i / word_bits] &= ~(word(1) << (i % word_bits));
+				count--;
+			});
+		}
+
+		size_type allocate(bool &resized)
+		{
+			size_type words = words_for(data.size());
+			for(size_type w = free_hint; w < words; w++)
+			{
+				word free = ~bits[w];
+				if(free != 0)
 				{
-					if(assigned && obj.assigned)
-					{
-						value = std::move(obj.value);
-					}else if(assigned)
-					{
-						value.~Type();
-					}else if(obj.assigned)
+					free_hint = w;
+					size_type index = w * word_bits + lowest_bit(free);
+					if(index < data.size())
 					{
-						new (&value) Type(std::move(obj.value));
+						resized = false;
+						return index;
 					}
-					assigned = obj.assigned;
+					break;
 				}
-				return *this;
 			}
+			size_type index = data.size();
+			free_hint = index / word_bits;
+			resized = resize_slots(padded(index + 1));
+			return index;
+		}
 
-			~element_type() noexcept(noexcept(value.~Type()))
-			{
-				if(assigned)
-				{
-					value.~Type();
-					assigned = false;
-				}
-			}
-		};
+		template<class... Args>
+		bool construct(Args&&... args)
+		{
+			bool resized;
+			size_type index = allocate(resized);
+			new (&data[index]) Type(std::forward<Args>(args)...);
+			mark(index);
+			last_set = index;
+			return resized;
+		}
 
-		struct block_info
+	public:
+		class iterator
 		{
-			size_type num_elements = 0;
-			std::array<std::unique_ptr<block_info>, BlockSize> blocks;
-			block_info *parent = nullptr;
+			friend class block_pool<Type, BlockSize>;
+			slot *base;
+			const word *bits;
+			const word *bits_end;
+			slot *elem;
 
-			block_info()
+			iterator(block_pool &pool, size_type index) noexcept : base(pool.data.data()), bits(pool.bits.data()), bits_end(pool.bits.data() + pool.bits.size()), elem(base + index)
 			{
 
 			}
 
-			block_info(block_info &parent) : parent(&parent)
+			void seek_next(size_type index) noexcept
 			{
-
+				const word *w = bits + index / word_bits;
+				if(w != bits_end)
+				{
+					word value = *w >> (index % word_bits);
+					if(value & 1)
+					{
+						elem = base + index;
+						return;
+					}else if(value != 0)
+					{
+						elem = base + index + lowest_bit(value);
+						return;
+					}
+					while(++w != bits_end)
+					{
+						if(*w != 0)
+						{
+							elem = base + (w - bits) * word_bits + lowest_bit(*w);
+							return;
+						}
+					}
+				}
+				elem = nullptr;
 			}
 
-			block_info(std::unique_ptr<block_info> &&initial) : num_elements(initial->num_elements)
+			void seek_previous(size_type index) noexcept
 			{
-				initial->parent = this;
-				std::get<0>(blocks) = std::move(initial);
+				const word *w = bits + index / word_bits;
+				word value = *w & (~word(0) >> (word_bits - 1 - index % word_bits));
+				while(value == 0)
+				{
+					if(w == bits)
+					{
+						elem = nullptr;
+						return;
+					}
+					value = *--w;
+				}
+				elem = base + (w - bits) * word_bits + highest_bit(value);
 			}
-		};
-
-	public:
-		class iterator
-		{
-			friend class block_pool<Type, BlockSize>;
-			element_type *elem;
-			block_info *block;
-			size_t index;
 
 		public:
 			typedef std::ptrdiff_t difference_type;
@@ -146,83 +229,19 @@ namespace aux
 
 			}
 
-			iterator(element_type *elem, block_info *block, size_t index) noexcept : elem(elem), block(block), index(index)
-			{
-
-			}
-
 			reference operator*() const noexcept
 			{
-				return elem->value;
+				return *reinterpret_cast<Type*>(elem);
 			}
 
 			pointer operator->() const noexcept
 			{
-				return &elem->value;
+				return reinterpret_cast<Type*>(elem);
 			}
 
 			iterator &operator++() noexcept
 			{
-				do{
-					++elem;
-					if(index == BlockSize - 1)
-					{
-						size_t level = 1;
-						while(level > 0)
-						{
-							auto parent = block->parent;
-							if(!parent)
-							{
-								elem = nullptr;
-								return *this;
-							}
-							size_t next = -1;
-							for(size_t i = 0; i < BlockSize; i++)
-							{
-								if(parent->blocks[i].get() == block)
-								{
-									next = i + 1;
-									break;
-								}
-							}
-							while(next == BlockSize || !parent->blocks[next] || parent->blocks[next]->num_elements == 0)
-							{
-								if(next == BlockSize)
-								{
-									++level;
-									block = parent;
-									next = -1;
-									break;
-								}else{
-									++next;
-									elem += static_cast<size_t>(std::pow(BlockSize, level));
-								}
-							}
-							if(next != -1)
-							{
-								block = parent->blocks[next].get();
-								next = -1;
-								--level;
-								while(level > 0)
-								{
-									for(size_t i = 0; i < BlockSize; i++)
-									{
-										if(block->blocks[i] && block->blocks[i]->num_elements > 0)
-										{
-											block = block->blocks[i].get();
-											--level;
-											break;
-										}
-										elem += static_cast<size_t>(std::pow(BlockSize, level));
-									}
-								}
-								index = 0;
-							}
-						}
-					}else{
-						++index;
-					}
-				}while(!elem->assigned);
+				seek_next(elem - base + 1);
 				return *this;
 			}
 
@@ -235,65 +254,12 @@ namespace aux
 
 			iterator &operator--() noexcept
 			{
-				do{
-					--elem;
-					if(index == 0)
-					{
-						size_t level = 1;
-						while(level > 0)
-						{
-							auto parent = block->parent;
-							if(!parent)
-							{
-								elem = nullptr;
-								return *this;
-							}
-							size_t next = -1;
-							for(size_t i = 0; i < BlockSize; i++)
-							{
-								if(parent->blocks[i].get() == block)
-								{
-									next = i - 1;
-									break;
-								}
-							}
-							while(next == -1 || !parent->blocks[next] || parent->blocks[next]->num_elements == 0)
-							{
-								if(next == -1)
-								{
-									++level;
-									block = parent;
-									break;
-								}else{
-									--next;
-									elem -= static_cast<size_t>(std::pow(BlockSize, level));
-								}
-							}
-							if(next != -1)
-							{
-								block = parent->blocks[next].get();
-								next = -1;
-								--level;
-								while(level > 0)
-								{
-									for(size_t i = BlockSize - 1; i != -1; i--)
-									{
-										if(block->blocks[i] && block->blocks[i]->num_elements > 0)
-										{
-											block = block->blocks[i].get();
-											--level;
-											break;
-										}
-										elem -= static_cast<size_t>(std::pow(BlockSize, level));
-									}
-								}
-								index = BlockSize - 1;
-							}
-						}
-					}else{
-						--index;
-					}
-				}while(!elem->assigned);
+				if(elem == base)
+				{
+					elem = nullptr;
+				}else{
+					seek_previous(elem - base - 1);
+				}
 				return *this;
 			}
 
@@ -317,254 +283,79 @@ namespace aux
 
 		typedef iterator const_iterator;
 
-	private:
-		Type &allocate_in_block(block_info &block, size_type offset, size_t level)
+		block_pool()
 		{
-			block.num_elements++;
-			if(level > 0)
-			{
-				size_t block_size = static_cast<size_t>(std::pow(BlockSize, level));
-				for(size_t i = 0; i < BlockSize; i++)
-				{
-					auto &sub = block.blocks[i];
-					if(!sub)
-					{
-						sub = std::make_unique<block_info>(block);
-						return allocate_in_block(*sub, offset + i * block_size, level - 1);
-					}else if(sub->num_elements < block_size)
-					{
-						return allocate_in_block(*sub, offset + i * block_size, level - 1);
-					}
-				}
-			}else{
-				for(size_t i = 0; i < BlockSize; i++)
-				{
-					auto &elem = data[offset + i];
-					if(!elem.assigned)
-					{
-						elem.assigned = true;
-						last_set = offset + i;
-						return elem.value;
-					}
-				}
-			}
-			throw nullptr;
-		}
-		
-		Type &allocate(bool &resized)
-		{
-			if(block->num_elements == data.size())
-			{
-				resized = data.size() == data.capacity();
-				data.emplace_back();
-			}else{
-				resized = false;
-			}
-			size_type pad = BlockSize - data.size() % BlockSize;
-			if(pad < BlockSize)
-			{
-				if(!resized)
-				{
-					resized = data.size() + pad > data.capacity();
-				}
-				for(size_type i = 0; i < pad; i++)
-				{
-					data.emplace_back();
-				}
-			}
-			if(block->num_elements == std::pow(BlockSize, level + 1))
-			{
-				block = std::make_unique<block_info>(std::move(block));
-				++level;
-			}
-			return allocate_in_block(*block, 0, level);
-		}
 
-		iterator find_first(block_info &block, size_type offset, size_t level)
-		{
-			if(level > 0)
-			{
-				for(size_t i = 0; i < BlockSize; i++)
-				{
-					auto &sub = block.blocks[i];
-					if(sub && sub->num_elements > 0)
-					{
-						size_t block_size = static_cast<size_t>(std::pow(BlockSize, level));
-						return find_first(*sub, offset + i * block_size, level - 1);
-					}
-				}
-			}else{
-				for(size_t i = 0; i < BlockSize; i++)
-				{
-					auto &elem = data[offset + i];
-					if(elem.assigned)
-					{
-						return iterator(&elem, &block, i);
-					}
-				}
-			}
-			throw nullptr;
 		}
 
-		iterator find_last(block_info &block, size_type offset, size_t level)
+		block_pool(const block_pool &obj) : free_hint(obj.free_hint), last_set(obj.last_set)
 		{
-			if(level > 0)
+			data.reserve(obj.data.size());
+			data.resize(obj.data.size());
+			bits.resize(words_for(data.capacity()));
+			for(size_type w = 0; w < obj.bits.size(); w++)
 			{
-				for(size_t i = BlockSize - 1; i != -1; i--)
+				word value = obj.bits[w];
+				while(value != 0)
 				{
-					auto &sub = block.blocks[i];
-					if(sub && sub->num_elements > 0)
-					{
-						size_t block_size = static_cast<size_t>(std::pow(BlockSize, level));
-						return find_last(*sub, offset + i * block_size, level - 1);
-					}
-				}
-			}else{
-				for(size_t i = BlockSize - 1; i != -1; i--)
-				{
-					auto &elem = data[offset + i];
-					if(elem.assigned)
-					{
-						return iterator(&elem, &block, i);
-					}
+					size_type i = w * word_bits + lowest_bit(value);
+					new (&data[i]) Type(obj.value_at(i));
+					mark(i);
+					value &= value - 1;
 				}
 			}
-			throw nullptr;
 		}
 
-		iterator iter_for(block_info &block, size_type offset, size_type index, size_t level)
-		{
-			if(level > 0)
-			{
-				size_t block_size = static_cast<size_t>(std::pow(BlockSize, level));
-				for(size_t i = 0; i < BlockSize; i++)
-				{
-					if(index < offset + block_size)
-					{
-						auto &sub = block.blocks[i];
-						return iter_for(*sub, offset, index, level - 1);
-					}
-					offset += block_size;
-				}
-			}else{
-				auto &elem = data[index];
-				return iterator(&elem, &block, index - offset);
-			}
-			throw nullptr;
-		}
-		
-		iterator iter_add(block_info &block, size_type offset, size_type index, size_t level, Type &&value)
-		{
-			block.num_elements++;
-			if(level > 0)
-			{
-				size_t block_size = static_cast<size_t>(std::pow(BlockSize, level));
-				for(size_t i = 0; i < BlockSize; i++)
-				{
-					if(index < offset + block_size)
-					{
-						auto &sub = block.blocks[i];
-						if(!sub)
-						{
-							sub = std::make_unique<block_info>(block);
-						}
-						return iter_add(*sub, offset, index, level - 1, std::move(value));
-					}
-					offset += block_size;
-				}
-			}else{
-				auto &elem = data[index];
-				elem.assigned = true;
-				new (&elem.value) dyn_object(std::move(value));
-				return iterator(&elem, &block, index - offset);
-			}
-			throw nullptr;
-		}
-
-		size_type clear_blocks(block_info &block, size_type offset, size_type newsize, size_t level)
-		{
-			size_type removed = 0;
-			if(level > 0)
-			{
-				size_t block_size = static_cast<size_t>(std::pow(BlockSize, level));
-				for(size_t i = 0; i < BlockSize; i++)
-				{
-					auto &sub = block.blocks[i];
-					if(sub)
-					{
-						if(offset >= newsize)
-						{
-							removed += sub->num_elements;
-							sub = nullptr;
-						}else if(offset + block_size > newsize)
-						{
-							removed += clear_blocks(*sub, offset, newsize, level - 1);
-						}
-					}
-					offset += block_size;
-				}
-			}else{
-				for(size_t i = 0; i < BlockSize; i++)
-				{
-					auto &elem = data[offset + i];
-					if(elem.assigned && offset + i >= newsize)
-					{
-						removed++;
-					}
-				}
-			}
-			block.num_elements -= removed;
-			return removed;
-		}
-
-	public:
-		block_pool() : block(std::make_unique<block_info>())
-		{
-
-		}
-
-		block_pool(const block_pool &obj) : data(obj.data), block(std::make_unique<block_info>(*obj.block)), level(obj.level), last_set(obj.last_set)
-		{
-
-		}
-
-		block_pool(block_pool &&obj) : data(std::move(obj.data)), block(std::move(obj.block)), level(obj.level), last_set(obj.last_set)
+		block_pool(block_pool &&obj) noexcept : data(std::move(obj.data)), bits(std::move(obj.bits)), count(obj.count), free_hint(obj.free_hint), last_set(obj.last_set)
 		{
 			obj.data.clear();
+			obj.bits.clear();
+			obj.count = 0;
+			obj.free_hint = 0;
 		}
 
 		block_pool &operator=(const block_pool &obj)
 		{
 			if(this != &obj)
 			{
-				data = obj.data;
-				block = std::make_unique<block_info>(*obj.block);
-				level = obj.level;
-				last_set = obj.last_set;
+				block_pool tmp(obj);
+				swap(tmp);
 			}
 			return *this;
 		}
 
-		block_pool &operator=(block_pool &&obj)
+		block_pool &operator=(block_pool &&obj) noexcept
 		{
 			if(this != &obj)
 			{
+				destroy(0);
 				data = std::move(obj.data);
-				block = std::move(obj.block);
-				obj.data.clear();
-				level = obj.level;
+				bits = std::move(obj.bits);
+				count = obj.count;
+				free_hint = obj.free_hint;
 				last_set = obj.last_set;
+				obj.data.clear();
+				obj.bits.clear();
+				obj.count = 0;
+				obj.free_hint = 0;
 			}
 			return *this;
 		}
 
+		~block_pool()
+		{
+			destroy(0);
+		}
+
 		iterator begin()
 		{
-			if(block->num_elements == 0)
+			if(count == 0)
 			{
 				return end();
 			}
-			return find_first(*block, 0, level);
+			iterator it(*this, 0);
+			it.seek_next(0);
+			return it;
 		}
 
 		iterator end()
@@ -574,25 +365,23 @@ namespace aux
 
 		iterator last_iter()
 		{
-			if(block->num_elements == 0)
+			if(count == 0)
 			{
 				return end();
 			}
-			return find_last(*block, 0, level);
+			iterator it(*this, 0);
+			it.seek_previous(data.size() - 1);
+			return it;
 		}
 
 		bool push_back(Type &&value)
 		{
-			bool resized;
-			new (&allocate(resized)) Type(std::move(value));
-			return resized;
+			return construct(std::move(value));
 		}
 
 		bool push_back(const Type &value)
 		{
-			bool resized;
-			new (&allocate(resized)) Type(value);
-			return resized;
+			return construct(value);
 		}
 
 		size_t get_last_set() const
@@ -603,46 +392,34 @@ namespace aux
 		template<class... Args>
 		bool emplace_back(Args&&... args)
 		{
-			bool resized;
-			new (&allocate(resized)) Type(std::forward<Args>(args)...);
-			return resized;
+			return construct(std::forward<Args>(args)...);
 		}
 
 		iterator erase(iterator pos)
 		{
 			auto next = pos;
 			++next;
-			auto &elem = *pos.elem;
-			elem.assigned = false;
-			elem.value.~Type();
-			auto block = pos.block;
-			while(block != nullptr)
-			{
-				block->num_elements--;
-				block = block->parent;
-			}
+			size_type index = pos.elem - data.data();
+			value_at(index).~Type();
+			unmark(index);
 			return next;
 		}
 
 		Type &operator[](size_type index)
 		{
-			return data[index].value;
+			return value_at(index);
 		}
 
 		const Type &operator[](size_type index) const
 		{
-			return data[index].value;
+			return value_at(index);
 		}
 
 		iterator find(size_type index)
 		{
-			if(index < data.size())
+			if(index < data.size() && assigned(index))
 			{
-				auto &elem = data[index];
-				if(elem.assigned)
-				{
-					return iter_for(*block, 0, index, level);
-				}
+				return iterator(*this, index);
 			}
 			return iterator();
 		}
@@ -653,71 +430,30 @@ namespace aux
 			{
 				resize(index + 1);
 			}
-			auto &elem = data[index];
-			if(elem.assigned)
+			if(assigned(index))
 			{
-				elem.value = std::move(value);
-				return iter_for(*block, 0, index, level);
+				value_at(index) = std::move(value);
 			}else{
-				auto range = static_cast<size_t>(std::pow(BlockSize, level + 1));
-				while(index >= range)
-				{
-					block = std::make_unique<block_info>(std::move(block));
-					++level;
-					range *= BlockSize;
-				}
-				return iter_add(*block, 0, index, level, std::move(value));
+				new (&data[index]) Type(std::move(value));
+				mark(index);
 			}
+			return iterator(*this, index);
 		}
 
 		bool resize(size_type newsize)
 		{
-			auto size = data.size();
-			bool invalidate = false;
-			if(newsize > size)
+			if(newsize > data.size())
 			{
-				size_type pad = BlockSize - newsize % BlockSize;
-				if(pad < BlockSize)
-				{
-					newsize += pad;
-				}
-				auto rem = newsize - size;
-				if(data.capacity() < newsize)
-				{
-					data.reserve(newsize);
-					invalidate = true;
-				}
-				for(size_type i = 0; i < rem; i++)
-				{
-					data.emplace_back();
-				}
-			}else if(newsize < size)
+				return resize_slots(padded(newsize));
+			}else if(newsize < data.size())
 			{
-				if(newsize == 0)
-				{
-					level = 0;
-					invalidate = block->num_elements > 0;
-					block = std::make_unique<block_info>();
-					data.clear();
-				}else{
-					invalidate = clear_blocks(*block, 0, newsize, level) > 0;
-					data.erase(data.begin() + newsize, data.end());
-
-					size_type pad = BlockSize - data.size() % BlockSize;
-					if(pad < BlockSize)
-					{
-						if(!invalidate)
-						{
-							invalidate = data.size() + pad > data.capacity();
-						}
-						for(size_type i = 0; i < pad; i++)
-						{
-							data.emplace_back();
-						}
-					}
-				}
+				size_type old_count = count;
+				destroy(newsize);
+				data.resize(padded(newsize));
+				free_hint = std::min(free_hint, newsize / word_bits);
+				return count != old_count;
 			}
-			return invalidate;
+			return false;
 		}
 
 		size_type size() const
@@ -727,19 +463,20 @@ namespace aux
 
 		size_type index_of(iterator it) const
 		{
-			return it.elem - &data[0];
+			return it.elem - data.data();
 		}
 
 		size_type num_elements() const
 		{
-			return block ? block->num_elements : 0;
+			return count;
 		}
 
 		void swap(block_pool<Type, BlockSize> &obj)
 		{
 			std::swap(data, obj.data);
-			std::swap(block, obj.block);
-			std::swap(level, obj.level);
+			std::swap(bits, obj.bits);
+			std::swap(count, obj.count);
+			std::swap(free_hint, obj.free_hint);
 			std::swap(last_set, obj.last_set);
 		}
 	};
@@ -0,0 +1,991 @@
+#ifndef BTREE_MAP_H_INCLUDED
+#define BTREE_MAP_H_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace aux
+{
+	namespace impl
+	{
+		struct btree_node_base
+		{
+			btree_node_base *parent = nullptr;
+			unsigned short index = 0;
+			unsigned short size = 0;
+			bool leaf;
+
+			btree_node_base(bool leaf) : leaf(leaf)
+			{
+
+			}
+		};
+
+		template <class Value, std::size_t Capacity>
+		struct btree_leaf : public btree_node_base
+		{
+			btree_leaf *prev = nullptr;
+			btree_leaf *next = nullptr;
+			typename std::aligned_storage<sizeof(Value), std::alignment_of<Value>::value>::type storage[Capacity];
+
+			btree_leaf() : btree_node_base(true)
+			{
+
+			}
+
+			Value *values()
+			{
+				return reinterpret_cast<Value*>(storage);
+			}
+
+			~btree_leaf()
+			{
+				for(unsigned short i = 0; i < size; i++)
+				{
+					values()[i].~Value();
+				}
+			}
+		};
+
+		template <class Leaf, class Elem>
+		class btree_iterator
+		{
+			Leaf *node;
+			std::size_t pos;
+
+			template <class, class>
+			friend class btree_iterator;
+
+		public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef typename std::remove_const<Elem>::type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Elem *pointer;
+			typedef Elem &reference;
+
+			btree_iterator() : node(nullptr), pos(0)
+			{
+
+			}
+
+			btree_iterator(Leaf *node, std::size_t pos) : node(node), pos(pos)
+			{
+
+			}
+
+			template <class Other, class = typename std::enable_if<std::is_convertible<Other*, Elem*>::value>::type>
+			btree_iterator(const btree_iterator<Leaf, Other> &it) : node(it.node), pos(it.pos)
+			{
+
+			}
+
+			Leaf *get_node() const
+			{
+				return node;
+			}
+
+			std::size_t get_pos() const
+			{
+				return pos;
+			}
+
+			reference operator*() const
+			{
+				return node->values()[pos];
+			}
+
+			pointer operator->() const
+			{
+				return &**this;
+			}
+
+			btree_iterator &operator++()
+			{
+				if(++pos == node->size && node->next)
+				{
+					node = node->next;
+					pos = 0;
+				}
+				return *this;
+			}
+
+			btree_iterator operator++(int)
+			{
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			btree_iterator &operator--()
+			{
+				if(pos == 0)
+				{
+					node = node->prev;
+					pos = node->size;
+				}
+				--pos;
+				return *this;
+			}
+
+			btree_iterator operator--(int)
+			{
+				auto tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			bool operator==(const btree_iterator &it) const
+			{
+				return node == it.node && pos == it.pos;
+			}
+
+			bool operator!=(const btree_iterator &it) const
+			{
+				return node != it.node || pos != it.pos;
+			}
+		};
+	}
+
+	// Ordered map stored in a B+tree, with the elements kept in linked leaves and inner nodes
+	// holding the number of elements under each child, so that the n-th element and the position
+	// of an element are found in logarithmic time. Inserting or erasing an element may move
+	// other elements, invalidating all iterators.
+	template <class Key, class Value, class Compare = std::less<Key>>
+	class btree_map
+	{
+	public:
+		typedef std::pair<const Key, Value> value_type;
+		typedef value_type &reference;
+		typedef const value_type &const_reference;
+		typedef std::size_t size_type;
+
+	private:
+		static const size_type leaf_capacity = 512 / sizeof(value_type) > 8 ? 512 / sizeof(value_type) : 8;
+		static const size_type inner_capacity = 512 / sizeof(Key) > 64 ? 64 : (512 / sizeof(Key) > 16 ? 512 / sizeof(Key) : 16);
+
+		typedef impl::btree_node_base node_base;
+		typedef impl::btree_leaf<value_type, leaf_capacity> leaf_node;
+
+		// Child i holds the keys between separators i-1 and i
+		struct inner_node : public node_base
+		{
+			typename std::aligned_storage<sizeof(Key), std::alignment_of<Key>::value>::type storage[inner_capacity - 1];
+			node_base *children[inner_capacity];
+			size_type counts[inner_capacity];
+
+			inner_node() : node_base(false)
+			{
+
+			}
+
+			Key *keys()
+			{
+				return reinterpret_cast<Key*>(storage);
+			}
+
+			~inner_node()
+			{
+				for(unsigned short i = 1; i < size; i++)
+				{
+					keys()[i - 1].~Key();
+				}
+			}
+		};
+
+	public:
+		typedef impl::btree_iterator<leaf_node, value_type> iterator;
+		typedef impl::btree_iterator<leaf_node, const value_type> const_iterator;
+
+	private:
+		node_base *root = nullptr;
+		leaf_node *head = nullptr;
+		leaf_node *tail = nullptr;
+		size_type count = 0;
+		Compare compare;
+
+		static inner_node *parent_of(node_base *node)
+		{
+			return static_cast<inner_node*>(node->parent);
+		}
+
+		static void relocate(value_type *dest, value_type *src)
+		{
+			// the key is not observable while it is moved
+			new (dest) value_type(std::move(const_cast<Key&>(src->first)), std::move(src->second));
+			src->~value_type();
+		}
+
+		// The source is left to its owner, which destroys it
+		static void move_into(value_type *dest, value_type &src)
+		{
+			new (dest) value_type(std::move(const_cast<Key&>(src.first)), std::move(src.second));
+		}
+
+		static void relocate(Key *dest, Key *src)
+		{
+			new (dest) Key(std::move(*src));
+			src->~Key();
+		}
+
+		static void set_child(inner_node *node, size_type index, node_base *child, size_type count)
+		{
+			node->children[index] = child;
+			node->counts[index] = count;
+			child->parent = node;
+			child->index = static_cast<unsigned short>(index);
+		}
+
+		static size_type total(node_base *node)
+		{
+			if(node->leaf)
+			{
+				return node->size;
+			}
+			auto inner = static_cast<inner_node*>(node);
+			size_type sum = 0;
+			for(unsigned short i = 0; i < inner->size; i++)
+			{
+				sum += inner->counts[i];
+			}
+			return sum;
+		}
+
+		static void destroy(node_base *node)
+		{
+			if(node->leaf)
+			{
+				delete static_cast<leaf_node*>(node);
+			}else{
+				auto inner = static_cast<inner_node*>(node);
+				for(unsigned short i = 0; i < inner->size; i++)
+				{
+					destroy(inner->children[i]);
+				}
+				delete inner;
+			}
+		}
+
+		leaf_node *find_leaf(const Key &key) const
+		{
+			node_base *node = root;
+			while(!node->leaf)
+			{
+				auto inner = static_cast<inner_node*>(node);
+				size_type lo = 0, hi = inner->size - 1;
+				while(lo < hi)
+				{
+					size_type mid = (lo + hi) / 2;
+					if(compare(key, inner->keys()[mid]))
+					{
+						hi = mid;
+					}else{
+						lo = mid + 1;
+					}
+				}
+				node = inner->children[lo];
+			}
+			return static_cast<leaf_node*>(node);
+		}
+
+		size_type lower_index(leaf_node *leaf, const Key &key) const
+		{
+			size_type lo = 0, hi = leaf->size;
+			while(lo < hi)
+			{
+				size_type mid = (lo + hi) / 2;
+				if(compare(leaf->values()[mid].first, key))
+				{
+					lo = mid + 1;
+				}else{
+					hi = mid;
+				}
+			}
+			return lo;
+		}
+
+		size_type upper_index(leaf_node *leaf, const Key &key) const
+		{
+			size_type lo = 0, hi = leaf->size;
+			while(lo < hi)
+			{
+				size_type mid = (lo + hi) / 2;
+				if(compare(key, leaf->values()[mid].first))
+				{
+					hi = mid;
+				}else{
+					lo = mid + 1;
+				}
+			}
+			return lo;
+		}
+
+		// Finds the leaf and the position of the key, or where it would be inserted
+		std::pair<iterator, bool> locate(const Key &key) const
+		{
+			if(!root)
+			{
+				return std::make_pair(iterator(), false);
+			}
+			leaf_node *leaf = find_leaf(key);
+			size_type pos = lower_index(leaf, key);
+			bool found = pos < leaf->size && !compare(key, leaf->values()[pos].first);
+			return std::make_pair(iterator(leaf, pos), found);
+		}
+
+		iterator make_iterator(leaf_node *leaf, size_type pos) const
+		{
+			if(pos == leaf->size && leaf->next)
+			{
+				return iterator(leaf->next, 0);
+			}
+			return iterator(leaf, pos);
+		}
+
+		// Adds a root above the node; the count includes the elements not yet in the node
+		void ensure_parent(node_base *node, size_type pending = 0)
+		{
+			if(!node->parent)
+			{
+				auto inner = new inner_node();
+				set_child(inner, 0, node, total(node) + pending);
+				inner->size = 1;
+				root = inner;
+			}
+		}
+
+		static void adjust(node_base *node, std::ptrdiff_t delta)
+		{
+			for(; node->parent; node = node->parent)
+			{
+				parent_of(node)->counts[node->index] += delta;
+			}
+		}
+
+		// Inserts a child at the position, with the separator preceding it; the elements
+		// under the child must be already counted in the node
+
+		void insert_child(inner_node *node, size_type pos, Key &&separator, node_base *child, size_type count)
+		{
+			if(node->size == inner_capacity)
+			{
+				ensure_parent(node, count);
+				auto right = new inner_node();
+				size_type half = inner_capacity / 2;
+				size_type moved = 0;
+				for(size_type i = half; i < node->size; i++)
+				{
+					set_child(right, i - half, node->children[i], node->counts[i]);
+					moved += node->counts[i];
+					if(i + 1 < node->size)
+					{
+						relocate(&right->keys()[i - half], &node->keys()[i]);
+					}
+				}
+				right->size = static_cast<unsigned short>(node->size - half);
+				node->size = static_cast<unsigned short>(half);
+				Key up(std::move(node->keys()[half - 1]));
+				node->keys()[half - 1].~Key();
+
+				auto parent = parent_of(node);
+				parent->counts[node->index] -= moved;
+				insert_child(parent, node->index + 1, std::move(up), right, moved);
+				if(pos > half)
+				{
+					// the count of the child was included in the node
+					adjust(node, -static_cast<std::ptrdiff_t>(count));
+					adjust(right, count);
+					node = right;
+					pos -= half;
+				}
+			}
+			for(size_type i = node->size; i > pos; i--)
+			{
+				set_child(node, i, node->children[i - 1], node->counts[i - 1]);
+				relocate(&node->keys()[i - 1], &node->keys()[i - 2]);
+			}
+			new (&node->keys()[pos - 1]) Key(std::move(separator));
+			set_child(node, pos, child, count);
+			node->size++;
+		}
+
+		void remove_child(inner_node *node, size_type pos)
+		{
+			node->keys()[pos - 1].~Key();
+			for(size_type i = pos; i + 1 < node->size; i++)
+			{
+				relocate(&node->keys()[i - 1], &node->keys()[i]);
+				set_child(node, i, node->children[i + 1], node->counts[i + 1]);
+			}
+			node->size--;
+		}
+
+		void link_after(leaf_node *leaf, leaf_node *next)
+		{
+			next->prev = leaf;
+			next->next = leaf->next;
+			if(leaf->next)
+			{
+				leaf->next->prev = next;
+			}else{
+				tail = next;
+			}
+			leaf->next = next;
+		}
+
+		void unlink(leaf_node *leaf)
+		{
+			if(leaf->prev)
+			{
+				leaf->prev->next = leaf->next;
+			}else{
+				head = leaf->next;
+			}
+			if(leaf->next)
+			{
+				leaf->next->prev = leaf->prev;
+			}else{
+				tail = leaf->prev;
+			}
+		}
+
+		iterator insert_at(iterator hint, value_type &&value)
+		{
+			leaf_node *leaf = hint.get_node();
+			size_type pos = hint.get_pos();
+			if(!leaf)
+			{
+				leaf = new leaf_node();
+				root = head = tail = leaf;
+				pos = 0;
+			}else if(leaf->size == leaf_capacity)
+			{
+				bool append = leaf == tail && pos == leaf->size;
+				auto right = new leaf_node();
+				link_after(leaf, right);
+				ensure_parent(leaf);
+				if(append)
+				{
+					// appending at the end keeps the leaves full
+					move_into(right->values(), value);
+					right->size = 1;
+					insert_child(parent_of(leaf), leaf->index + 1, Key(right->values()[0].first), right, 0);
+					adjust(right, 1);
+					count++;
+					return iterator(right, 0);
+				}
+				size_type half = leaf_capacity / 2;
+				for(size_type i = half; i < leaf->size; i++)
+				{
+					relocate(&right->values()[i - half], &leaf->values()[i]);
+				}
+				right->size = static_cast<unsigned short>(leaf->size - half);
+				leaf->size = static_cast<unsigned short>(half);
+				parent_of(leaf)->counts[leaf->index] -= right->size;
+				insert_child(parent_of(leaf), leaf->index + 1, Key(right->values()[0].first), right, right->size);
+				if(pos > half)
+				{
+					leaf = right;
+					pos -= half;
+				}
+			}
+			for(size_type i = leaf->size; i > pos; i--)
+			{
+				relocate(&leaf->values()[i], &leaf->values()[i - 1]);
+			}
+			move_into(&leaf->values()[pos], value);
+			leaf->size++;
+			adjust(leaf, 1);
+			count++;
+			return iterator(leaf, pos);
+		}
+
+
+		void erase_at(leaf_node *leaf, size_type pos)
+		{
+			leaf->values()[pos].~value_type();
+			for(size_type i = pos + 1; i < leaf->size; i++)
+			{
+				relocate(&leaf->values()[i - 1], &leaf->values()[i]);
+			}
+			leaf->size--;
+			adjust(leaf, -1);
+			count--;
+			rebalance(leaf);
+		}
+
+		void rebalance(leaf_node *leaf)
+		{
+			if(!leaf->parent)
+			{
+				if(leaf->size == 0)
+				{
+					delete leaf;
+					root = head = tail = nullptr;
+				}
+				return;
+			}
+			if(leaf->size >= leaf_capacity / 2)
+			{
+				return;
+			}
+			auto parent = parent_of(leaf);
+			leaf_node *left, *right;
+			if(leaf->index > 0)
+			{
+				left = static_cast<leaf_node*>(parent->children[leaf->index - 1]);
+				right = leaf;
+			}else{
+				left = leaf;
+				right = static_cast<leaf_node*>(parent->children[1]);
+			}
+			if(left->size + right->size <= leaf_capacity)
+			{
+				for(size_type i = 0; i < right->size; i++)
+				{
+					relocate(&left->values()[left->size + i], &right->values()[i]);
+				}
+				left->size += right->size;
+				right->size = 0;
+				parent->counts[left->index] += parent->counts[right->index];
+				unlink(right);
+				remove_child(parent, right->index);
+				delete right;
+				rebalance(parent);
+			}else if(left == leaf)
+			{
+				relocate(&left->values()[left->size], &right->values()[0]);
+				left->size++;
+				for(size_type i = 1; i < right->size; i++)
+				{
+					relocate(&right->values()[i - 1], &right->values()[i]);
+				}
+				right->size--;
+				parent->counts[left->index]++;
+				parent->counts[right->index]--;
+				parent->keys()[left->index] = right->values()[0].first;
+			}else{
+				for(size_type i = right->size; i > 0; i--)
+				{
+					relocate(&right->values()[i], &right->values()[i - 1]);
+				}
+				relocate(&right->values()[0], &left->values()[left->size - 1]);
+				right->size++;
+				left->size--;
+				parent->counts[left->index]--;
+				parent->counts[right->index]++;
+				parent->keys()[left->index] = right->values()[0].first;
+			}
+		}
+
+		void rebalance(inner_node *node)
+		{
+			if(!node->parent)
+			{
+				if(node->size == 1)
+				{
+					root = node->children[0];
+					root->parent = nullptr;
+					root->index = 0;
+					delete node;
+				}
+				return;
+			}
+			if(node->size >= inner_capacity / 2)
+			{
+				return;
+			}
+			auto parent = parent_of(node);
+			inner_node *left, *right;
+			if(node->index > 0)
+			{
+				left = static_cast<inner_node*>(parent->children[node->index - 1]);
+				right = node;
+			}else{
+				left = node;
+				right = static_cast<inner_node*>(parent->children[1]);
+			}
+			Key &separator = parent->keys()[left->index];
+			if(left->size + right->size <= inner_capacity)
+			{
+				new (&left->keys()[left->size - 1]) Key(std::move(separator));
+				for(size_type i = 0; i < right->size; i++)
+				{
+					if(i + 1 < right->size)
+					{
+						relocate(&left->keys()[left->size + i], &right->keys()[i]);
+					}
+					set_child(left, left->size + i, right->children[i], right->counts[i]);
+				}
+				left->size += right->size;
+				right->size = 0;
+				parent->counts[left->index] += parent->counts[right->index];
+				remove_child(parent, right->index);
+				delete right;
+				rebalance(parent);
+			}else if(left == node)
+			{
+				size_type moved = right->counts[0];
+				new (&left->keys()[left->size - 1]) Key(std::move(separator));
+				separator = std::move(right->keys()[0]);
+				right->keys()[0].~Key();
+				set_child(left, left->size, right->children[0], moved);
+				left->size++;
+				for(size_type i = 1; i < right->size; i++)
+				{
+					if(i + 1 < right->size)
+					{
+						relocate(&right->keys()[i - 1], &right->keys()[i]);
+					}
+					set_child(right, i - 1, right->children[i], right->counts[i]);
+				}
+				right->size--;
+				parent->counts[left->index] += moved;
+				parent->counts[right->index] -= moved;
+			}else{
+				size_type moved = left->counts[left->size - 1];
+				for(size_type i = right->size; i > 0; i--)
+				{
+					if(i < right->size)
+					{
+						relocate(&right->keys()[i], &right->keys()[i - 1]);
+					}
+					set_child(right, i, right->children[i - 1], right->counts[i - 1]);
+				}
+				new (&right->keys()[0]) Key(std::move(separator));
+				separator = std::move(left->keys()[left->size - 2]);
+				left->keys()[left->size - 2].~Key();
+				set_child(right, 0, left->children[left->size - 1], moved);
+				right->size++;
+				left->size--;
+				parent->counts[left->index] -= moved;
+				parent->counts[right->index] += moved;
+			}
+		}
+
+		void rebalance(node_base *node)
+		{
+			if(node->leaf)
+			{
+				rebalance(static_cast<leaf_node*>(node));
+			}else{
+				rebalance(static_cast<inner_node*>(node));
+			}
+		}
+
+	public:
+		btree_map()
+		{
+
+		}
+
+		template <class InputIterator>
+		btree_map(InputIterator first, InputIterator last)
+		{
+			insert(first, last);
+		}
+
+		btree_map(const btree_map &map) : compare(map.compare)
+		{
+			for(const auto &pair : map)
+			{
+				value_type value(pair);
+				insert_at(end(), std::move(value));
+			}
+		}
+
+		btree_map(btree_map &&map) noexcept : root(map.root), head(map.head), tail(map.tail), count(map.count), compare(std::move(map.compare))
+		{
+			map.root = map.head = map.tail = nullptr;
+			map.count = 0;
+		}
+
+		btree_map &operator=(const btree_map &map)
+		{
+			if(this != &map)
+			{
+				btree_map tmp(map);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		btree_map &operator=(btree_map &&map) noexcept
+		{
+			if(this != &map)
+			{
+				btree_map tmp(std::move(map));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		void swap(btree_map &map) noexcept
+		{
+			std::swap(root, map.root);
+			std::swap(head, map.head);
+			std::swap(tail, map.tail);
+			std::swap(count, map.count);
+			std::swap(compare, map.compare);
+		}
+
+		Value &operator[](const Key &key)
+		{
+			auto pos = locate(key);
+			if(pos.second)
+			{
+				return pos.first->second;
+			}
+			value_type value(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+			return insert_at(pos.first, std::move(value))->second;
+		}
+
+		Value &operator[](Key &&key)
+		{
+			auto pos = locate(key);
+			if(pos.second)
+			{
+				return pos.first->second;
+			}
+			value_type value(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+			return insert_at(pos.first, std::move(value))->second;
+		}
+
+		iterator begin()
+		{
+			return head ? iterator(head, 0) : iterator();
+		}
+
+		iterator end()
+		{
+			return tail ? iterator(tail, tail->size) : iterator();
+		}
+
+		const_iterator begin() const
+		{
+			return const_cast<btree_map*>(this)->begin();
+		}
+
+		const_iterator end() const
+		{
+			return const_cast<btree_map*>(this)->end();
+		}
+
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		size_type size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		void clear()
+		{
+			if(root)
+			{
+				destroy(root);
+				root = head = tail = nullptr;
+				count = 0;
+			}
+		}
+
+		iterator find(const Key &key)
+		{
+			auto pos = locate(key);
+			return pos.second ? pos.first : end();
+		}
+
+		const_iterator find(const Key &key) const
+		{
+			auto pos = locate(key);
+			return pos.second ? pos.first : end();
+		}
+
+		// The first element not ordered before the key
+		iterator lower_bound(const Key &key)
+		{
+			if(!root)
+			{
+				return end();
+			}
+			leaf_node *leaf = find_leaf(key);
+			return make_iterator(leaf, lower_index(leaf, key));
+		}
+
+		const_iterator lower_bound(const Key &key) const
+		{
+			return const_cast<btree_map*>(this)->lower_bound(key);
+		}
+
+		// The first element ordered after the key
+		iterator upper_bound(const Key &key)
+		{
+			if(!root)
+			{
+				return end();
+			}
+			leaf_node *leaf = find_leaf(key);
+			return make_iterator(leaf, upper_index(leaf, key));
+		}
+
+		const_iterator upper_bound(const Key &key) const
+		{
+			return const_cast<btree_map*>(this)->upper_bound(key);
+		}
+
+		// The element at the given position in the order, or end()
+		iterator nth(size_type index)
+		{
+			if(index >= count)
+			{
+				return end();
+			}
+			node_base *node = root;
+			while(!node->leaf)
+			{
+				auto inner = static_cast<inner_node*>(node);
+				size_type i = 0;
+				while(index >= inner->counts[i])
+				{
+					index -= inner->counts[i];
+					i++;
+				}
+				node = inner->children[i];
+			}
+			return iterator(static_cast<leaf_node*>(node), index);
+		}
+
+		const_iterator nth(size_type index) const
+		{
+			return const_cast<btree_map*>(this)->nth(index);
+		}
+
+		// The number of elements ordered before the key, whether it is present or not
+		size_type rank(const Key &key) const
+		{
+			if(!root)
+			{
+				return 0;
+			}
+			size_type index = 0;
+			node_base *node = root;
+			while(!node->leaf)
+			{
+				auto inner = static_cast<inner_node*>(node);
+				size_type lo = 0, hi = inner->size - 1;
+				while(lo < hi)
+				{
+					size_type mid = (lo + hi) / 2;
+					if(compare(key, inner->keys()[mid]))
+					{
+						hi = mid;
+					}else{
+						lo = mid + 1;
+					}
+				}
+				for(size_type i = 0; i < lo; i++)
+				{
+					index += inner->counts[i];
+				}
+				node = inner->children[lo];
+			}
+			return index + lower_index(static_cast<leaf_node*>(node), key);
+		}
+
+		// The number of elements ordered before the position
+		size_type index_of(const_iterator it) const
+		{
+			node_base *node = it.get_node();
+			if(!node)
+			{
+				return count;
+			}
+			size_type index = it.get_pos();
+			for(; node->parent; node = node->parent)
+			{
+				auto parent = parent_of(node);
+				for(unsigned short i = 0; i < node->index; i++)
+				{
+					index += parent->counts[i];
+				}
+			}
+			return index;
+		}
+
+		size_type erase(const Key &key)
+		{
+			auto pos = locate(key);
+			if(!pos.second)
+			{
+				return 0;
+			}
+			erase_at(pos.first.get_node(), pos.first.get_pos());
+			return 1;
+		}
+
+		iterator erase(const_iterator it)
+		{
+			size_type index = index_of(it);
+			erase_at(it.get_node(), it.get_pos());
+			return nth(index);
+		}
+
+		std::pair<iterator, bool> insert(const value_type &val)
+		{
+			return emplace(val);
+		}
+
+		std::pair<iterator, bool> insert(value_type &&val)
+		{
+			return emplace(std::move(val));
+		}
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last)
+		{
+			for(; first != last; ++first)
+			{
+				emplace(*first);
+			}
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			value_type value(std::forward<Args>(args)...);
+			if(tail && compare(tail->values()[tail->size - 1].first, value.first))
+			{
+				return std::make_pair(insert_at(end(), std::move(value)), true);
+			}
+			auto pos = locate(value.first);
+			if(pos.second)
+			{
+				return std::make_pair(pos.first, false);
+			}
+			return std::make_pair(insert_at(pos.first, std::move(value)), true);
+		}
+
+		~btree_map()
+		{
+			clear();
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef DIRECT_CACHE_H_INCLUDED
+#define DIRECT_CACHE_H_INCLUDED
+
+#include "fixes/linux.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace aux
+{
+	// Fixed-size direct-mapped cache from pointers to values, where a new entry simply
+	// replaces whatever occupied its slot. Values must be default-constructible to an empty state.
+	template <class Key, class Value, size_t Size = 256>
+	class direct_cache
+	{
+		static_assert(Size != 0 && (Size & (Size - 1)) == 0, "cache size must be a power of two");
+
+		struct entry
+		{
+			Key key;
+			Value value;
+		};
+
+		entry entries[Size];
+		size_t hit_count = 0;
+		size_t miss_count = 0;
+
+		static size_t slot(Key key)
+		{
+			auto ptr = reinterpret_cast<std::uintptr_t>(key);
+			// allocations are aligned, so the lowest bits carry no information
+			return static_cast<size_t>((ptr >> 4) ^ (ptr >> 12)) & (Size - 1);
+		}
+
+	public:
+		direct_cache()
+		{
+			clear();
+		}
+
+		// Returns the slot the value was stored in, to be passed to invalidate later
+		size_t set(Key key, Value value)
+		{
+			size_t index = slot(key);
+			entries[index].key = key;
+			entries[index].value = value;
+			return index;
+		}
+
+		// Entries rejected by the validator are removed
+		template <class Validator>
+		bool find(Key key, Value &value, Validator valid)
+		{
+			entry &e = entries[slot(key)];
+			if(e.key == key && e.value != Value())
+			{
+				if(valid(e.value))
+				{
+					hit_count++;
+					value = e.value;
+					return true;
+				}
+				e.key = Key();
+				e.value = Value();
+			}
+			miss_count++;
+			return false;
+		}
+
+		bool find(Key key, Value &value)
+		{
+			return find(key, value, [](const Value&) { return true; });
+		}
+
+		// Removes the value from the slot, unless it has already been replaced
+		void invalidate(size_t index, Value value)
+		{
+			entry &e = entries[index & (Size - 1)];
+			if(e.value == value)
+			{
+				e.key = Key();
+				e.value = Value();
+			}
+		}
+
+		void clear()
+		{
+			for(auto &e : entries)
+			{
+				e.key = Key();
+				e.value = Value();
+			}
+		}
+
+		size_t hits() const
+		{
+			return hit_count;
+		}
+
+		size_t misses() const
+		{
+			return miss_count;
+		}
+
+		static constexpr size_t capacity()
+		{
+			return Size;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,657 @@
+#ifndef FLAT_MAP_H_INCLUDED
+#define FLAT_MAP_H_INCLUDED
+
+#include "bits.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// MSVC targets SSE2 by default; the 32-bit GCC build enables it with -msse2 in the makefile
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace aux
+{
+	namespace impl
+	{
+		template <class Elem>
+		class flat_iterator
+		{
+			Elem *ptr;
+
+			template <class Other>
+			friend class flat_iterator;
+
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef typename std::remove_const<Elem>::type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Elem *pointer;
+			typedef Elem &reference;
+
+			flat_iterator() : ptr(nullptr)
+			{
+
+			}
+
+			explicit flat_iterator(Elem *ptr) : ptr(ptr)
+			{
+
+			}
+
+			template <class Other, class = typename std::enable_if<std::is_convertible<Other*, Elem*>::value>::type>
+			flat_iterator(const flat_iterator<Other> &it) : ptr(it.ptr)
+			{
+
+			}
+
+			Elem *get() const
+			{
+				return ptr;
+			}
+
+			reference operator*() const
+			{
+				return *ptr;
+			}
+
+			pointer operator->() const
+			{
+				return ptr;
+			}
+
+			reference operator[](difference_type n) const
+			{
+				return ptr[n];
+			}
+
+			flat_iterator &operator++()
+			{
+				++ptr;
+				return *this;
+			}
+
+			flat_iterator operator++(int)
+			{
+				return flat_iterator(ptr++);
+			}
+
+			flat_iterator &operator--()
+			{
+				--ptr;
+				return *this;
+			}
+
+			flat_iterator operator--(int)
+			{
+				return flat_iterator(ptr--);
+			}
+
+			flat_iterator &operator+=(difference_type n)
+			{
+				ptr += n;
+				return *this;
+			}
+
+			flat_iterator &operator-=(difference_type n)
+			{
+				ptr -= n;
+				return *this;
+			}
+
+			flat_iterator operator+(difference_type n) const
+			{
+				return flat_iterator(ptr + n);
+			}
+
+			flat_iterator operator-(difference_type n) const
+			{
+				return flat_iterator(ptr - n);
+			}
+
+			difference_type operator-(const flat_iterator &it) const
+			{
+				return ptr - it.ptr;
+			}
+
+			bool operator==(const flat_iterator &it) const
+			{
+				return ptr == it.ptr;
+			}
+
+			bool operator!=(const flat_iterator &it) const
+			{
+				return ptr != it.ptr;
+			}
+
+			bool operator<(const flat_iterator &it) const
+			{
+				return ptr < it.ptr;
+			}
+		};
+	}
+
+	// Open-addressing hash map with the entries stored densely in insertion order, indexed by
+	// groups of control bytes that are matched at once. Inserting does not move existing entries
+	// unless the size reaches the capacity; erasing moves the last entry to the erased position.
+	template <class Key, class Value, class Hash = std::hash<Key>, class Equal = std::equal_to<Key>>
+	class flat_map
+	{
+	public:
+		typedef std::pair<const Key, Value> value_type;
+		typedef value_type &reference;
+		typedef const value_type &const_reference;
+		typedef std::size_t size_type;
+		typedef impl::flat_iterator<value_type> iterator;
+		typedef impl::flat_iterator<const value_type> const_iterator;
+
+	private:
+		static const size_type group_size = 16;
+		enum : unsigned char
+		{
+			ctrl_empty = 0x80,
+			ctrl_deleted = 0xFE
+		};
+		static const size_type npos = static_cast<size_type>(-1);
+
+		value_type *entries = nullptr;
+		std::vector<size_t> hashes;
+		std::vector<unsigned char> ctrl;
+		std::vector<std::uint32_t> slots;
+		size_type count = 0;
+		size_type entry_capacity = 0;
+		size_type group_mask = 0;
+		size_type growth_left = 0;
+		Hash hasher;
+		Equal equal;
+
+		static size_t mix(size_t hash)
+		{
+			hash ^= hash >> 16;
+			hash *= static_cast<size_t>(0x85EBCA6Bu);
+			hash ^= hash >> 13;
+			return hash;
+		}
+
+		static unsigned char h2(size_t hash)
+		{
+			return static_cast<unsigned char>(hash & 0x7F);
+		}
+
+		static std::uint32_t match(const unsigned char *group, unsigned char value)
+		{
+#ifdef FLAT_MAP_SSE2
+			__m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+			return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(data, _mm_set1_epi8(static_cast<char>(value)))));
+#else
+			std::uint32_t mask = 0;
+			for(size_type i = 0; i < group_size; i++)
+			{
+				if(group[i] == value)
+				{
+					mask |= 1u << i;
+				}
+			}
+			return mask;
+#endif
+		}
+
+		// Empty and deleted slots are the only ones with the highest bit set
+		static std::uint32_t match_free(const unsigned char *group)
+		{
+#ifdef FLAT_MAP_SSE2
+			return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+			std::uint32_t mask = 0;
+			for(size_type i = 0; i < group_size; i++)
+			{
+				if(group[i] & 0x80)
+				{
+					mask |= 1u << i;
+				}
+			}
+			return mask;
+#endif
+		}
+
+		size_type num_groups() const
+		{
+			return ctrl.empty() ? 0 : group_mask + 1;
+		}
+
+		static size_type max_entries(size_type groups)
+		{
+			return groups * group_size / 8 * 7;
+		}
+
+		template <class Func>
+		size_type probe(size_t hash, Func func) const
+		{
+			size_type group = (hash >> 7) & group_mask;
+			for(size_type step = 0; step <= group_mask; step++)
+			{
+				const unsigned char *data = &ctrl[group * group_size];
+				size_type result = func(group * group_size, data);
+				if(result != npos)
+				{
+					return result;
+				}
+				if(match(data, ctrl_empty))
+				{
+					break;
+				}
+				group = (group + step + 1) & group_mask;
+			}
+			return npos;
+		}
+
+		template <class OtherKey, class KeyEqual>
+		size_type find_slot(const OtherKey &key, size_t hash, KeyEqual &eq) const
+		{
+			if(count == 0)
+			{
+				return npos;
+			}
+			unsigned char tag = h2(hash);
+			return probe(hash, [&](size_type base, const unsigned char *data) -> size_type
+			{
+				for(std::uint32_t mask = match(data, tag); mask; mask &= mask - 1)
+				{
+					size_type slot = base + lowest_bit(mask);
+					size_type index = slots[slot];
+					if(hashes[index] == hash && eq(key, entries[index].first))
+					{
+						return slot;
+					}
+				}
+				return npos;
+			});
+		}
+
+		size_type find_slot_of(size_type index) const
+		{
+			size_t hash = hashes[index];
+			unsigned char tag = h2(hash);
+			return probe(hash, [&](size_type base, const unsigned char *data) -> size_type
+			{
+				for(std::uint32_t mask = match(data, tag); mask; mask &= mask - 1)
+				{
+					size_type slot = base + lowest_bit(mask);
+					if(slots[slot] == index)
+					{
+						return slot;
+					}
+				}
+				return npos;
+			});
+		}
+
+		size_type free_slot(size_t hash) const
+		{
+			size_type group = (hash >> 7) & group_mask;
+			for(size_type step = 0; ; step++)
+			{
+				std::uint32_t mask = match_free(&ctrl[group * group_size]);
+				if(mask)
+				{
+					return group * group_size + lowest_bit(mask);
+				}
+				group = (group + step + 1) & group_mask;
+			}
+		}
+
+		void link(size_type index)
+		{
+			size_t hash = hashes[index];
+			size_type slot = free_slot(hash);
+			if(ctrl[slot] == ctrl_empty)
+			{
+				growth_left--;
+			}
+			ctrl[slot] = h2(hash);
+			slots[slot] = static_cast<std::uint32_t>(index);
+		}
+
+		void unlink(size_type slot)
+		{
+			// a probe never passes a group that has an empty slot, so the slot can be emptied too
+			if(match(&ctrl[slot & ~(group_size - 1)], ctrl_empty))
+			{
+				ctrl[slot] = ctrl_empty;
+				growth_left++;
+			}else{
+				ctrl[slot] = ctrl_deleted;
+			}
+		}
+
+		void rebuild_index()
+		{
+			std::fill(ctrl.begin(), ctrl.end(), ctrl_empty);
+			growth_left = entry_capacity;
+			for(size_type i = 0; i < count; i++)
+			{
+				link(i);
+			}
+		}
+
+		static void relocate(value_type *dest, value_type *src)
+		{
+			// the key is not observable while it is moved
+			new (dest) value_type(std::move(const_cast<Key&>(src->first)), std::move(src->second));
+			src->~value_type();
+		}
+
+		void grow(size_type groups)
+		{
+			size_type capacity = max_entries(groups);
+			value_type *data = static_cast<value_type*>(::operator new(capacity * sizeof(value_type)));
+			for(size_type i = 0; i < count; i++)
+			{
+				relocate(data + i, entries + i);
+			}
+			::operator delete(entries);
+			entries = data;
+			entry_capacity = capacity;
+			hashes.resize(capacity);
+			ctrl.assign(groups * group_size, ctrl_empty);
+			slots.resize(groups * group_size);
+			group_mask = groups - 1;
+			rebuild_index();
+		}
+
+		void prepare_insert()
+		{
+			if(count == entry_capacity)
+			{
+				grow(ctrl.empty() ? 1 : num_groups() * 2);
+			}else if(growth_left == 0)
+			{
+				// only deleted slots are left
+				rebuild_index();
+			}
+		}
+
+		// Links the entry constructed at the end, or destroys it if its key is already present
+		std::pair<iterator, bool> commit_insert()
+		{
+			value_type *entry = entries + count;
+			size_t hash = mix(hasher(entry->first));
+			size_type slot = find_slot(entry->first, hash, equal);
+			if(slot != npos)
+			{
+				entry->~value_type();
+				return std::make_pair(iterator(entries + slots[slot]), false);
+			}
+			hashes[count] = hash;
+			link(count);
+			count++;
+			return std::make_pair(iterator(entry), true);
+		}
+
+		void destroy()
+		{
+			for(size_type i = 0; i < count; i++)
+			{
+				entries[i].~value_type();
+			}
+			::operator delete(entries);
+			entries = nullptr;
+			count = 0;
+		}
+
+	public:
+		flat_map()
+		{
+
+		}
+
+		template <class InputIterator>
+		flat_map(InputIterator first, InputIterator last)
+		{
+			insert(first, last);
+		}
+
+		flat_map(const flat_map &map) : hasher(map.hasher), equal(map.equal)
+		{
+			reserve(map.count);
+			for(size_type i = 0; i < map.count; i++)
+			{
+				new (entries + i) value_type(map.entries[i]);
+				hashes[i] = map.hashes[i];
+				link(i);
+				count++;
+			}
+		}
+
+		flat_map(flat_map &&map) noexcept : entries(map.entries), hashes(std::move(map.hashes)), ctrl(std::move(map.ctrl)), slots(std::move(map.slots)), count(map.count), entry_capacity(map.entry_capacity), group_mask(map.group_mask), growth_left(map.growth_left), hasher(std::move(map.hasher)), equal(std::move(map.equal))
+		{
+			map.entries = nullptr;
+			map.hashes.clear();
+			map.ctrl.clear();
+			map.slots.clear();
+			map.count = 0;
+			map.entry_capacity = 0;
+			map.group_mask = 0;
+			map.growth_left = 0;
+		}
+
+		flat_map &operator=(const flat_map &map)
+		{
+			if(this != &map)
+			{
+				flat_map tmp(map);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		flat_map &operator=(flat_map &&map) noexcept
+		{
+			if(this != &map)
+			{
+				flat_map tmp(std::move(map));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		void swap(flat_map &map) noexcept
+		{
+			std::swap(entries, map.entries);
+			hashes.swap(map.hashes);
+			ctrl.swap(map.ctrl);
+			slots.swap(map.slots);
+			std::swap(count, map.count);
+			std::swap(entry_capacity, map.entry_capacity);
+			std::swap(group_mask, map.group_mask);
+			std::swap(growth_left, map.growth_left);
+			std::swap(hasher, map.hasher);
+			std::swap(equal, map.equal);
+		}
+
+		Value &operator[](const Key &key)
+		{
+			return emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first->second;
+		}
+
+		Value &operator[](Key &&key)
+		{
+			return emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple()).first->second;
+		}
+
+		iterator begin()
+		{
+			return iterator(entries);
+		}
+
+		iterator end()
+		{
+			return iterator(entries + count);
+		}
+
+		const_iterator begin() const
+		{
+			return const_iterator(entries);
+		}
+
+		const_iterator end() const
+		{
+			return const_iterator(entries + count);
+		}
+
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		size_type size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		size_type capacity() const
+		{
+			return entry_capacity;
+		}
+
+		void reserve(size_type size)
+		{
+			if(size > entry_capacity)
+			{
+				size_type groups = ctrl.empty() ? 1 : num_groups();
+				while(max_entries(groups) < size)
+				{
+					groups *= 2;
+				}
+				grow(groups);
+			}
+		}
+
+		void clear()
+		{
+			for(size_type i = 0; i < count; i++)
+			{
+				entries[i].~value_type();
+			}
+			count = 0;
+			std::fill(ctrl.begin(), ctrl.end(), ctrl_empty);
+			growth_left = entry_capacity;
+		}
+
+		// Finds an entry by any key that hashes like the stored key it is equal to
+		template <class OtherKey, class KeyEqual>
+		iterator find(const OtherKey &key, size_t hash, KeyEqual eq)
+		{
+			size_type slot = find_slot(key, mix(hash), eq);
+			return slot == npos ? end() : iterator(entries + slots[slot]);
+		}
+
+		template <class OtherKey, class KeyEqual>
+		const_iterator find(const OtherKey &key, size_t hash, KeyEqual eq) const
+		{
+			size_type slot = find_slot(key, mix(hash), eq);
+			return slot == npos ? end() : const_iterator(entries + slots[slot]);
+		}
+
+		iterator find(const Key &key)
+		{
+			return find(key, hasher(key), equal);
+		}
+
+		const_iterator find(const Key &key) const
+		{
+			return find(key, hasher(key), equal);
+		}
+
+		size_type erase(const Key &key)
+		{
+			size_type slot = find_slot(key, mix(hasher(key)), equal);
+			if(slot == npos)
+			{
+				return 0;
+			}
+			erase_at(slot);
+			return 1;
+		}
+
+		iterator erase(const_iterator it)
+		{
+			size_type index = it.get() - entries;
+			erase_at(find_slot_of(index));
+			return iterator(entries + index);
+		}
+
+	private:
+		void erase_at(size_type slot)
+		{
+			size_type index = slots[slot];
+			unlink(slot);
+			entries[index].~value_type();
+			size_type last = count - 1;
+			if(index != last)
+			{
+				slots[find_slot_of(last)] = static_cast<std::uint32_t>(index);
+				relocate(entries + index, entries + last);
+				hashes[index] = hashes[last];
+			}
+			count--;
+		}
+
+	public:
+		std::pair<iterator, bool> insert(const value_type &val)
+		{
+			return emplace(val);
+		}
+
+		std::pair<iterator, bool> insert(value_type &&val)
+		{
+			return emplace(std::move(val));
+		}
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last)
+		{
+			for(; first != last; ++first)
+			{
+				emplace(*first);
+			}
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			prepare_insert();
+			new (entries + count) value_type(std::forward<Args>(args)...);
+			return commit_insert();
+		}
+
+		~flat_map()
+		{
+			destroy();
+		}
+	};
+}
+
+#endif
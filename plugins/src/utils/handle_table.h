@@ -0,0 +1,254 @@
+#ifndef HANDLE_TABLE_H_INCLUDED
+#define HANDLE_TABLE_H_INCLUDED
+
+#include "fixes/linux.h"
+#include "sdk/amx/amx.h"
+#include <vector>
+#include <memory>
+#include <limits>
+#include <stdexcept>
+
+namespace aux
+{
+	// Stores values under handles composed of a slot index and a generation.
+	// The generation is bumped when a slot is freed, so a stale handle
+	// no longer matches once the slot is reused for another value.
+	// Freed slots are reused in FIFO order and only once enough of them are queued,
+	// so a single slot cycles through its generations slowly. The generation wraps around,
+	// so a stale handle may match again, but only after its slot has been reused
+	// generation_mask + 1 times, which takes at least (generation_mask + 1) * min_free_slots
+	// (2^19) allocations while the table has room for new slots.
+	template <class Value>
+	class slot_table
+	{
+	public:
+		static constexpr unsigned int index_bits = 22;
+		static constexpr unsigned int generation_bits = 31 - index_bits;
+		static constexpr ucell index_mask = (static_cast<ucell>(1) << index_bits) - 1;
+		static constexpr ucell generation_mask = (static_cast<ucell>(1) << generation_bits) - 1;
+
+		static constexpr size_t min_free_slots = 1024;
+
+	private:
+		static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+		struct slot
+		{
+			Value value;
+			ucell generation;
+			size_t next_free;
+			bool used;
+		};
+
+		std::vector<slot> slots;
+		size_t free_head = npos;
+		size_t free_tail = npos;
+		size_t free_count = 0;
+		size_t count = 0;
+
+		slot *find_slot(cell handle)
+		{
+			size_t index = index_of(handle);
+			if(index >= slots.size())
+			{
+				return nullptr;
+			}
+			slot &s = slots[index];
+			if(!s.used || s.generation != static_cast<ucell>(handle) >> index_bits)
+			{
+				return nullptr;
+			}
+			return &s;
+		}
+
+	public:
+		// The slot of a handle, not checked against the table
+		static size_t index_of(cell handle)
+		{
+			// index 0 is never assigned, so a null handle wraps around and fails the bounds check
+			return static_cast<size_t>((static_cast<ucell>(handle) & index_mask) - 1);
+		}
+
+		cell handle_of(size_t index) const
+		{
+			return static_cast<cell>((slots[index].generation << index_bits) | static_cast<ucell>(index + 1));
+		}
+
+		cell add(Value &&value)
+		{
+			size_t index;
+			if(free_count >= min_free_slots || (free_count > 0 && slots.size() >= index_mask))
+			{
+				index = free_head;
+				free_head = slots[index].next_free;
+				if(free_head == npos)
+				{
+					free_tail = npos;
+				}
+				free_count--;
+			}else{
+				index = slots.size();
+				if(index >= index_mask)
+				{
+					throw std::length_error("handle table is full");
+				}
+				slots.push_back(slot{Value(), 0, npos, false});
+			}
+			slot &s = slots[index];
+			s.value = std::move(value);
+			s.used = true;
+			count++;
+			return handle_of(index);
+		}
+
+		Value *find(cell handle)
+		{
+			slot *s = find_slot(handle);
+			return s ? &s->value : nullptr;
+		}
+
+		const Value *find(cell handle) const
+		{
+			return const_cast<slot_table*>(this)->find(handle);
+		}
+
+		// The value in a used slot
+		Value &operator[](size_t index)
+		{
+			return slots[index].value;
+		}
+
+		const Value &operator[](size_t index) const
+		{
+			return slots[index].value;
+		}
+
+		// Frees a used slot, invalidating its handle
+		Value release(size_t index)
+		{
+			slot &s = slots[index];
+			Value value = std::move(s.value);
+			s.value = Value();
+			s.used = false;
+			count--;
+			s.generation = (s.generation + 1) & generation_mask;
+			s.next_free = npos;
+			if(free_tail != npos)
+			{
+				slots[free_tail].next_free = index;
+			}else{
+				free_head = index;
+			}
+			free_tail = index;
+			free_count++;
+			return value;
+		}
+
+		// The values are destroyed after the table is consistent again
+		void clear()
+		{
+			std::vector<Value> released;
+			released.reserve(count);
+			for(size_t i = 0; i < slots.size(); i++)
+			{
+				if(slots[i].used)
+				{
+					released.push_back(release(i));
+				}
+			}
+		}
+
+		template <class Func>
+		void for_each(Func func) const
+		{
+			for(const auto &s : slots)
+			{
+				if(s.used)
+				{
+					func(s.value);
+				}
+			}
+		}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		size_t capacity() const
+		{
+			return slots.size();
+		}
+
+		size_t memory_size() const
+		{
+			return slots.size() * sizeof(slot);
+		}
+	};
+
+	// Owns objects under slot_table handles
+	template <class Type>
+	class handle_table
+	{
+		slot_table<std::shared_ptr<Type>> slots;
+
+	public:
+		cell add(std::shared_ptr<Type> &&value)
+		{
+			return slots.add(std::move(value));
+		}
+
+		Type *get(cell handle)
+		{
+			auto value = slots.find(handle);
+			return value ? value->get() : nullptr;
+		}
+
+		bool get(cell handle, std::shared_ptr<Type> &value)
+		{
+			auto found = slots.find(handle);
+			if(found)
+			{
+				value = *found;
+				return true;
+			}
+			return false;
+		}
+
+		// The object is returned so that it is destroyed after the table is consistent again
+		std::shared_ptr<Type> extract(cell handle)
+		{
+			if(slots.find(handle))
+			{
+				return slots.release(slots.index_of(handle));
+			}
+			return {};
+		}
+
+		void clear()
+		{
+			slots.clear();
+		}
+
+		template <class Func>
+		void for_each(Func func) const
+		{
+			slots.for_each([&](const std::shared_ptr<Type> &value)
+			{
+				func(*value);
+			});
+		}
+
+		size_t size() const
+		{
+			return slots.size();
+		}
+
+		size_t capacity() const
+		{
+			return slots.capacity();
+		}
+	};
+}
+
+#endif
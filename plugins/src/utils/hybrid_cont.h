@@ -2,6 +2,9 @@
 #define HYBRID_CONT_H_INCLUDED
 
 #include <type_traits>
+#include <iterator>
+#include <cstring>
+#include <new>
 
 #if __GNUG__ && __GNUC__ < 5
 #define is_trivially_copyable(T) __has_trivial_copy(T)
@@ -259,6 +262,339 @@ namespace aux
 				}
 			}
 		};
+
+		// Iterator over one of five containers, chosen at runtime
+		template <class first_iterator, class second_iterator, class third_iterator, class fourth_iterator, class fifth_iterator>
+		class hybrid_iterator5
+		{
+			template <class, class, class, class, class>
+			friend class hybrid_iterator5;
+
+			union {
+				first_iterator iterator1;
+				second_iterator iterator2;
+				third_iterator iterator3;
+				fourth_iterator iterator4;
+				fifth_iterator iterator5;
+			};
+			unsigned char kind;
+
+			static constexpr bool trivial = is_trivially_copyable(first_iterator) && is_trivially_copyable(second_iterator) && is_trivially_copyable(third_iterator) && is_trivially_copyable(fourth_iterator) && is_trivially_copyable(fifth_iterator) && is_trivially_destructible(first_iterator) && is_trivially_destructible(second_iterator) && is_trivially_destructible(third_iterator) && is_trivially_destructible(fourth_iterator) && is_trivially_destructible(fifth_iterator);
+
+			void construct(const hybrid_iterator5 &it)
+			{
+				kind = it.kind;
+				switch(kind)
+				{
+					case 0:
+						new (&iterator1) first_iterator(it.iterator1);
+						break;
+					case 1:
+						new (&iterator2) second_iterator(it.iterator2);
+						break;
+					case 2:
+						new (&iterator3) third_iterator(it.iterator3);
+						break;
+					case 3:
+						new (&iterator4) fourth_iterator(it.iterator4);
+						break;
+					default:
+						new (&iterator5) fifth_iterator(it.iterator5);
+						break;
+				}
+			}
+
+			void destroy()
+			{
+				if(!trivial)
+				{
+					switch(kind)
+					{
+						case 0:
+							iterator1.~first_iterator();
+							break;
+						case 1:
+							iterator2.~second_iterator();
+							break;
+						case 2:
+							iterator3.~third_iterator();
+							break;
+						case 3:
+							iterator4.~fourth_iterator();
+							break;
+						default:
+							iterator5.~fifth_iterator();
+							break;
+					}
+				}
+			}
+
+			template <class Iterator>
+			static void dec(Iterator &it, std::input_iterator_tag)
+			{
+
+			}
+
+			template <class Iterator>
+			static void dec(Iterator &it, std::bidirectional_iterator_tag)
+			{
+				--it;
+			}
+
+			template <class Iterator>
+			static void dec(Iterator &it)
+			{
+				dec(it, typename std::iterator_traits<Iterator>::iterator_category());
+			}
+
+		public:
+			typedef typename impl::assert_same<typename first_iterator::difference_type, typename impl::assert_same<typename second_iterator::difference_type, typename impl::assert_same<typename third_iterator::difference_type, typename impl::assert_same<typename fourth_iterator::difference_type, typename fifth_iterator::difference_type>::type>::type>::type>::type difference_type;
+			typedef typename impl::assert_same<typename first_iterator::value_type, typename impl::assert_same<typename second_iterator::value_type, typename impl::assert_same<typename third_iterator::value_type, typename impl::assert_same<typename fourth_iterator::value_type, typename fifth_iterator::value_type>::type>::type>::type>::type value_type;
+			typedef typename impl::assert_same<typename first_iterator::pointer, typename impl::assert_same<typename second_iterator::pointer, typename impl::assert_same<typename third_iterator::pointer, typename impl::assert_same<typename fourth_iterator::pointer, typename fifth_iterator::pointer>::type>::type>::type>::type pointer;
+			typedef typename impl::assert_same<typename first_iterator::reference, typename impl::assert_same<typename second_iterator::reference, typename impl::assert_same<typename third_iterator::reference, typename impl::assert_same<typename fourth_iterator::reference, typename fifth_iterator::reference>::type>::type>::type>::type reference;
+			typedef std::bidirectional_iterator_tag iterator_category;
+
+			hybrid_iterator5() : iterator1(), kind(0)
+			{
+
+			}
+
+			hybrid_iterator5(const first_iterator &it) : iterator1(it), kind(0)
+			{
+
+			}
+
+			hybrid_iterator5(const second_iterator &it) : iterator2(it), kind(1)
+			{
+
+			}
+
+			hybrid_iterator5(const third_iterator &it) : iterator3(it), kind(2)
+			{
+
+			}
+
+			hybrid_iterator5(const fourth_iterator &it) : iterator4(it), kind(3)
+			{
+
+			}
+
+			hybrid_iterator5(const fifth_iterator &it) : iterator5(it), kind(4)
+			{
+
+			}
+
+			hybrid_iterator5(const hybrid_iterator5 &it)
+			{
+				if(trivial)
+				{
+					std::memcpy(this, &it, sizeof(it));
+				}else{
+					construct(it);
+				}
+			}
+
+			template <class first_other, class second_other, class third_other, class fourth_other, class fifth_other, class = typename std::enable_if<std::is_convertible<first_other, first_iterator>::value>::type>
+			hybrid_iterator5(const hybrid_iterator5<first_other, second_other, third_other, fourth_other, fifth_other> &it) : kind(it.kind)
+			{
+				switch(kind)
+				{
+					case 0:
+						new (&iterator1) first_iterator(it.iterator1);
+						break;
+					case 1:
+						new (&iterator2) second_iterator(it.iterator2);
+						break;
+					case 2:
+						new (&iterator3) third_iterator(it.iterator3);
+						break;
+					case 3:
+						new (&iterator4) fourth_iterator(it.iterator4);
+						break;
+					default:
+						new (&iterator5) fifth_iterator(it.iterator5);
+						break;
+				}
+			}
+
+			operator first_iterator&()
+			{
+				return iterator1;
+			}
+
+			operator second_iterator&()
+			{
+				return iterator2;
+			}
+
+			operator third_iterator&()
+			{
+				return iterator3;
+			}
+
+			operator fourth_iterator&()
+			{
+				return iterator4;
+			}
+
+			operator fifth_iterator&()
+			{
+				return iterator5;
+			}
+
+			operator const first_iterator&() const
+			{
+				return iterator1;
+			}
+
+			operator const second_iterator&() const
+			{
+				return iterator2;
+			}
+
+			operator const third_iterator&() const
+			{
+				return iterator3;
+			}
+
+			operator const fourth_iterator&() const
+			{
+				return iterator4;
+			}
+
+			operator const fifth_iterator&() const
+			{
+				return iterator5;
+			}
+
+			hybrid_iterator5 &operator=(const hybrid_iterator5 &it)
+			{
+				if(this != &it)
+				{
+					if(trivial)
+					{
+						std::memcpy(this, &it, sizeof(it));
+					}else{
+						destroy();
+						construct(it);
+					}
+				}
+				return *this;
+			}
+
+			reference operator*() const
+			{
+				switch(kind)
+				{
+					case 0:
+						return *iterator1;
+					case 1:
+						return *iterator2;
+					case 2:
+						return *iterator3;
+					case 3:
+						return *iterator4;
+					default:
+						return *iterator5;
+				}
+			}
+
+			pointer operator->() const
+			{
+				return &**this;
+			}
+
+			hybrid_iterator5 &operator++()
+			{
+				switch(kind)
+				{
+					case 0:
+						++iterator1;
+						break;
+					case 1:
+						++iterator2;
+						break;
+					case 2:
+						++iterator3;
+						break;
+					case 3:
+						++iterator4;
+						break;
+					default:
+						++iterator5;
+						break;
+				}
+				return *this;
+			}
+
+			hybrid_iterator5 operator++(int)
+			{
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			hybrid_iterator5 &operator--()
+			{
+				switch(kind)
+				{
+					case 0:
+						dec(iterator1);
+						break;
+					case 1:
+						dec(iterator2);
+						break;
+					case 2:
+						dec(iterator3);
+						break;
+					case 3:
+						dec(iterator4);
+						break;
+					default:
+						dec(iterator5);
+						break;
+				}
+				return *this;
+			}
+
+			hybrid_iterator5 operator--(int)
+			{
+				auto tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			bool operator==(const hybrid_iterator5 &obj) const
+			{
+				if(kind != obj.kind)
+				{
+					return false;
+				}
+				switch(kind)
+				{
+					case 0:
+						return iterator1 == obj.iterator1;
+					case 1:
+						return iterator2 == obj.iterator2;
+					case 2:
+						return iterator3 == obj.iterator3;
+					case 3:
+						return iterator4 == obj.iterator4;
+					default:
+						return iterator5 == obj.iterator5;
+				}
+			}
+
+			bool operator!=(const hybrid_iterator5 &obj) const
+			{
+				return !(*this == obj);
+			}
+
+			~hybrid_iterator5()
+			{
+				destroy();
+			}
+		};
 	}
 }
 
@@ -2,95 +2,223 @@
 #define HYBRID_MAP_H_INCLUDED
 
 #include "hybrid_cont.h"
+#include "flat_map.h"
+#include "ranked_map.h"
+#include "btree_map.h"
+#include "persistent_map.h"
 
 #include <unordered_map>
-#include <map>
+#include <iterator>
 #include <cstring>
 
 namespace aux
 {
+	// Only the unordered and ordered modes keep elements in place when other elements are
+	// inserted or erased, so that references to them obtained through the API stay valid;
+	// btree is an opt-in alternative to ordered and never its default
+	enum class hybrid_map_mode : unsigned char
+	{
+		unordered,
+		ordered,
+		flat,
+		persistent,
+		btree
+	};
+
 	template <class Key, class Value>
 	class hybrid_map
 	{
 		typedef std::unordered_map<Key, Value> unordered_map;
-		typedef std::map<Key, Value> ordered_map;
+		typedef aux::ranked_map<Key, Value> ordered_map;
+		typedef aux::flat_map<Key, Value> flat_map;
+		typedef aux::persistent_map<Key, Value> persistent_map;
+		typedef aux::btree_map<Key, Value> btree_map;
 		union {
 			unordered_map umap;
 			ordered_map omap;
+			flat_map fmap;
+			persistent_map pmap;
+			btree_map bmap;
 		};
-		bool ordered;
+		hybrid_map_mode mode;
+
+		void construct(hybrid_map_mode mode)
+		{
+			switch(mode)
+			{
+				case hybrid_map_mode::unordered:
+					new (&umap) unordered_map();
+					break;
+				case hybrid_map_mode::ordered:
+					new (&omap) ordered_map();
+					break;
+				case hybrid_map_mode::btree:
+					new (&bmap) btree_map();
+					break;
+				case hybrid_map_mode::flat:
+					new (&fmap) flat_map();
+					break;
+				case hybrid_map_mode::persistent:
+					new (&pmap) persistent_map();
+					break;
+			}
+			this->mode = mode;
+		}
+
+		void destroy()
+		{
+			switch(mode)
+			{
+				case hybrid_map_mode::unordered:
+					umap.~unordered_map();
+					break;
+				case hybrid_map_mode::ordered:
+					omap.~ordered_map();
+					break;
+				case hybrid_map_mode::btree:
+					bmap.~btree_map();
+					break;
+				case hybrid_map_mode::flat:
+					fmap.~flat_map();
+					break;
+				case hybrid_map_mode::persistent:
+					pmap.~persistent_map();
+					break;
+			}
+		}
+
+		void construct(const hybrid_map<Key, Value> &map)
+		{
+			switch(map.mode)
+			{
+				case hybrid_map_mode::unordered:
+					new (&umap) unordered_map(map.umap);
+					break;
+				case hybrid_map_mode::ordered:
+					new (&omap) ordered_map(map.omap);
+					break;
+				case hybrid_map_mode::btree:
+					new (&bmap) btree_map(map.bmap);
+					break;
+				case hybrid_map_mode::flat:
+					new (&fmap) flat_map(map.fmap);
+					break;
+				case hybrid_map_mode::persistent:
+					new (&pmap) persistent_map(map.pmap);
+					break;
+			}
+			mode = map.mode;
+		}
+
+		void construct(hybrid_map<Key, Value> &&map)
+		{
+			switch(map.mode)
+			{
+				case hybrid_map_mode::unordered:
+					new (&umap) unordered_map(std::move(map.umap));
+					break;
+				case hybrid_map_mode::ordered:
+					new (&omap) ordered_map(std::move(map.omap));
+					break;
+				case hybrid_map_mode::btree:
+					new (&bmap) btree_map(std::move(map.bmap));
+					break;
+				case hybrid_map_mode::flat:
+					new (&fmap) flat_map(std::move(map.fmap));
+					break;
+				case hybrid_map_mode::persistent:
+					new (&pmap) persistent_map(std::move(map.pmap));
+					break;
+			}
+			mode = map.mode;
+		}
+
+		template <class Container>
+		void construct_from(Container &source, hybrid_map_mode mode)
+		{
+			auto first = std::make_move_iterator(source.begin());
+			auto last = std::make_move_iterator(source.end());
+			switch(mode)
+			{
+				case hybrid_map_mode::unordered:
+					new (&umap) unordered_map(first, last);
+					break;
+				case hybrid_map_mode::ordered:
+					new (&omap) ordered_map(first, last);
+					break;
+				case hybrid_map_mode::btree:
+					new (&bmap) btree_map(first, last);
+					break;
+				case hybrid_map_mode::flat:
+					new (&fmap) flat_map(first, last);
+					break;
+				case hybrid_map_mode::persistent:
+					new (&pmap) persistent_map(first, last);
+					break;
+			}
+			this->mode = mode;
+		}
 
 	public:
-		typedef impl::hybrid_iterator<typename unordered_map::iterator, typename ordered_map::iterator> iterator;
-		typedef impl::hybrid_iterator<typename unordered_map::const_iterator, typename ordered_map::const_iterator> const_iterator;
+		typedef impl::hybrid_iterator5<typename unordered_map::iterator, typename ordered_map::iterator, typename flat_map::iterator, typename persistent_map::iterator, typename btree_map::iterator> iterator;
+		typedef impl::hybrid_iterator5<typename unordered_map::const_iterator, typename ordered_map::const_iterator, typename flat_map::const_iterator, typename persistent_map::const_iterator, typename btree_map::const_iterator> const_iterator;
 		typedef typename impl::assert_same<typename unordered_map::reference, typename ordered_map::reference>::type reference;
 		typedef typename impl::assert_same<typename unordered_map::const_reference, typename ordered_map::const_reference>::type const_reference;
 		typedef typename impl::assert_same<typename unordered_map::value_type, typename ordered_map::value_type>::type value_type;
 		typedef typename impl::assert_same<typename unordered_map::size_type, typename ordered_map::size_type>::type size_type;
 
-		hybrid_map() : umap(), ordered(false)
+		hybrid_map() : umap(), mode(hybrid_map_mode::unordered)
 		{
-		
+
 		}
 
-		hybrid_map(bool ordered) : ordered(ordered)
+		hybrid_map(bool ordered)
 		{
-			if(ordered)
-			{
-				new (&omap) ordered_map();
-			}else{
-				new (&umap) unordered_map();
-			}
+			construct(ordered ? hybrid_map_mode::ordered : hybrid_map_mode::unordered);
 		}
 
-		hybrid_map(const unordered_map &map) : umap(map), ordered(false)
+		hybrid_map(hybrid_map_mode mode)
 		{
-
+			construct(mode);
 		}
 
-		hybrid_map(unordered_map &&map) : umap(std::move(map)), ordered(false)
+		hybrid_map(const unordered_map &map) : umap(map), mode(hybrid_map_mode::unordered)
 		{
 
 		}
 
-		hybrid_map(const ordered_map &map) : omap(map), ordered(true)
+		hybrid_map(unordered_map &&map) : umap(std::move(map)), mode(hybrid_map_mode::unordered)
 		{
 
 		}
 
+		hybrid_map(const ordered_map &map) : omap(map), mode(hybrid_map_mode::ordered)
+		{
 
-		hybrid_map(ordered_map &&map) : omap(std::move(map)), ordered(true)
+		}
+
+		hybrid_map(ordered_map &&map) : omap(std::move(map)), mode(hybrid_map_mode::ordered)
 		{
 
 		}
 
-		hybrid_map(const hybrid_map<Key, Value> &map) : ordered(map.ordered)
+		hybrid_map(const hybrid_map<Key, Value> &map)
 		{
-			if(ordered)
-			{
-				new (&omap) ordered_map(map.omap);
-			}else{
-				new (&umap) unordered_map(map.umap);
-			}
+			construct(map);
 		}
 
-		hybrid_map(hybrid_map<Key, Value> &&map) : ordered(map.ordered)
+		hybrid_map(hybrid_map<Key, Value> &&map)
 		{
-			if(ordered)
-			{
-				new (&omap) ordered_map(std::move(map.omap));
-			}else{
-				new (&umap) unordered_map(std::move(map.umap));
-			}
+			construct(std::move(map));
 		}
 
 		hybrid_map<Key, Value> &operator=(const unordered_map &map)
 		{
-			if(ordered)
+			if(mode != hybrid_map_mode::unordered)
 			{
-				omap.~ordered_map();
+				destroy();
 				new (&umap) unordered_map(map);
-				ordered = false;
+				mode = hybrid_map_mode::unordered;
 			}else{
 				umap = map;
 			}
@@ -99,24 +227,24 @@ namespace aux
 
 		hybrid_map<Key, Value> &operator=(unordered_map &&map)
 		{
-			if(ordered)
+			if(mode != hybrid_map_mode::unordered)
 			{
-				omap.~ordered_map();
+				destroy();
 				new (&umap) unordered_map(std::move(map));
-				ordered = false;
+				mode = hybrid_map_mode::unordered;
 			}else{
 				umap = std::move(map);
 			}
 			return *this;
 		}
-	
+
 		hybrid_map<Key, Value> &operator=(const ordered_map &map)
 		{
-			if(!ordered)
+			if(mode != hybrid_map_mode::ordered)
 			{
-				umap.~unordered_map();
+				destroy();
 				new (&omap) ordered_map(map);
-				ordered = true;
+				mode = hybrid_map_mode::ordered;
 			}else{
 				omap = map;
 			}
@@ -125,11 +253,11 @@ namespace aux
 
 		hybrid_map<Key, Value> &operator=(ordered_map &&map)
 		{
-			if(!ordered)
+			if(mode != hybrid_map_mode::ordered)
 			{
-				umap.~unordered_map();
+				destroy();
 				new (&omap) ordered_map(std::move(map));
-				ordered = true;
+				mode = hybrid_map_mode::ordered;
 			}else{
 				omap = std::move(map);
 			}
@@ -138,290 +266,599 @@ namespace aux
 
 		hybrid_map<Key, Value> &operator=(const hybrid_map<Key, Value> &map)
 		{
-			if(ordered && map.ordered)
-			{
-				omap = map.omap;
-			}else if(!ordered && !map.ordered)
+			if(this == &map)
 			{
-				umap = map.umap;
-			}else if(ordered)
+				return *this;
+			}
+			if(mode == map.mode)
 			{
-				omap.~ordered_map();
-				new (&umap) unordered_map(map.umap);
-				ordered = false;
+				switch(mode)
+				{
+					case hybrid_map_mode::unordered:
+						umap = map.umap;
+						break;
+					case hybrid_map_mode::ordered:
+						omap = map.omap;
+						break;
+					case hybrid_map_mode::btree:
+						bmap = map.bmap;
+						break;
+					case hybrid_map_mode::flat:
+						fmap = map.fmap;
+						break;
+					case hybrid_map_mode::persistent:
+						pmap = map.pmap;
+						break;
+				}
 			}else{
-				umap.~unordered_map();
-				new (&omap) ordered_map(map.omap);
-				ordered = true;
+				destroy();
+				construct(map);
 			}
 			return *this;
 		}
 
 		hybrid_map<Key, Value> &operator=(hybrid_map<Key, Value> &&map)
 		{
-			if(ordered && map.ordered)
-			{
-				omap = std::move(map.omap);
-			}else if(!ordered && !map.ordered)
+			if(this == &map)
 			{
-				umap = std::move(map.umap);
-			}else if(ordered)
+				return *this;
+			}
+			if(mode == map.mode)
 			{
-				omap.~ordered_map();
-				new (&umap) unordered_map(std::move(map.umap));
-				ordered = false;
+				switch(mode)
+				{
+					case hybrid_map_mode::unordered:
+						umap = std::move(map.umap);
+						break;
+					case hybrid_map_mode::ordered:
+						omap = std::move(map.omap);
+						break;
+					case hybrid_map_mode::btree:
+						bmap = std::move(map.bmap);
+						break;
+					case hybrid_map_mode::flat:
+						fmap = std::move(map.fmap);
+						break;
+					case hybrid_map_mode::persistent:
+						pmap = std::move(map.pmap);
+						break;
+				}
 			}else{
-				umap.~unordered_map();
-				new (&omap) ordered_map(std::move(map.omap));
-				ordered = true;
+				destroy();
+				construct(std::move(map));
 			}
 			return *this;
 		}
 
 		Value &operator[](const Key &key)
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap[key];
-			}else{
-				return umap[key];
+				case hybrid_map_mode::ordered:
+					return omap[key];
+				case hybrid_map_mode::btree:
+					return bmap[key];
+				case hybrid_map_mode::flat:
+					return fmap[key];
+				case hybrid_map_mode::persistent:
+					return pmap[key];
+				default:
+					return umap[key];
 			}
 		}
 
 		Value &operator[](Key &&key)
 		{
-			if(ordered)
-			{
-				return omap[std::move(key)];
-			} else {
-				return umap[std::move(key)];
-			}
-		}
-
-		const Value &operator[](const Key &key) const
-		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap[key];
-			}else{
-				return umap[key];
+				case hybrid_map_mode::ordered:
+					return omap[std::move(key)];
+				case hybrid_map_mode::btree:
+					return bmap[std::move(key)];
+				case hybrid_map_mode::flat:
+					return fmap[std::move(key)];
+				case hybrid_map_mode::persistent:
+					return pmap[std::move(key)];
+				default:
+					return umap[std::move(key)];
 			}
 		}
 
 		iterator begin()
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap.begin();
-			}else{
-				return umap.begin();
+				case hybrid_map_mode::ordered:
+					return omap.begin();
+				case hybrid_map_mode::btree:
+					return bmap.begin();
+				case hybrid_map_mode::flat:
+					return fmap.begin();
+				case hybrid_map_mode::persistent:
+					return pmap.begin();
+				default:
+					return umap.begin();
 			}
 		}
-		
+
 		iterator end()
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap.end();
-			}else{
-				return umap.end();
+				case hybrid_map_mode::ordered:
+					return omap.end();
+				case hybrid_map_mode::btree:
+					return bmap.end();
+				case hybrid_map_mode::flat:
+					return fmap.end();
+				case hybrid_map_mode::persistent:
+					return pmap.end();
+				default:
+					return umap.end();
 			}
 		}
 
 		const_iterator begin() const
 		{
-			if(ordered)
-			{
-				return omap.begin();
-			}else{
-				return umap.begin();
-			}
+			return cbegin();
 		}
 
 		const_iterator end() const
 		{
-			if(ordered)
-			{
-				return omap.end();
-			}else{
-				return umap.end();
-			}
+			return cend();
 		}
 
 		const_iterator cbegin() const
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap.cbegin();
-			}else{
-				return umap.cbegin();
+				case hybrid_map_mode::ordered:
+					return omap.cbegin();
+				case hybrid_map_mode::btree:
+					return bmap.cbegin();
+				case hybrid_map_mode::flat:
+					return fmap.cbegin();
+				case hybrid_map_mode::persistent:
+					return pmap.cbegin();
+				default:
+					return umap.cbegin();
 			}
 		}
 
 		const_iterator cend() const
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap.cend();
-			}else{
-				return umap.cend();
+				case hybrid_map_mode::ordered:
+					return omap.cend();
+				case hybrid_map_mode::btree:
+					return bmap.cend();
+				case hybrid_map_mode::flat:
+					return fmap.cend();
+				case hybrid_map_mode::persistent:
+					return pmap.cend();
+				default:
+					return umap.cend();
 			}
 		}
 
-		size_type count() const
+		size_type size() const
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap.count();
-			}else{
-				return umap.count();
+				case hybrid_map_mode::ordered:
+					return omap.size();
+				case hybrid_map_mode::btree:
+					return bmap.size();
+				case hybrid_map_mode::flat:
+					return fmap.size();
+				case hybrid_map_mode::persistent:
+					return pmap.size();
+				default:
+					return umap.size();
 			}
 		}
 
-		size_type size() const
+		size_type capacity() const
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap.size();
-			}else{
-				return umap.size();
+				case hybrid_map_mode::ordered:
+				case hybrid_map_mode::btree:
+				case hybrid_map_mode::persistent:
+					return -1;
+				case hybrid_map_mode::flat:
+					return fmap.capacity();
+				default:
+					return static_cast<size_type>(umap.bucket_count() * umap.max_load_factor());
 			}
 		}
 
-		size_type capacity() const
+		// Whether inserting an element may move the existing ones
+		bool insert_relocates() const
 		{
-			if(ordered)
-			{
-				return -1;
-			}else{
-				return static_cast<size_type>(umap.bucket_count() * umap.max_load_factor());
-			}
+			return mode == hybrid_map_mode::btree || mode == hybrid_map_mode::persistent || size() == capacity();
 		}
 
 		void reserve(size_type count)
 		{
-			if(!ordered)
+			switch(mode)
 			{
-				umap.reserve(count);
+				case hybrid_map_mode::unordered:
+					umap.reserve(count);
+					break;
+				case hybrid_map_mode::flat:
+					fmap.reserve(count);
+					break;
+				default:
+					break;
 			}
 		}
 
 		void clear()
 		{
-			if(ordered)
+			switch(mode)
 			{
-				omap.clear();
-			}else{
-				umap.clear();
+				case hybrid_map_mode::ordered:
+					omap.clear();
+					break;
+				case hybrid_map_mode::btree:
+					bmap.clear();
+					break;
+				case hybrid_map_mode::flat:
+					fmap.clear();
+					break;
+				case hybrid_map_mode::persistent:
+					pmap.clear();
+					break;
+				default:
+					umap.clear();
+					break;
 			}
 		}
 
 		iterator find(const Key &key)
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap.find(key);
-			}else{
-				return umap.find(key);
+				case hybrid_map_mode::ordered:
+					return omap.find(key);
+				case hybrid_map_mode::btree:
+					return bmap.find(key);
+				case hybrid_map_mode::flat:
+					return fmap.find(key);
+				case hybrid_map_mode::persistent:
+					return pmap.find(key);
+				default:
+					return umap.find(key);
 			}
 		}
 
 		const_iterator find(const Key &key) const
 		{
-			if(ordered)
+			switch(mode)
+			{
+				case hybrid_map_mode::ordered:
+					return omap.find(key);
+				case hybrid_map_mode::btree:
+					return bmap.find(key);
+				case hybrid_map_mode::flat:
+					return fmap.find(key);
+				case hybrid_map_mode::persistent:
+					return pmap.find(key);
+				default:
+					return umap.find(key);
+			}
+		}
+
+		// Finds a key by a lightweight probe that provides hash() and matches(key) consistent
+		// with the key it stands for, and key() to create it for the modes that need one
+		template <class Probe>
+		iterator find_as(const Probe &probe)
+		{
+			switch(mode)
+			{
+				case hybrid_map_mode::ordered:
+					return omap.find(probe.key());
+				case hybrid_map_mode::btree:
+					return bmap.find(probe.key());
+				case hybrid_map_mode::flat:
+					return fmap.find(probe, probe.hash(), [](const Probe &probe, const Key &key)
+					{
+						return probe.matches(key);
+					});
+				case hybrid_map_mode::persistent:
+					return pmap.find(probe, probe.hash(), [](const Probe &probe, const Key &key)
+					{
+						return probe.matches(key);
+					});
+				default:
+					// std::unordered_map has no heterogeneous lookup before C++20
+					return umap.find(probe.key());
+			}
+		}
+
+		template <class Probe>
+		const_iterator find_as(const Probe &probe) const
+		{
+			switch(mode)
+			{
+				case hybrid_map_mode::ordered:
+					return omap.find(probe.key());
+				case hybrid_map_mode::btree:
+					return bmap.find(probe.key());
+				case hybrid_map_mode::flat:
+					return fmap.find(probe, probe.hash(), [](const Probe &probe, const Key &key)
+					{
+						return probe.matches(key);
+					});
+				case hybrid_map_mode::persistent:
+					return pmap.find(probe, probe.hash(), [](const Probe &probe, const Key &key)
+					{
+						return probe.matches(key);
+					});
+				default:
+					return umap.find(probe.key());
+			}
+		}
+
+		// The element at the position in the iteration order, logarithmic for ordered maps
+		// and constant for flat maps
+		iterator nth(size_type index)
+		{
+			switch(mode)
+			{
+				case hybrid_map_mode::ordered:
+					return omap.nth(index);
+				case hybrid_map_mode::btree:
+					return bmap.nth(index);
+				case hybrid_map_mode::flat:
+					return index < fmap.size() ? fmap.begin() + index : fmap.end();
+				case hybrid_map_mode::persistent:
+				{
+					if(index >= pmap.size())
+					{
+						return pmap.end();
+					}
+					auto it = pmap.begin();
+					std::advance(it, index);
+					return it;
+				}
+				default:
+				{
+					if(index >= umap.size())
+					{
+						return umap.end();
+					}
+					auto it = umap.begin();
+					std::advance(it, index);
+					return it;
+				}
+			}
+		}
+
+		size_type index_of(iterator it)
+		{
+			switch(mode)
 			{
-				return omap.find(key);
-			}else{
-				return umap.find(key);
+				case hybrid_map_mode::btree:
+					return bmap.index_of(static_cast<typename btree_map::iterator&>(it));
+				case hybrid_map_mode::flat:
+					return static_cast<typename flat_map::iterator&>(it) - fmap.begin();
+				case hybrid_map_mode::ordered:
+					return omap.index_of(static_cast<typename ordered_map::iterator&>(it));
+				case hybrid_map_mode::persistent:
+					return std::distance(pmap.begin(), static_cast<typename persistent_map::iterator&>(it));
+				default:
+					return std::distance(umap.begin(), static_cast<typename unordered_map::iterator&>(it));
 			}
 		}
 
+		// The number of keys ordered before the key; only valid for ordered maps
+		size_type rank(const Key &key) const
+		{
+			if(mode == hybrid_map_mode::btree)
+			{
+				return bmap.rank(key);
+			}
+			return omap.index_of(omap.lower_bound(key));
+		}
+
 		size_type erase(const Key &key)
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap.erase(key);
-			}else{
-				return umap.erase(key);
+				case hybrid_map_mode::ordered:
+					return omap.erase(key);
+				case hybrid_map_mode::btree:
+					return bmap.erase(key);
+				case hybrid_map_mode::flat:
+					return fmap.erase(key);
+				case hybrid_map_mode::persistent:
+					return pmap.erase(key);
+				default:
+					return umap.erase(key);
 			}
 		}
 
 		iterator erase(iterator it)
 		{
-			if(ordered)
+			switch(mode)
 			{
-				return omap.erase(it);
-			}else{
-				return umap.erase(it);
+				case hybrid_map_mode::ordered:
+					return omap.erase(static_cast<typename ordered_map::iterator&>(it));
+				case hybrid_map_mode::btree:
+					return bmap.erase(static_cast<typename btree_map::iterator&>(it));
+				case hybrid_map_mode::flat:
+					return fmap.erase(static_cast<typename flat_map::iterator&>(it));
+				case hybrid_map_mode::persistent:
+					return pmap.erase(static_cast<typename persistent_map::iterator&>(it));
+				default:
+					return umap.erase(static_cast<typename unordered_map::iterator&>(it));
 			}
 		}
 
 		std::pair<iterator, bool> insert(value_type &&val)
 		{
-			if(ordered)
+			switch(mode)
 			{
-				auto pair = omap.insert(std::move(val));
-				return std::make_pair(iterator(pair.first), pair.second);
-			}else{
-				auto pair = umap.insert(std::move(val));
-				return std::make_pair(iterator(pair.first), pair.second);
+				case hybrid_map_mode::ordered:
+				{
+					auto pair = omap.insert(std::move(val));
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
+				case hybrid_map_mode::btree:
+				{
+					auto pair = bmap.insert(std::move(val));
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
+				case hybrid_map_mode::flat:
+				{
+					auto pair = fmap.insert(std::move(val));
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
+				case hybrid_map_mode::persistent:
+				{
+					auto pair = pmap.insert(std::move(val));
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
+				default:
+				{
+					auto pair = umap.insert(std::move(val));
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
 			}
 		}
 
 		template<class... Args>
 		std::pair<iterator, bool> emplace(Args&&... args)
 		{
-			if(ordered)
+			switch(mode)
 			{
-				auto pair = omap.emplace(std::forward<Args>(args)...);
-				return std::make_pair(iterator(pair.first), pair.second);
-			}else{
-				auto pair = umap.emplace(std::forward<Args>(args)...);
-				return std::make_pair(iterator(pair.first), pair.second);
+				case hybrid_map_mode::ordered:
+				{
+					auto pair = omap.emplace(std::forward<Args>(args)...);
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
+				case hybrid_map_mode::btree:
+				{
+					auto pair = bmap.emplace(std::forward<Args>(args)...);
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
+				case hybrid_map_mode::flat:
+				{
+					auto pair = fmap.emplace(std::forward<Args>(args)...);
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
+				case hybrid_map_mode::persistent:
+				{
+					auto pair = pmap.emplace(std::forward<Args>(args)...);
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
+				default:
+				{
+					auto pair = umap.emplace(std::forward<Args>(args)...);
+					return std::make_pair(iterator(pair.first), pair.second);
+				}
 			}
 		}
 
 		template <class InputIterator>
 		void insert(InputIterator first, InputIterator last)
 		{
-			if(ordered)
+			switch(mode)
 			{
-				omap.insert(first, last);
-			}else{
-				umap.insert(first, last);
+				case hybrid_map_mode::ordered:
+					omap.insert(first, last);
+					break;
+				case hybrid_map_mode::btree:
+					bmap.insert(first, last);
+					break;
+				case hybrid_map_mode::flat:
+					fmap.insert(first, last);
+					break;
+				case hybrid_map_mode::persistent:
+					pmap.insert(first, last);
+					break;
+				default:
+					umap.insert(first, last);
+					break;
 			}
 		}
 
 		bool is_ordered() const
 		{
-			return ordered;
+			return mode == hybrid_map_mode::ordered || mode == hybrid_map_mode::btree;
 		}
 
-		bool set_ordered(bool ordered)
+		hybrid_map_mode get_mode() const
 		{
-			if(this->ordered != ordered)
+			return mode;
+		}
+
+		bool set_mode(hybrid_map_mode mode)
+		{
+			if(this->mode != mode)
 			{
-				if(this->ordered)
+				hybrid_map<Key, Value> tmp(std::move(*this));
+				destroy();
+				switch(tmp.mode)
 				{
-					std::unordered_map<Key, Value> map(std::make_move_iterator(omap.begin()), std::make_move_iterator(omap.end()));
-					*this = std::move(map);
-				}else{
-					std::map<Key, Value> map(std::make_move_iterator(umap.begin()), std::make_move_iterator(umap.end()));
-					*this = std::move(map);
+					case hybrid_map_mode::unordered:
+						construct_from(tmp.umap, mode);
+						break;
+					case hybrid_map_mode::ordered:
+						construct_from(tmp.omap, mode);
+						break;
+					case hybrid_map_mode::btree:
+						construct_from(tmp.bmap, mode);
+						break;
+					case hybrid_map_mode::flat:
+						construct_from(tmp.fmap, mode);
+						break;
+					case hybrid_map_mode::persistent:
+						construct_from(tmp.pmap, mode);
+						break;
 				}
 				return true;
 			}
 			return false;
 		}
 
-		void swap(hybrid_map<Key, Value> &map)
+		bool set_ordered(bool ordered)
 		{
-			if(ordered && map.ordered)
+			if(ordered)
 			{
-				std::swap(omap, map.omap);
-			}else if(!ordered && !map.ordered)
+				return !is_ordered() && set_mode(hybrid_map_mode::ordered);
+			}else if(is_ordered())
 			{
-				std::swap(umap, map.umap);
+				return set_mode(hybrid_map_mode::unordered);
+			}
+			return false;
+		}
+
+		void swap(hybrid_map<Key, Value> &map)
+		{
+			if(mode == map.mode)
+			{
+				switch(mode)
+				{
+					case hybrid_map_mode::unordered:
+						std::swap(umap, map.umap);
+						break;
+					case hybrid_map_mode::ordered:
+						std::swap(omap, map.omap);
+						break;
+					case hybrid_map_mode::btree:
+						std::swap(bmap, map.bmap);
+						break;
+					case hybrid_map_mode::flat:
+						fmap.swap(map.fmap);
+						break;
+					case hybrid_map_mode::persistent:
+						pmap.swap(map.pmap);
+						break;
+				}
 			}else{
 				hybrid_map<Key, Value> tmp(std::move(map));
 				map = std::move(*this);
@@ -431,12 +868,7 @@ namespace aux
 
 		~hybrid_map()
 		{
-			if(ordered)
-			{
-				omap.~ordered_map();
-			}else{
-				umap.~unordered_map();
-			}
+			destroy();
 		}
 	};
 }
@@ -0,0 +1,422 @@
+#ifndef NODE_LIST_H_INCLUDED
+#define NODE_LIST_H_INCLUDED
+
+#include "slab_allocator.h"
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace aux
+{
+	// Doubly linked list storing the values inline in slab-allocated nodes.
+	// A pinned node outlives its removal from the list, so that the holder of the pin can detect it.
+	template <class Type>
+	class node_list
+	{
+		struct node_base
+		{
+			node_base *prev;
+			node_base *next;
+		};
+
+		struct node : public node_base
+		{
+			unsigned int pins = 0;
+			bool linked = true;
+			union {
+				Type value;
+			};
+
+			node()
+			{
+
+			}
+
+			~node()
+			{
+
+			}
+		};
+
+		typedef slab_allocator<node> allocator;
+
+		node_base head;
+		size_t count;
+
+		template <class... Args>
+		static node *create(Args &&...args)
+		{
+			node *ptr = allocator().allocate(1);
+			new (ptr) node();
+			try{
+				new (&ptr->value) Type(std::forward<Args>(args)...);
+			}catch(...)
+			{
+				destroy(ptr);
+				throw;
+			}
+			return ptr;
+		}
+
+		static void destroy(node *ptr) noexcept
+		{
+			ptr->~node();
+			allocator().deallocate(ptr, 1);
+		}
+
+		node_base *link(node_base *position, node *ptr) noexcept
+		{
+			ptr->prev = position->prev;
+			ptr->next = position;
+			position->prev->next = ptr;
+			position->prev = ptr;
+			++count;
+			return ptr;
+		}
+
+		node_base *unlink(node_base *position) noexcept
+		{
+			node_base *next = position->next;
+			position->prev->next = next;
+			next->prev = position->prev;
+			--count;
+
+			auto ptr = static_cast<node*>(position);
+			ptr->linked = false;
+			ptr->value.~Type();
+			if(ptr->pins == 0)
+			{
+				destroy(ptr);
+			}
+			return next;
+		}
+
+		void reset() noexcept
+		{
+			head.prev = head.next = &head;
+			count = 0;
+		}
+
+		void steal(node_list &obj) noexcept
+		{
+			if(obj.count == 0)
+			{
+				reset();
+				return;
+			}
+			head = obj.head;
+			head.prev->next = &head;
+			head.next->prev = &head;
+			count = obj.count;
+			obj.reset();
+		}
+
+	public:
+		template <class Value>
+		class basic_iterator
+		{
+			friend class node_list;
+			template <class Other>
+			friend class basic_iterator;
+
+			node_base *ptr;
+
+			explicit basic_iterator(node_base *ptr) noexcept : ptr(ptr)
+			{
+
+			}
+
+		public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef typename std::remove_const<Value>::type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Value *pointer;
+			typedef Value &reference;
+
+			basic_iterator() noexcept : ptr(nullptr)
+			{
+
+			}
+
+			template <class Other, class = typename std::enable_if<std::is_convertible<Other*, Value*>::value>::type>
+			basic_iterator(const basic_iterator<Other> &obj) noexcept : ptr(obj.ptr)
+			{
+
+			}
+
+			reference operator*() const
+			{
+				return static_cast<node*>(ptr)->value;
+			}
+
+			pointer operator->() const
+			{
+				return &static_cast<node*>(ptr)->value;
+			}
+
+			basic_iterator &operator++()
+			{
+				ptr = ptr->next;
+				return *this;
+			}
+
+			basic_iterator operator++(int)
+			{
+				basic_iterator tmp(*this);
+				ptr = ptr->next;
+				return tmp;
+			}
+
+			basic_iterator &operator--()
+			{
+				ptr = ptr->prev;
+				return *this;
+			}
+
+			basic_iterator operator--(int)
+			{
+				basic_iterator tmp(*this);
+				ptr = ptr->prev;
+				return tmp;
+			}
+
+			template <class Other>
+			bool operator==(const basic_iterator<Other> &obj) const
+			{
+				return ptr == obj.ptr;
+			}
+
+			template <class Other>
+			bool operator!=(const basic_iterator<Other> &obj) const
+			{
+				return ptr != obj.ptr;
+			}
+		};
+
+		typedef basic_iterator<Type> iterator;
+		typedef basic_iterator<const Type> const_iterator;
+		typedef Type value_type;
+		typedef Type &reference;
+		typedef const Type &const_reference;
+		typedef size_t size_type;
+
+		// Keeps the node of an element allocated until released
+		class pin
+		{
+			node *ptr;
+
+		public:
+			pin() noexcept : ptr(nullptr)
+			{
+
+			}
+
+			explicit pin(iterator position) noexcept : ptr(static_cast<node*>(position.ptr))
+			{
+				++ptr->pins;
+			}
+
+			pin(const pin &obj) noexcept : ptr(obj.ptr)
+			{
+				if(ptr)
+				{
+					++ptr->pins;
+				}
+			}
+
+			pin &operator=(const pin &obj) noexcept
+			{
+				if(ptr != obj.ptr)
+				{
+					reset();
+					ptr = obj.ptr;
+					if(ptr)
+					{
+						++ptr->pins;
+					}
+				}
+				return *this;
+			}
+
+			~pin()
+			{
+				reset();
+			}
+
+			void reset() noexcept
+			{
+				if(ptr)
+				{
+					if(--ptr->pins == 0 && !ptr->linked)
+					{
+						destroy(ptr);
+					}
+					ptr = nullptr;
+				}
+			}
+
+			// Whether the element was removed from the list
+			bool expired() const noexcept
+			{
+				return !ptr || !ptr->linked;
+			}
+
+			bool operator==(const pin &obj) const noexcept
+			{
+				return ptr == obj.ptr;
+			}
+		};
+
+		node_list() noexcept
+		{
+			reset();
+		}
+
+		node_list(const node_list &obj) : node_list()
+		{
+			insert(end(), obj.begin(), obj.end());
+		}
+
+		node_list(node_list &&obj) noexcept
+		{
+			steal(obj);
+		}
+
+		node_list &operator=(const node_list &obj)
+		{
+			if(this != &obj)
+			{
+				clear();
+				insert(end(), obj.begin(), obj.end());
+			}
+			return *this;
+		}
+
+		node_list &operator=(node_list &&obj) noexcept
+		{
+			if(this != &obj)
+			{
+				clear();
+				steal(obj);
+			}
+			return *this;
+		}
+
+		~node_list()
+		{
+			clear();
+		}
+
+		iterator begin() noexcept
+		{
+			return iterator(head.next);
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(&head);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(head.next);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(const_cast<node_base*>(&head));
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		bool empty() const noexcept
+		{
+			return count == 0;
+		}
+
+		void clear() noexcept
+		{
+			node_base *ptr = head.next;
+			while(ptr != &head)
+			{
+				ptr = unlink(ptr);
+			}
+		}
+
+		template <class... Args>
+		iterator emplace(const_iterator position, Args &&...args)
+		{
+			return iterator(link(position.ptr, create(std::forward<Args>(args)...)));
+		}
+
+		iterator insert(const_iterator position, const Type &value)
+		{
+			return emplace(position, value);
+		}
+
+		iterator insert(const_iterator position, Type &&value)
+		{
+			return emplace(position, std::move(value));
+		}
+
+		template <class InputIterator>
+		iterator insert(const_iterator position, InputIterator first, InputIterator last)
+		{
+			iterator result(position.ptr);
+			bool inserted = false;
+			for(; first != last; ++first)
+			{
+				iterator it = emplace(position, *first);
+				if(!inserted)
+				{
+					result = it;
+					inserted = true;
+				}
+			}
+			return result;
+		}
+
+		void push_back(const Type &value)
+		{
+			emplace(end(), value);
+		}
+
+		void push_back(Type &&value)
+		{
+			emplace(end(), std::move(value));
+		}
+
+		iterator erase(const_iterator position) noexcept
+		{
+			return iterator(unlink(position.ptr));
+		}
+
+		iterator erase(const_iterator first, const_iterator last) noexcept
+		{
+			node_base *ptr = first.ptr;
+			while(ptr != last.ptr)
+			{
+				ptr = unlink(ptr);
+			}
+			return iterator(ptr);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef OWNER_LIST_H_INCLUDED
+#define OWNER_LIST_H_INCLUDED
+
+#include "fixes/linux.h"
+#include "sdk/amx/amx.h"
+#include <unordered_map>
+#include <vector>
+#include <tuple>
+#include <utility>
+
+namespace aux
+{
+	// The AMX whose code is currently running, maintained by the context stack.
+	// Objects created while it is set are linked to its owner list.
+	inline AMX *&object_owner()
+	{
+		static AMX *owner = nullptr;
+		return owner;
+	}
+
+	template <class Type>
+	class owner_table;
+
+	template <class Type>
+	class owner_link
+	{
+		friend class owner_table<Type>;
+
+		Type *object = nullptr;
+		owner_link *prev = nullptr;
+		owner_link *next = nullptr;
+		size_t *count = nullptr;
+
+	public:
+		owner_link()
+		{
+
+		}
+
+		owner_link(const owner_link&)
+		{
+
+		}
+
+		owner_link &operator=(const owner_link&)
+		{
+			return *this;
+		}
+
+		bool linked() const
+		{
+			return count != nullptr;
+		}
+	};
+
+	// Intrusive per-owner lists of objects, so that everything created by one script
+	// can be found (or released) in time proportional to what it owns.
+	template <class Type>
+	class owner_table
+	{
+		struct owner_list
+		{
+			owner_link<Type> head;
+			size_t count = 0;
+
+			owner_list()
+			{
+				head.prev = &head;
+				head.next = &head;
+			}
+
+			owner_list(const owner_list&) = delete;
+			owner_list &operator=(const owner_list&) = delete;
+		};
+
+		std::unordered_map<AMX*, owner_list> lists;
+
+	public:
+		void link(owner_link<Type> &link, Type *object)
+		{
+			AMX *owner = object_owner();
+			if(owner == nullptr || link.linked())
+			{
+				return;
+			}
+			auto it = lists.find(owner);
+			if(it == lists.end())
+			{
+				it = lists.emplace(std::piecewise_construct, std::forward_as_tuple(owner), std::forward_as_tuple()).first;
+			}
+			auto &list = it->second;
+			link.object = object;
+			link.prev = list.head.prev;
+			link.next = &list.head;
+			link.prev->next = &link;
+			list.head.prev = &link;
+			link.count = &list.count;
+			list.count++;
+		}
+
+		static void unlink(owner_link<Type> &link)
+		{
+			if(!link.linked())
+			{
+				return;
+			}
+			link.prev->next = link.next;
+			link.next->prev = link.prev;
+			(*link.count)--;
+			link.prev = nullptr;
+			link.next = nullptr;
+			link.count = nullptr;
+		}
+
+		size_t count(AMX *owner) const
+		{
+			auto it = lists.find(owner);
+			if(it != lists.end())
+			{
+				return it->second.count;
+			}
+			return 0;
+		}
+
+		std::vector<Type*> objects(AMX *owner) const
+		{
+			std::vector<Type*> result;
+			auto it = lists.find(owner);
+			if(it != lists.end())
+			{
+				auto &head = it->second.head;
+				result.reserve(it->second.count);
+				for(auto link = head.next; link != &head; link = link->next)
+				{
+					result.push_back(link->object);
+				}
+			}
+			return result;
+		}
+
+		template <class Func>
+		void for_each(AMX *owner, Func func) const
+		{
+			auto it = lists.find(owner);
+			if(it != lists.end())
+			{
+				auto &head = it->second.head;
+				for(auto link = head.next; link != &head; link = link->next)
+				{
+					func(*link->object);
+				}
+			}
+		}
+
+		// Detaches all objects from the owner without releasing them
+		void forget(AMX *owner)
+		{
+			auto it = lists.find(owner);
+			if(it != lists.end())
+			{
+				auto &head = it->second.head;
+				while(head.next != &head)
+				{
+					unlink(*head.next);
+				}
+				lists.erase(it);
+			}
+		}
+
+		void clear()
+		{
+			for(auto &pair : lists)
+			{
+				auto &head = pair.second.head;
+				while(head.next != &head)
+				{
+					unlink(*head.next);
+				}
+			}
+			lists.clear();
+		}
+	};
+}
+
+#endif
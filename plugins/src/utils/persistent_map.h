@@ -0,0 +1,752 @@
+#ifndef PERSISTENT_MAP_H_INCLUDED
+#define PERSISTENT_MAP_H_INCLUDED
+
+#include "bits.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aux
+{
+	// Hash array mapped trie whose nodes are shared between copies. Copying is constant,
+	// and a modification copies only the nodes on the path to the modified entry.
+	template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+	class persistent_map
+	{
+	public:
+		typedef std::pair<const Key, Value> value_type;
+		typedef value_type &reference;
+		typedef const value_type &const_reference;
+		typedef size_t size_type;
+
+	private:
+		static constexpr unsigned int level_bits = 5;
+		static constexpr unsigned int hash_bits = 32;
+		// the levels indexed by the hash are followed by one level of colliding keys
+		static constexpr unsigned int max_depth = (hash_bits + level_bits - 1) / level_bits;
+		static constexpr unsigned char end_depth = 0xFF;
+
+		struct node
+		{
+			std::atomic<unsigned int> refs;
+			std::uint32_t datamap;
+			std::uint32_t nodemap;
+			std::vector<value_type> entries;
+			std::vector<node*> children;
+
+			node() : refs(1), datamap(0), nodemap(0)
+			{
+
+			}
+
+			node(const node &obj) : refs(1), datamap(obj.datamap), nodemap(obj.nodemap), entries(obj.entries), children(obj.children)
+			{
+				for(node *child : children)
+				{
+					child->refs.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		};
+
+		node *root;
+		size_type count;
+
+		static void release(node *ptr) noexcept
+		{
+			if(ptr && ptr->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				for(node *child : ptr->children)
+				{
+					release(child);
+				}
+				delete ptr;
+			}
+		}
+
+		// Makes the node in the slot owned only by its parent
+		static node *unshare(node *&slot)
+		{
+			if(slot->refs.load(std::memory_order_acquire) != 1)
+			{
+				node *copy = new node(*slot);
+				release(slot);
+				slot = copy;
+			}
+			return slot;
+		}
+
+		static std::uint32_t fold_hash(size_t hash)
+		{
+			return static_cast<std::uint32_t>(hash ^ (hash >> 16 >> 16));
+		}
+
+		static std::uint32_t hash_key(const Key &key)
+		{
+			return fold_hash(Hash()(key));
+		}
+
+		static bool collision_level(unsigned int depth)
+		{
+			return depth >= max_depth;
+		}
+
+		static std::uint32_t fragment_bit(std::uint32_t hash, unsigned int depth)
+		{
+			return std::uint32_t(1) << ((hash >> (depth * level_bits)) & 31);
+		}
+
+		static size_t bit_index(std::uint32_t map, std::uint32_t bit)
+		{
+			return count_bits(map & (bit - 1));
+		}
+
+		static void relocate(std::vector<value_type> &dest, value_type &src)
+		{
+			dest.emplace_back(std::move(const_cast<Key&>(src.first)), std::move(src.second));
+		}
+
+		static void insert_entry(node *ptr, size_t index, value_type &value)
+		{
+			std::vector<value_type> result;
+			result.reserve(ptr->entries.size() + 1);
+			for(size_t i = 0; i < ptr->entries.size(); i++)
+			{
+				if(i == index)
+				{
+					relocate(result, value);
+				}
+				relocate(result, ptr->entries[i]);
+			}
+			if(index == ptr->entries.size())
+			{
+				relocate(result, value);
+			}
+			ptr->entries.swap(result);
+		}
+
+		static void erase_entry(node *ptr, size_t index)
+		{
+			std::vector<value_type> result;
+			result.reserve(ptr->entries.size() - 1);
+			for(size_t i = 0; i < ptr->entries.size(); i++)
+			{
+				if(i != index)
+				{
+					relocate(result, ptr->entries[i]);
+				}
+			}
+			ptr->entries.swap(result);
+		}
+
+	public:
+		template <class Elem, class Slot>
+		class basic_iterator
+		{
+			friend class persistent_map;
+
+			template <class OtherElem, class OtherSlot>
+			friend class basic_iterator;
+
+		public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef typename std::remove_const<Elem>::type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Elem *pointer;
+			typedef Elem &reference;
+
+		private:
+			// the position is kept as the path from the root, so that it stays valid when nodes are copied
+			Slot *root;
+			unsigned char depth;
+			unsigned char path[max_depth];
+			std::uint32_t entry;
+
+			explicit basic_iterator(Slot *root) : root(root), depth(end_depth), entry(0)
+			{
+
+			}
+
+			void set_end()
+			{
+				depth = end_depth;
+				entry = 0;
+			}
+
+			void trace(const node **nodes) const
+			{
+				nodes[0] = *root;
+				for(unsigned int d = 0; d < depth; d++)
+				{
+					nodes[d + 1] = nodes[d]->children[path[d]];
+				}
+			}
+
+			void first(const node **nodes)
+			{
+				while(nodes[depth]->entries.empty())
+				{
+					path[depth] = 0;
+					nodes[depth + 1] = nodes[depth]->children[0];
+					++depth;
+				}
+				entry = 0;
+			}
+
+			void last(const node **nodes)
+			{
+				while(!nodes[depth]->children.empty())
+				{
+					path[depth] = static_cast<unsigned char>(nodes[depth]->children.size() - 1);
+					nodes[depth + 1] = nodes[depth]->children.back();
+					++depth;
+				}
+				entry = static_cast<std::uint32_t>(nodes[depth]->entries.size() - 1);
+			}
+
+			static value_type &access(node *&slot, const unsigned char *path, unsigned int depth, std::uint32_t entry)
+			{
+				node *ptr = unshare(slot);
+				for(unsigned int d = 0; d < depth; d++)
+				{
+					ptr = unshare(ptr->children[path[d]]);
+				}
+				return ptr->entries[entry];
+			}
+
+			static const value_type &access(node *const &slot, const unsigned char *path, unsigned int depth, std::uint32_t entry)
+			{
+				const node *ptr = slot;
+				for(unsigned int d = 0; d < depth; d++)
+				{
+					ptr = ptr->children[path[d]];
+				}
+				return ptr->entries[entry];
+			}
+
+		public:
+			basic_iterator() : root(nullptr), depth(end_depth), entry(0)
+			{
+
+			}
+
+			// Converting to a const iterator gives access to the element without unsharing
+			template <class OtherElem, class OtherSlot, class = typename std::enable_if<std::is_convertible<OtherElem*, Elem*>::value>::type>
+			basic_iterator(const basic_iterator<OtherElem, OtherSlot> &it) : root(it.root), depth(it.depth), entry(it.entry)
+			{
+				std::memcpy(path, it.path, sizeof(path));
+			}
+
+			// Accessing the element through a mutable iterator unshares the nodes on its path
+			reference operator*() const
+			{
+				return access(*root, path, depth, entry);
+			}
+
+			pointer operator->() const
+			{
+				return &**this;
+			}
+
+			basic_iterator &operator++()
+			{
+				const node *nodes[max_depth + 1];
+				trace(nodes);
+				if(entry + 1 < nodes[depth]->entries.size())
+				{
+					++entry;
+					return *this;
+				}
+				unsigned int d = depth;
+				size_t child = 0;
+				while(true)
+				{
+					if(child < nodes[d]->children.size())
+					{
+						path[d] = static_cast<unsigned char>(child);
+						nodes[d + 1] = nodes[d]->children[child];
+						depth = d + 1;
+						first(nodes);
+						return *this;
+					}
+					if(d == 0)
+					{
+						set_end();
+						return *this;
+					}
+					--d;
+					child = path[d] + 1;
+				}
+			}
+
+			basic_iterator operator++(int)
+			{
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			basic_iterator &operator--()
+			{
+				const node *nodes[max_depth + 1];
+				if(depth == end_depth)
+				{
+					if(*root)
+					{
+						depth = 0;
+						nodes[0] = *root;
+						last(nodes);
+					}
+					return *this;
+				}
+				if(entry > 0)
+				{
+					--entry;
+					return *this;
+				}
+				trace(nodes);
+				unsigned int d = depth;
+				while(d > 0)
+				{
+					--d;
+					if(path[d] > 0)
+					{
+						--path[d];
+						nodes[d + 1] = nodes[d]->children[path[d]];
+						depth = d + 1;
+						last(nodes);
+						return *this;
+					}
+					if(!nodes[d]->entries.empty())
+					{
+						depth = d;
+						entry = static_cast<std::uint32_t>(nodes[d]->entries.size() - 1);
+						return *this;
+					}
+				}
+				set_end();
+				return *this;
+			}
+
+			basic_iterator operator--(int)
+			{
+				auto tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			bool operator==(const basic_iterator &obj) const
+			{
+				return depth == obj.depth && entry == obj.entry && (depth == end_depth || std::memcmp(path, obj.path, depth) == 0);
+			}
+
+			bool operator!=(const basic_iterator &obj) const
+			{
+				return !(*this == obj);
+			}
+		};
+
+		typedef basic_iterator<value_type, node*> iterator;
+		typedef basic_iterator<const value_type, node *const> const_iterator;
+
+	private:
+		template <class Iterator, class OtherKey, class OtherEqual>
+		Iterator locate(Iterator it, const OtherKey &key, std::uint32_t hash, OtherEqual eq) const
+		{
+			const node *ptr = root;
+			if(!ptr)
+			{
+				return it;
+			}
+			for(unsigned int d = 0; ; d++)
+			{
+				if(collision_level(d))
+				{
+					for(size_t i = 0; i < ptr->entries.size(); i++)
+					{
+						if(eq(key, ptr->entries[i].first))
+						{
+							it.depth = d;
+							it.entry = static_cast<std::uint32_t>(i);
+							return it;
+						}
+					}
+					return it;
+				}
+				std::uint32_t bit = fragment_bit(hash, d);
+				if(ptr->datamap & bit)
+				{
+					size_t index = bit_index(ptr->datamap, bit);
+					if(eq(key, ptr->entries[index].first))
+					{
+						it.depth = d;
+						it.entry = static_cast<std::uint32_t>(index);
+					}
+					return it;
+				}
+				if(!(ptr->nodemap & bit))
+				{
+					return it;
+				}
+				size_t index = bit_index(ptr->nodemap, bit);
+				it.path[d] = static_cast<unsigned char>(index);
+				ptr = ptr->children[index];
+			}
+		}
+
+		// Stores two entries with the same hash fragments up to the depth in a new subtree
+		static void merge(node *ptr, value_type &a, std::uint32_t hash_a, value_type &b, std::uint32_t hash_b, unsigned int depth, iterator &pos)
+		{
+			if(collision_level(depth))
+			{
+				relocate(ptr->entries, a);
+				relocate(ptr->entries, b);
+				pos.depth = depth;
+				pos.entry = 1;
+				return;
+			}
+			std::uint32_t bit_a = fragment_bit(hash_a, depth), bit_b = fragment_bit(hash_b, depth);
+			if(bit_a == bit_b)
+			{
+				ptr->nodemap = bit_a;
+				ptr->children.push_back(new node());
+				pos.path[depth] = 0;
+				merge(ptr->children[0], a, hash_a, b, hash_b, depth + 1, pos);
+				return;
+			}
+			ptr->datamap = bit_a | bit_b;
+			if(bit_a < bit_b)
+			{
+				relocate(ptr->entries, a);
+				relocate(ptr->entries, b);
+				pos.entry = 1;
+			}else{
+				relocate(ptr->entries, b);
+				relocate(ptr->entries, a);
+				pos.entry = 0;
+			}
+			pos.depth = depth;
+		}
+
+		// Adds a key that is not present in the subtree
+		static void insert_new(node *&slot, value_type &value, std::uint32_t hash, unsigned int depth, iterator &pos)
+		{
+			node *ptr = unshare(slot);
+			if(collision_level(depth))
+			{
+				relocate(ptr->entries, value);
+				pos.depth = depth;
+				pos.entry = static_cast<std::uint32_t>(ptr->entries.size() - 1);
+				return;
+			}
+			std::uint32_t bit = fragment_bit(hash, depth);
+			if(ptr->nodemap & bit)
+			{
+				size_t index = bit_index(ptr->nodemap, bit);
+				pos.path[depth] = static_cast<unsigned char>(index);
+				insert_new(ptr->children[index], value, hash, depth + 1, pos);
+				return;
+			}
+			size_t index = bit_index(ptr->datamap, bit);
+			if(ptr->datamap & bit)
+			{
+				// the existing entry is moved to a new subtree together with the new one
+				value_type &existing = ptr->entries[index];
+				size_t child_index = bit_index(ptr->nodemap, bit);
+				ptr->children.insert(ptr->children.begin() + child_index, new node());
+				ptr->nodemap |= bit;
+				pos.path[depth] = static_cast<unsigned char>(child_index);
+				merge(ptr->children[child_index], existing, hash_key(existing.first), value, hash, depth + 1, pos);
+				erase_entry(ptr, index);
+				ptr->datamap ^= bit;
+				return;
+			}
+			insert_entry(ptr, index, value);
+			ptr->datamap |= bit;
+			pos.depth = depth;
+			pos.entry = static_cast<std::uint32_t>(index);
+		}
+
+		// Removes a key that is present in the subtree
+		static void erase_existing(node *&slot, const Key &key, std::uint32_t hash, unsigned int depth)
+		{
+			node *ptr = unshare(slot);
+			if(collision_level(depth))
+			{
+				for(size_t i = 0; i < ptr->entries.size(); i++)
+				{
+					if(KeyEqual()(ptr->entries[i].first, key))
+					{
+						erase_entry(ptr, i);
+						return;
+					}
+				}
+				return;
+			}
+			std::uint32_t bit = fragment_bit(hash, depth);
+			if(ptr->datamap & bit)
+			{
+				erase_entry(ptr, bit_index(ptr->datamap, bit));
+				ptr->datamap ^= bit;
+				return;
+			}
+			size_t index = bit_index(ptr->nodemap, bit);
+			erase_existing(ptr->children[index], key, hash, depth + 1);
+			node *child = ptr->children[index];
+			if(child->children.empty() && child->entries.size() <= 1)
+			{
+				// a single remaining entry is moved up
+				if(!child->entries.empty())
+				{
+					insert_entry(ptr, bit_index(ptr->datamap, bit), child->entries[0]);
+					ptr->datamap |= bit;
+				}
+				ptr->children.erase(ptr->children.begin() + index);
+				ptr->nodemap ^= bit;
+				release(child);
+			}
+		}
+
+	public:
+		persistent_map() noexcept : root(nullptr), count(0)
+		{
+
+		}
+
+		template <class InputIterator>
+		persistent_map(InputIterator first, InputIterator last) : persistent_map()
+		{
+			insert(first, last);
+		}
+
+		persistent_map(const persistent_map &obj) noexcept : root(obj.root), count(obj.count)
+		{
+			if(root)
+			{
+				root->refs.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		persistent_map(persistent_map &&obj) noexcept : root(obj.root), count(obj.count)
+		{
+			obj.root = nullptr;
+			obj.count = 0;
+		}
+
+		persistent_map &operator=(const persistent_map &obj) noexcept
+		{
+			if(this != &obj)
+			{
+				persistent_map tmp(obj);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		persistent_map &operator=(persistent_map &&obj) noexcept
+		{
+			if(this != &obj)
+			{
+				clear();
+				swap(obj);
+			}
+			return *this;
+		}
+
+		~persistent_map()
+		{
+			release(root);
+		}
+
+		iterator begin()
+		{
+			iterator it(&root);
+			if(root)
+			{
+				const node *nodes[max_depth + 1];
+				nodes[0] = root;
+				it.depth = 0;
+				it.first(nodes);
+			}
+			return it;
+		}
+
+		iterator end()
+		{
+			return iterator(&root);
+		}
+
+		const_iterator begin() const
+		{
+			return cbegin();
+		}
+
+		const_iterator end() const
+		{
+			return cend();
+		}
+
+		const_iterator cbegin() const
+		{
+			const_iterator it(&root);
+			if(root)
+			{
+				const node *nodes[max_depth + 1];
+				nodes[0] = root;
+				it.depth = 0;
+				it.first(nodes);
+			}
+			return it;
+		}
+
+		const_iterator cend() const
+		{
+			return const_iterator(&root);
+		}
+
+		size_type size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		void clear() noexcept
+		{
+			release(root);
+			root = nullptr;
+			count = 0;
+		}
+
+		// Finds an entry by any key that hashes like the stored key it is equal to
+		template <class OtherKey, class OtherEqual>
+		iterator find(const OtherKey &key, size_t hash, OtherEqual eq)
+		{
+			return locate(end(), key, fold_hash(hash), eq);
+		}
+
+		template <class OtherKey, class OtherEqual>
+		const_iterator find(const OtherKey &key, size_t hash, OtherEqual eq) const
+		{
+			return locate(cend(), key, fold_hash(hash), eq);
+		}
+
+		iterator find(const Key &key)
+		{
+			return find(key, Hash()(key), KeyEqual());
+		}
+
+		const_iterator find(const Key &key) const
+		{
+			return find(key, Hash()(key), KeyEqual());
+		}
+
+		std::pair<iterator, bool> insert(value_type &&value)
+		{
+			iterator it = find(value.first);
+			if(it != end())
+			{
+				return std::make_pair(it, false);
+			}
+			if(!root)
+			{
+				root = new node();
+			}
+			insert_new(root, value, hash_key(value.first), 0, it);
+			++count;
+			return std::make_pair(it, true);
+		}
+
+		std::pair<iterator, bool> insert(const value_type &value)
+		{
+			return insert(value_type(value));
+		}
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last)
+		{
+			for(; first != last; ++first)
+			{
+				emplace(*first);
+			}
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			return insert(value_type(std::forward<Args>(args)...));
+		}
+
+		Value &operator[](const Key &key)
+		{
+			iterator it = find(key);
+			if(it == end())
+			{
+				it = insert(value_type(key, Value())).first;
+			}
+			return it->second;
+		}
+
+		Value &operator[](Key &&key)
+		{
+			iterator it = find(key);
+			if(it == end())
+			{
+				it = insert(value_type(std::move(key), Value())).first;
+			}
+			return it->second;
+		}
+
+		size_type erase(const Key &key)
+		{
+			if(find(key) == end())
+			{
+				return 0;
+			}
+			erase_existing(root, key, hash_key(key), 0);
+			if(--count == 0)
+			{
+				clear();
+			}
+			return 1;
+		}
+
+		iterator erase(iterator pos)
+		{
+			iterator next = pos;
+			++next;
+			const Key key = access_key(pos);
+			if(next == end())
+			{
+				erase(key);
+				return end();
+			}
+			const Key next_key = access_key(next);
+			erase(key);
+			return find(next_key);
+		}
+
+		void swap(persistent_map &obj) noexcept
+		{
+			std::swap(root, obj.root);
+			std::swap(count, obj.count);
+		}
+
+	private:
+		const Key &access_key(const iterator &pos) const
+		{
+			return iterator::access(static_cast<node *const &>(root), pos.path, pos.depth, pos.entry).first;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef POOL_STATS_H_INCLUDED
+#define POOL_STATS_H_INCLUDED
+
+#include "fixes/linux.h"
+#include <cstddef>
+#include <chrono>
+
+namespace aux
+{
+	// Allocation counters kept by a pool, cheap enough to be always enabled.
+	// Rates and peaks are relative to the last reset.
+	class pool_stats
+	{
+		typedef std::chrono::steady_clock clock;
+
+		size_t alloc_count = 0;
+		size_t free_count = 0;
+		size_t live_count = 0;
+		size_t peak_count = 0;
+		clock::time_point since = clock::now();
+
+	public:
+		void allocated(size_t count = 1)
+		{
+			alloc_count += count;
+			live_count += count;
+			if(live_count > peak_count)
+			{
+				peak_count = live_count;
+			}
+		}
+
+		void freed(size_t count = 1)
+		{
+			free_count += count;
+			live_count -= count;
+		}
+
+		void reset()
+		{
+			alloc_count = 0;
+			free_count = 0;
+			peak_count = live_count;
+			since = clock::now();
+		}
+
+		size_t allocations() const
+		{
+			return alloc_count;
+		}
+
+		size_t frees() const
+		{
+			return free_count;
+		}
+
+		size_t live() const
+		{
+			return live_count;
+		}
+
+		size_t peak() const
+		{
+			return peak_count;
+		}
+
+		double seconds() const
+		{
+			return std::chrono::duration<double>(clock::now() - since).count();
+		}
+
+		double allocation_rate() const
+		{
+			double time = seconds();
+			return time > 0 ? alloc_count / time : 0;
+		}
+
+		double free_rate() const
+		{
+			double time = seconds();
+			return time > 0 ? free_count / time : 0;
+		}
+	};
+}
+
+#endif
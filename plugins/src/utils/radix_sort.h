@@ -0,0 +1,148 @@
+#ifndef RADIX_SORT_H_INCLUDED
+#define RADIX_SORT_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace aux
+{
+	constexpr unsigned cell_key_bits = 33;
+
+	// Radix key of a signed cell; missing cells come first, reverse inverts the order
+	inline std::uint64_t cell_key(const std::int32_t *addr, bool reverse)
+	{
+		std::uint64_t key = 0;
+		if(addr)
+		{
+			key = (std::uint64_t(1) << 32) | (static_cast<std::uint32_t>(*addr) ^ 0x80000000u);
+		}
+		if(reverse)
+		{
+			// a stable ascending sort by the inverted keys is a stable descending sort
+			key = ~key & ((std::uint64_t(1) << cell_key_bits) - 1);
+		}
+		return key;
+	}
+
+	// Stable LSD radix sort by the lowest bits of an unsigned key; the buffer must hold as many items
+	template <class Item, class KeyFunc>
+	void radix_sort(Item *first, Item *last, Item *buffer, KeyFunc key, unsigned bits)
+	{
+		constexpr unsigned digit_bits = 11;
+		constexpr std::size_t radix = std::size_t(1) << digit_bits;
+
+		std::size_t size = last - first;
+		if(size < 2)
+		{
+			return;
+		}
+		Item *src = first, *dst = buffer;
+		std::vector<std::size_t> counts(radix);
+		for(unsigned shift = 0; shift < bits; shift += digit_bits)
+		{
+			std::fill(counts.begin(), counts.end(), 0);
+			for(Item *it = src; it != src + size; ++it)
+			{
+				counts[(key(*it) >> shift) & (radix - 1)]++;
+			}
+			if(counts[(key(*src) >> shift) & (radix - 1)] == size)
+			{
+				// all items have the same digit
+				continue;
+			}
+			std::size_t offset = 0;
+			for(auto &count : counts)
+			{
+				std::size_t next = offset + count;
+				count = offset;
+				offset = next;
+			}
+			for(Item *it = src; it != src + size; ++it)
+			{
+				dst[counts[(key(*it) >> shift) & (radix - 1)]++] = std::move(*it);
+			}
+			std::swap(src, dst);
+		}
+		if(src != first)
+		{
+			std::move(src, src + size, first);
+		}
+	}
+
+	// Sorts the parts on separate threads and merges them, keeping the sort stable
+	template <class Item, class KeyFunc>
+	void parallel_radix_sort(Item *first, Item *last, Item *buffer, KeyFunc key, unsigned bits, std::size_t parts)
+	{
+		std::size_t size = last - first;
+		if(parts < 2 || size < parts)
+		{
+			radix_sort(first, last, buffer, key, bits);
+			return;
+		}
+
+		std::vector<std::size_t> bounds;
+		for(std::size_t i = 0; i <= parts; i++)
+		{
+			bounds.push_back(size * i / parts);
+		}
+
+		std::vector<std::thread> threads;
+		for(std::size_t i = 1; i < parts; i++)
+		{
+			threads.emplace_back([=]()
+			{
+				radix_sort(first + bounds[i], first + bounds[i + 1], buffer + bounds[i], key, bits);
+			});
+		}
+		radix_sort(first, first + bounds[1], buffer, key, bits);
+		for(auto &thread : threads)
+		{
+			thread.join();
+		}
+
+		auto less = [=](const Item &a, const Item &b)
+		{
+			return key(a) < key(b);
+		};
+		Item *src = first, *dst = buffer;
+		while(bounds.size() > 2)
+		{
+			threads.clear();
+			std::vector<std::size_t> merged;
+			std::size_t runs = bounds.size() - 1;
+			for(std::size_t i = 0; i < runs; i += 2)
+			{
+				merged.push_back(bounds[i]);
+				Item *begin = src + bounds[i], *middle = src + bounds[i + 1];
+				Item *out = dst + bounds[i];
+				if(i + 1 < runs)
+				{
+					Item *end = src + bounds[i + 2];
+					threads.emplace_back([=]()
+					{
+						std::merge(begin, middle, middle, end, out, less);
+					});
+				}else{
+					std::move(begin, middle, out);
+				}
+			}
+			merged.push_back(size);
+			for(auto &thread : threads)
+			{
+				thread.join();
+			}
+			bounds.swap(merged);
+			std::swap(src, dst);
+		}
+		if(src != first)
+		{
+			std::move(src, src + size, first);
+		}
+	}
+}
+
+#endif
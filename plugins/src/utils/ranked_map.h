@@ -0,0 +1,669 @@
+#ifndef RANKED_MAP_H_INCLUDED
+#define RANKED_MAP_H_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace aux
+{
+	namespace impl
+	{
+		struct ranked_node_base
+		{
+			ranked_node_base *parent = nullptr;
+			ranked_node_base *left = nullptr;
+			ranked_node_base *right = nullptr;
+			std::size_t count = 1;
+			int height = 1;
+
+			ranked_node_base *next() const
+			{
+				const ranked_node_base *node = this;
+				if(node->right)
+				{
+					node = node->right;
+					while(node->left)
+					{
+						node = node->left;
+					}
+					return const_cast<ranked_node_base*>(node);
+				}
+				while(node->parent->right == node)
+				{
+					node = node->parent;
+				}
+				return node->parent;
+			}
+
+			ranked_node_base *prev() const
+			{
+				const ranked_node_base *node = this;
+				if(node->left)
+				{
+					node = node->left;
+					while(node->right)
+					{
+						node = node->right;
+					}
+					return const_cast<ranked_node_base*>(node);
+				}
+				while(node->parent->left == node)
+				{
+					node = node->parent;
+				}
+				return node->parent;
+			}
+		};
+
+		template <class Value>
+		struct ranked_node : public ranked_node_base
+		{
+			Value value;
+
+			template <class... Args>
+			ranked_node(Args&&... args) : value(std::forward<Args>(args)...)
+			{
+
+			}
+		};
+
+		template <class Value, class Elem>
+		class ranked_iterator
+		{
+			ranked_node_base *node;
+
+			template <class, class>
+			friend class ranked_iterator;
+
+		public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef Value value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Elem *pointer;
+			typedef Elem &reference;
+
+			ranked_iterator() : node(nullptr)
+			{
+
+			}
+
+			explicit ranked_iterator(const ranked_node_base *node) : node(const_cast<ranked_node_base*>(node))
+			{
+
+			}
+
+			template <class Other, class = typename std::enable_if<std::is_convertible<Other*, Elem*>::value>::type>
+			ranked_iterator(const ranked_iterator<Value, Other> &it) : node(it.node)
+			{
+
+			}
+
+			ranked_node_base *get() const
+			{
+				return node;
+			}
+
+			reference operator*() const
+			{
+				return static_cast<ranked_node<Value>*>(node)->value;
+			}
+
+			pointer operator->() const
+			{
+				return &**this;
+			}
+
+			ranked_iterator &operator++()
+			{
+				node = node->next();
+				return *this;
+			}
+
+			ranked_iterator operator++(int)
+			{
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			ranked_iterator &operator--()
+			{
+				node = node->prev();
+				return *this;
+			}
+
+			ranked_iterator operator--(int)
+			{
+				auto tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			bool operator==(const ranked_iterator &it) const
+			{
+				return node == it.node;
+			}
+
+			bool operator!=(const ranked_iterator &it) const
+			{
+				return node != it.node;
+			}
+		};
+	}
+
+	// Ordered map (AVL tree) with every node storing the size of its subtree, so that the n-th
+	// element and the position of an element are found in logarithmic time. Iterators are
+	// invalidated only by erasing the element they point to.
+	template <class Key, class Value, class Compare = std::less<Key>>
+	class ranked_map
+	{
+	public:
+		typedef std::pair<const Key, Value> value_type;
+		typedef value_type &reference;
+		typedef const value_type &const_reference;
+		typedef std::size_t size_type;
+		typedef impl::ranked_iterator<value_type, value_type> iterator;
+		typedef impl::ranked_iterator<value_type, const value_type> const_iterator;
+
+	private:
+		typedef impl::ranked_node_base node_base;
+		typedef impl::ranked_node<value_type> node;
+
+		// The root is the left child of the header, which also serves as the end position
+		node_base header;
+		Compare compare;
+
+		node_base *&root()
+		{
+			return header.left;
+		}
+
+		node_base *root() const
+		{
+			return header.left;
+		}
+
+		static const Key &key_of(const node_base *n)
+		{
+			return static_cast<const node*>(n)->value.first;
+		}
+
+		static size_type count_of(const node_base *n)
+		{
+			return n ? n->count : 0;
+		}
+
+		static int height_of(const node_base *n)
+		{
+			return n ? n->height : 0;
+		}
+
+		static void update(node_base *n)
+		{
+			int lh = height_of(n->left), rh = height_of(n->right);
+			n->height = (lh > rh ? lh : rh) + 1;
+			n->count = count_of(n->left) + count_of(n->right) + 1;
+		}
+
+		static void replace_child(node_base *parent, node_base *child, node_base *with)
+		{
+			if(parent->left == child)
+			{
+				parent->left = with;
+			}else{
+				parent->right = with;
+			}
+			if(with)
+			{
+				with->parent = parent;
+			}
+		}
+
+		static node_base *rotate_left(node_base *n)
+		{
+			node_base *r = n->right;
+			n->right = r->left;
+			if(r->left)
+			{
+				r->left->parent = n;
+			}
+			replace_child(n->parent, n, r);
+			r->left = n;
+			n->parent = r;
+			update(n);
+			update(r);
+			return r;
+		}
+
+		static node_base *rotate_right(node_base *n)
+		{
+			node_base *l = n->left;
+			n->left = l->right;
+			if(l->right)
+			{
+				l->right->parent = n;
+			}
+			replace_child(n->parent, n, l);
+			l->right = n;
+			n->parent = l;
+			update(n);
+			update(l);
+			return l;
+		}
+
+		static node_base *rebalance(node_base *n)
+		{
+			update(n);
+			int balance = height_of(n->left) - height_of(n->right);
+			if(balance > 1)
+			{
+				if(height_of(n->left->left) < height_of(n->left->right))
+				{
+					rotate_left(n->left);
+				}
+				return rotate_right(n);
+			}else if(balance < -1)
+			{
+				if(height_of(n->right->right) < height_of(n->right->left))
+				{
+					rotate_right(n->right);
+				}
+				return rotate_left(n);
+			}
+			return n;
+		}
+
+		// Restores the balance and the counts on the path from the node to the root
+		void fixup(node_base *n)
+		{
+			while(n != &header)
+			{
+				n = rebalance(n)->parent;
+			}
+		}
+
+		// Finds the node with the key, or the parent to attach it to
+		std::pair<node_base*, bool> locate(const Key &key) const
+		{
+			node_base *parent = const_cast<node_base*>(&header);
+			node_base *n = root();
+			while(n)
+			{
+				parent = n;
+				if(compare(key, key_of(n)))
+				{
+					n = n->left;
+				}else if(compare(key_of(n), key))
+				{
+					n = n->right;
+				}else{
+					return std::make_pair(n, true);
+				}
+			}
+			return std::make_pair(parent, false);
+		}
+
+		iterator attach(node_base *parent, node *n)
+		{
+			n->parent = parent;
+			if(parent == &header || compare(n->value.first, key_of(parent)))
+			{
+				parent->left = n;
+			}else{
+				parent->right = n;
+			}
+			fixup(parent);
+			return iterator(n);
+		}
+
+		static node_base *clone(const node_base *source, node_base *parent)
+		{
+			if(!source)
+			{
+				return nullptr;
+			}
+			node_base *n = new node(static_cast<const node*>(source)->value);
+			n->parent = parent;
+			n->count = source->count;
+			n->height = source->height;
+			try{
+				n->left = clone(source->left, n);
+				n->right = clone(source->right, n);
+			}catch(...)
+			{
+				destroy(n);
+				throw;
+			}
+			return n;
+		}
+
+		static void destroy(node_base *n)
+		{
+			while(n)
+			{
+				destroy(n->right);
+				node_base *left = n->left;
+				delete static_cast<node*>(n);
+				n = left;
+			}
+		}
+
+		void adopt(node_base *r)
+		{
+			header.left = r;
+			if(r)
+			{
+				r->parent = &header;
+			}
+		}
+
+	public:
+		ranked_map()
+		{
+
+		}
+
+		template <class InputIterator>
+		ranked_map(InputIterator first, InputIterator last)
+		{
+			insert(first, last);
+		}
+
+		ranked_map(const ranked_map &map) : compare(map.compare)
+		{
+			adopt(clone(map.root(), &header));
+		}
+
+		ranked_map(ranked_map &&map) noexcept : compare(std::move(map.compare))
+		{
+			adopt(map.root());
+			map.header.left = nullptr;
+		}
+
+		ranked_map &operator=(const ranked_map &map)
+		{
+			if(this != &map)
+			{
+				ranked_map tmp(map);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		ranked_map &operator=(ranked_map &&map) noexcept
+		{
+			if(this != &map)
+			{
+				ranked_map tmp(std::move(map));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		void swap(ranked_map &map) noexcept
+		{
+			node_base *r = root();
+			adopt(map.root());
+			map.adopt(r);
+			std::swap(compare, map.compare);
+		}
+
+		Value &operator[](const Key &key)
+		{
+			auto pos = locate(key);
+			if(pos.second)
+			{
+				return static_cast<node*>(pos.first)->value.second;
+			}
+			return attach(pos.first, new node(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()))->second;
+		}
+
+		Value &operator[](Key &&key)
+		{
+			auto pos = locate(key);
+			if(pos.second)
+			{
+				return static_cast<node*>(pos.first)->value.second;
+			}
+			return attach(pos.first, new node(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple()))->second;
+		}
+
+		iterator begin()
+		{
+			node_base *n = &header;
+			while(n->left)
+			{
+				n = n->left;
+			}
+			return iterator(n);
+		}
+
+		iterator end()
+		{
+			return iterator(&header);
+		}
+
+		const_iterator begin() const
+		{
+			return const_cast<ranked_map*>(this)->begin();
+		}
+
+		const_iterator end() const
+		{
+			return const_iterator(&header);
+		}
+
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		size_type size() const
+		{
+			return count_of(root());
+		}
+
+		bool empty() const
+		{
+			return root() == nullptr;
+		}
+
+		void clear()
+		{
+			destroy(root());
+			header.left = nullptr;
+		}
+
+		iterator find(const Key &key)
+		{
+			auto pos = locate(key);
+			return pos.second ? iterator(pos.first) : end();
+		}
+
+		const_iterator find(const Key &key) const
+		{
+			auto pos = locate(key);
+			return pos.second ? const_iterator(pos.first) : end();
+		}
+
+		// The first element not ordered before the key
+		iterator lower_bound(const Key &key)
+		{
+			node_base *result = &header;
+			node_base *n = root();
+			while(n)
+			{
+				if(compare(key_of(n), key))
+				{
+					n = n->right;
+				}else{
+					result = n;
+					n = n->left;
+				}
+			}
+			return iterator(result);
+		}
+
+		const_iterator lower_bound(const Key &key) const
+		{
+			return const_cast<ranked_map*>(this)->lower_bound(key);
+		}
+
+		// The first element ordered after the key
+		iterator upper_bound(const Key &key)
+		{
+			node_base *result = &header;
+			node_base *n = root();
+			while(n)
+			{
+				if(compare(key, key_of(n)))
+				{
+					result = n;
+					n = n->left;
+				}else{
+					n = n->right;
+				}
+			}
+			return iterator(result);
+		}
+
+		const_iterator upper_bound(const Key &key) const
+		{
+			return const_cast<ranked_map*>(this)->upper_bound(key);
+		}
+
+		// The element at the given position in the order, or end()
+		iterator nth(size_type index)
+		{
+			node_base *n = root();
+			while(n)
+			{
+				size_type left = count_of(n->left);
+				if(index < left)
+				{
+					n = n->left;
+				}else if(index == left)
+				{
+					return iterator(n);
+				}else{
+					index -= left + 1;
+					n = n->right;
+				}
+			}
+			return end();
+		}
+
+		const_iterator nth(size_type index) const
+		{
+			return const_cast<ranked_map*>(this)->nth(index);
+		}
+
+		// The number of elements ordered before the position
+		size_type index_of(const_iterator it) const
+		{
+			const node_base *n = it.get();
+			if(n == &header)
+			{
+				return size();
+			}
+			size_type index = count_of(n->left);
+			while(n->parent != &header)
+			{
+				if(n->parent->right == n)
+				{
+					index += count_of(n->parent->left) + 1;
+				}
+				n = n->parent;
+			}
+			return index;
+		}
+
+		size_type erase(const Key &key)
+		{
+			auto pos = locate(key);
+			if(!pos.second)
+			{
+				return 0;
+			}
+			erase(const_iterator(pos.first));
+			return 1;
+		}
+
+		iterator erase(const_iterator it)
+		{
+			node_base *n = it.get();
+			node_base *next = n->next();
+			node_base *start;
+			if(n->left && n->right)
+			{
+				// the successor takes the place of the node
+				if(next == n->right)
+				{
+					start = next;
+				}else{
+					start = next->parent;
+					replace_child(start, next, next->right);
+					next->right = n->right;
+					n->right->parent = next;
+				}
+				next->left = n->left;
+				n->left->parent = next;
+				replace_child(n->parent, n, next);
+			}else{
+				start = n->parent;
+				replace_child(start, n, n->left ? n->left : n->right);
+			}
+			fixup(start);
+			delete static_cast<node*>(n);
+			return iterator(next);
+		}
+
+		std::pair<iterator, bool> insert(const value_type &val)
+		{
+			return emplace(val);
+		}
+
+		std::pair<iterator, bool> insert(value_type &&val)
+		{
+			return emplace(std::move(val));
+		}
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last)
+		{
+			for(; first != last; ++first)
+			{
+				emplace(*first);
+			}
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			node *n = new node(std::forward<Args>(args)...);
+			auto pos = locate(n->value.first);
+			if(pos.second)
+			{
+				delete n;
+				return std::make_pair(iterator(pos.first), false);
+			}
+			return std::make_pair(attach(pos.first, n), true);
+		}
+
+		~ranked_map()
+		{
+			destroy(root());
+		}
+	};
+}
+
+#endif
@@ -2,35 +2,61 @@
 #define SHARED_ID_SET_POOL_H_INCLUDED
 
 #include "fixes/linux.h"
+#include "utils/slab_allocator.h"
+#include "utils/owner_list.h"
+#include "utils/pool_stats.h"
 #include "sdk/amx/amx.h"
 #include <memory>
 #include <unordered_map>
+#include <functional>
 
 namespace aux
 {
 	template <class Type>
 	class shared_id_set_pool
 	{
-		std::unordered_map<Type*, std::shared_ptr<Type>> data;
+		struct entry
+		{
+			std::shared_ptr<Type> value;
+			owner_link<Type> owner;
+
+			entry(std::shared_ptr<Type> &&value) : value(std::move(value))
+			{
+
+			}
+		};
 
-		typedef typename std::unordered_map<Type*, std::shared_ptr<Type>>::iterator iterator;
-		typedef typename std::unordered_map<Type*, std::shared_ptr<Type>>::const_iterator const_iterator;
+		typedef std::unordered_map<Type*, entry, std::hash<Type*>, std::equal_to<Type*>, slab_allocator<std::pair<Type* const, entry>>> map_type;
+
+		map_type data;
+		owner_table<Type> owners;
+		pool_stats stats;
+		bool track_owners = true;
+
+		typedef typename map_type::iterator iterator;
+		typedef typename map_type::const_iterator const_iterator;
 
 	public:
 		const std::shared_ptr<Type> &add(std::shared_ptr<Type> &&value)
 		{
 			auto ptr = value.get();
-			return data.emplace(ptr, std::move(value)).first->second;
+			auto &item = data.emplace(ptr, std::move(value)).first->second;
+			stats.allocated();
+			if(track_owners)
+			{
+				owners.link(item.owner, ptr);
+			}
+			return item.value;
 		}
 
 		const std::shared_ptr<Type> &add()
 		{
-			return add(std::make_shared<Type>());
+			return add(std::allocate_shared<Type>(slab_allocator<Type>()));
 		}
 
 		const std::shared_ptr<Type> &add(Type&& value)
 		{
-			return add(std::make_shared<Type>(std::move(value)));
+			return add(std::allocate_shared<Type>(slab_allocator<Type>(), std::move(value)));
 		}
 
 		/*const std::shared_ptr<Type> &add(std::unique_ptr<Type> &&value)
@@ -41,13 +67,13 @@ namespace aux
 		template <class... Args>
 		const std::shared_ptr<Type> &emplace(Args &&... args)
 		{
-			return add(std::make_shared<Type>(std::forward<Args>(args)...));
+			return add(std::allocate_shared<Type>(slab_allocator<Type>(), std::forward<Args>(args)...));
 		}
 
 		template <class NewType, class... Args>
 		const std::shared_ptr<Type> &emplace_derived(Args &&... args)
 		{
-			return add(std::make_shared<NewType>(std::forward<Args>(args)...));
+			return add(std::allocate_shared<NewType>(slab_allocator<NewType>(), std::forward<Args>(args)...));
 		}
 
 		size_t size() const
@@ -60,8 +86,7 @@ namespace aux
 			auto it = data.find(value);
 			if(it != data.end())
 			{
-				std::shared_ptr<Type> orig(std::move(it->second));
-				data.erase(it);
+				std::shared_ptr<Type> orig(extract(it));
 				return true;
 			}
 			return false;
@@ -69,9 +94,20 @@ namespace aux
 
 		void clear()
 		{
+			owners.clear();
+			stats.freed(data.size());
 			data.clear();
 		}
 
+		template <class Func>
+		void for_each(Func func) const
+		{
+			for(const auto &pair : data)
+			{
+				func(*pair.second.value);
+			}
+		}
+
 		iterator begin()
 		{
 			return data.begin();
@@ -97,7 +133,7 @@ namespace aux
 			auto it = data.find(reinterpret_cast<Type*>(id));
 			if(it != data.end())
 			{
-				value = it->second;
+				value = it->second.value;
 				return true;
 			}
 			return false;
@@ -130,12 +166,16 @@ namespace aux
 
 		iterator erase(iterator it)
 		{
+			owners.unlink(it->second.owner);
+			stats.freed();
 			return data.erase(it);
 		}
 
 		std::shared_ptr<Type> extract(iterator it)
 		{
-			auto ptr = std::move(it->second);
+			owners.unlink(it->second.owner);
+			stats.freed();
+			auto ptr = std::move(it->second.value);
 			data.erase(it);
 			return ptr;
 		}
@@ -145,19 +185,72 @@ namespace aux
 			auto it = data.find(value);
 			if(it != data.end())
 			{
-				return it->second;
+				return it->second.value;
 			}
 			return {};
 		}
 
+		// Removes all objects created by the AMX
+		size_t release_owner(AMX *amx)
+		{
+			auto objects = owners.objects(amx);
+			std::vector<std::shared_ptr<Type>> released;
+			released.reserve(objects.size());
+			for(auto obj : objects)
+			{
+				auto it = data.find(obj);
+				if(it != data.end())
+				{
+					released.push_back(extract(it));
+				}
+			}
+			owners.forget(amx);
+			return objects.size();
+		}
+
+		void forget_owner(AMX *amx)
+		{
+			owners.forget(amx);
+		}
+
+		size_t owned_size(AMX *amx) const
+		{
+			return owners.count(amx);
+		}
+
+		template <class Func>
+		void for_each_owned(AMX *amx, Func func) const
+		{
+			owners.for_each(amx, [&](const Type &obj)
+			{
+				func(obj);
+			});
+		}
+
+		const pool_stats &get_stats() const
+		{
+			return stats;
+		}
+
+		void reset_stats()
+		{
+			stats.reset();
+		}
+
 		shared_id_set_pool()
 		{
 
 		}
 
-		shared_id_set_pool(shared_id_set_pool<Type> &&obj) : data(std::move(obj.data))
+		explicit shared_id_set_pool(bool track_owners) : track_owners(track_owners)
+		{
+
+		}
+
+		shared_id_set_pool(shared_id_set_pool<Type> &&obj) : data(std::move(obj.data)), owners(std::move(obj.owners)), stats(obj.stats), track_owners(obj.track_owners)
 		{
 			obj.data.clear();
+			obj.stats = pool_stats();
 		}
 
 		shared_id_set_pool<Type> &operator=(shared_id_set_pool<Type> &&obj)
@@ -165,7 +258,10 @@ namespace aux
 			if(this != &obj)
 			{
 				data = std::move(obj.data);
+				owners = std::move(obj.owners);
+				stats = obj.stats;
 				obj.data.clear();
+				obj.stats = pool_stats();
 			}
 			return *this;
 		}
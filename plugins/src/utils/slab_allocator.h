@@ -0,0 +1,192 @@
+#ifndef SLAB_ALLOCATOR_H_INCLUDED
+#define SLAB_ALLOCATOR_H_INCLUDED
+
+#include "fixes/linux.h"
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace aux
+{
+	namespace impl
+	{
+		// Fixed-size blocks carved out of large chunks, recycled through an intrusive free list.
+		// Chunks are never returned, so memory is reused only by objects of the same size class.
+		class slab_storage
+		{
+			struct free_block
+			{
+				free_block *next;
+			};
+
+			std::atomic_flag busy = ATOMIC_FLAG_INIT;
+			const size_t block_size;
+			free_block *free_list = nullptr;
+			char *next = nullptr;
+			char *end = nullptr;
+			size_t chunk_blocks = 32;
+			std::vector<char*> chunks;
+
+			class guard
+			{
+				std::atomic_flag &flag;
+
+			public:
+				guard(std::atomic_flag &flag) noexcept : flag(flag)
+				{
+					while(flag.test_and_set(std::memory_order_acquire)){}
+				}
+
+				~guard() noexcept
+				{
+					flag.clear(std::memory_order_release);
+				}
+			};
+
+		public:
+			static constexpr size_t max_chunk_blocks = 4096;
+
+			explicit slab_storage(size_t block_size) : block_size(block_size)
+			{
+
+			}
+
+			slab_storage(const slab_storage&) = delete;
+			slab_storage &operator=(const slab_storage&) = delete;
+
+			void *allocate()
+			{
+				guard lock(busy);
+				if(free_list)
+				{
+					free_block *block = free_list;
+					free_list = block->next;
+					return block;
+				}
+				if(next == end)
+				{
+					size_t size = chunk_blocks * block_size;
+					next = static_cast<char*>(::operator new(size));
+					end = next + size;
+					chunks.push_back(next);
+					if(chunk_blocks < max_chunk_blocks)
+					{
+						chunk_blocks *= 2;
+					}
+				}
+				void *block = next;
+				next += block_size;
+				return block;
+			}
+
+			void deallocate(void *ptr) noexcept
+			{
+				guard lock(busy);
+				auto block = static_cast<free_block*>(ptr);
+				block->next = free_list;
+				free_list = block;
+			}
+		};
+
+		constexpr size_t slab_granularity = sizeof(void*) > 8 ? sizeof(void*) : 8;
+
+		constexpr size_t slab_size_class(size_t size)
+		{
+			return (size + slab_granularity - 1) / slab_granularity * slab_granularity;
+		}
+
+		template <size_t Size>
+		struct slab_class
+		{
+			static slab_storage &get()
+			{
+				// intentionally leaked, since objects may be freed during static destruction
+				static slab_storage *storage = new slab_storage(Size);
+				return *storage;
+			}
+		};
+	}
+
+	// Stateless allocator serving single objects from a slab shared by all types of the same size class.
+	template <class Type>
+	class slab_allocator
+	{
+	public:
+		typedef Type value_type;
+		typedef Type *pointer;
+		typedef const Type *const_pointer;
+		typedef Type &reference;
+		typedef const Type &const_reference;
+		typedef size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+
+		template <class Other>
+		struct rebind
+		{
+			typedef slab_allocator<Other> other;
+		};
+
+		slab_allocator() noexcept
+		{
+
+		}
+
+		template <class Other>
+		slab_allocator(const slab_allocator<Other>&) noexcept
+		{
+
+		}
+
+		Type *allocate(size_t n)
+		{
+			if(n == 1 && alignof(Type) <= impl::slab_granularity)
+			{
+				return static_cast<Type*>(storage().allocate());
+			}
+			return static_cast<Type*>(::operator new(n * sizeof(Type)));
+		}
+
+		void deallocate(Type *ptr, size_t n) noexcept
+		{
+			if(n == 1 && alignof(Type) <= impl::slab_granularity)
+			{
+				storage().deallocate(ptr);
+			}else{
+				::operator delete(ptr);
+			}
+		}
+
+		template <class Other, class... Args>
+		void construct(Other *ptr, Args &&...args)
+		{
+			::new(static_cast<void*>(ptr)) Other(std::forward<Args>(args)...);
+		}
+
+		template <class Other>
+		void destroy(Other *ptr)
+		{
+			ptr->~Other();
+		}
+
+		static impl::slab_storage &storage()
+		{
+			return impl::slab_class<impl::slab_size_class(sizeof(Type))>::get();
+		}
+	};
+
+	template <class Type1, class Type2>
+	bool operator==(const slab_allocator<Type1>&, const slab_allocator<Type2>&) noexcept
+	{
+		return true;
+	}
+
+	template <class Type1, class Type2>
+	bool operator!=(const slab_allocator<Type1>&, const slab_allocator<Type2>&) noexcept
+	{
+		return false;
+	}
+}
+
+#endif
@@ -0,0 +1,489 @@
+#ifndef SPATIAL_GRID_H_INCLUDED
+#define SPATIAL_GRID_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace aux
+{
+	// Points in 3D space with values, bucketed in a uniform grid of cubic cells
+	template <class Value>
+	class spatial_grid
+	{
+	public:
+		static constexpr size_t npos = -1;
+
+		struct entry
+		{
+			float pos[3];
+			Value value;
+			// the grid cell containing the entry, and its index there (or npos if the handle is free)
+			uint64_t cell_key;
+			size_t slot;
+		};
+
+	private:
+		struct point
+		{
+			float pos[3];
+			size_t handle;
+		};
+
+		typedef std::vector<point> bucket;
+
+		float cell_size;
+		float inv_cell_size;
+		std::vector<entry> entries;
+		std::vector<size_t> free_handles;
+		std::unordered_map<uint64_t, bucket> grid;
+		size_t count = 0;
+		// range of cells that were ever occupied since the last clear
+		int32_t extent_min[3];
+		int32_t extent_max[3];
+
+		static constexpr int32_t cell_limit = 1 << 20;
+
+		int32_t cell_coord(float value) const
+		{
+			float c = std::floor(value * inv_cell_size);
+			if(!(c >= -cell_limit)) return -cell_limit;
+			if(c >= cell_limit) return cell_limit - 1;
+			return static_cast<int32_t>(c);
+		}
+
+		static uint64_t cell_key(int32_t x, int32_t y, int32_t z)
+		{
+			return (static_cast<uint64_t>(x + cell_limit) << 42) | (static_cast<uint64_t>(y + cell_limit) << 21) | static_cast<uint64_t>(z + cell_limit);
+		}
+
+		static void cell_coords(uint64_t key, int32_t c[3])
+		{
+			c[0] = static_cast<int32_t>((key >> 42) & 0x1FFFFF) - cell_limit;
+			c[1] = static_cast<int32_t>((key >> 21) & 0x1FFFFF) - cell_limit;
+			c[2] = static_cast<int32_t>(key & 0x1FFFFF) - cell_limit;
+		}
+
+		static float distance_sq(const float a[3], const float b[3])
+		{
+			float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+			return dx * dx + dy * dy + dz * dz;
+		}
+
+		void reset_extent()
+		{
+			for(int i = 0; i < 3; i++)
+			{
+				extent_min[i] = cell_limit;
+				extent_max[i] = -cell_limit - 1;
+			}
+		}
+
+		void link(size_t handle, const float pos[3])
+		{
+			int32_t c[3] = {cell_coord(pos[0]), cell_coord(pos[1]), cell_coord(pos[2])};
+			auto &e = entries[handle];
+			std::copy(pos, pos + 3, e.pos);
+			e.cell_key = cell_key(c[0], c[1], c[2]);
+			auto &points = grid[e.cell_key];
+			e.slot = points.size();
+			points.push_back(point{{pos[0], pos[1], pos[2]}, handle});
+			for(int i = 0; i < 3; i++)
+			{
+				extent_min[i] = std::min(extent_min[i], c[i]);
+				extent_max[i] = std::max(extent_max[i], c[i]);
+			}
+		}
+
+		void unlink(size_t handle)
+		{
+			auto &e = entries[handle];
+			auto it = grid.find(e.cell_key);
+			auto &points = it->second;
+			if(e.slot + 1 < points.size())
+			{
+				points[e.slot] = points.back();
+				entries[points[e.slot].handle].slot = e.slot;
+			}
+			points.pop_back();
+			if(points.empty())
+			{
+				grid.erase(it);
+			}
+			e.slot = npos;
+		}
+
+		// Calls func with every bucket in the range of cells, walking the whole grid when that is cheaper
+		template <class Func>
+		bool visit_cells(const int32_t lo[3], const int32_t hi[3], Func func) const
+		{
+			int32_t a[3], b[3];
+			uint64_t cells = 1;
+			for(int i = 0; i < 3; i++)
+			{
+				a[i] = std::max(lo[i], extent_min[i]);
+				b[i] = std::min(hi[i], extent_max[i]);
+				if(a[i] > b[i])
+				{
+					return true;
+				}
+				cells *= static_cast<uint64_t>(b[i] - a[i] + 1);
+			}
+			if(cells > grid.size())
+			{
+				for(const auto &pair : grid)
+				{
+					int32_t c[3];
+					cell_coords(pair.first, c);
+					if(c[0] >= a[0] && c[0] <= b[0] && c[1] >= a[1] && c[1] <= b[1] && c[2] >= a[2] && c[2] <= b[2])
+					{
+						if(!func(pair.second)) return false;
+					}
+				}
+			}else{
+				for(int32_t x = a[0]; x <= b[0]; x++)
+				{
+					for(int32_t y = a[1]; y <= b[1]; y++)
+					{
+						for(int32_t z = a[2]; z <= b[2]; z++)
+						{
+							auto it = grid.find(cell_key(x, y, z));
+							if(it != grid.end())
+							{
+								if(!func(it->second)) return false;
+							}
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+	public:
+		explicit spatial_grid(float cell_size) : cell_size(cell_size), inv_cell_size(1.0f / cell_size)
+		{
+			reset_extent();
+		}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		float get_cell_size() const
+		{
+			return cell_size;
+		}
+
+		size_t insert(const float pos[3], Value &&value)
+		{
+			size_t handle;
+			if(free_handles.empty())
+			{
+				handle = entries.size();
+				entries.emplace_back();
+			}else{
+				handle = free_handles.back();
+				free_handles.pop_back();
+			}
+			entries[handle].value = std::move(value);
+			link(handle, pos);
+			count++;
+			return handle;
+		}
+
+		bool move(size_t handle, const float pos[3])
+		{
+			entry *e = find(handle);
+			if(!e)
+			{
+				return false;
+			}
+			if(cell_key(cell_coord(pos[0]), cell_coord(pos[1]), cell_coord(pos[2])) == e->cell_key)
+			{
+				// most moves stay in the same cell
+				std::copy(pos, pos + 3, e->pos);
+				auto &p = grid.find(e->cell_key)->second[e->slot];
+				std::copy(pos, pos + 3, p.pos);
+			}else{
+				unlink(handle);
+				link(handle, pos);
+			}
+			return true;
+		}
+
+		Value extract(size_t handle)
+		{
+			unlink(handle);
+			Value value = std::move(entries[handle].value);
+			entries[handle].value = Value();
+			free_handles.push_back(handle);
+			count--;
+			return value;
+		}
+
+		bool remove(size_t handle)
+		{
+			if(!find(handle))
+			{
+				return false;
+			}
+			extract(handle);
+			return true;
+		}
+
+		void clear()
+		{
+			entries.clear();
+			free_handles.clear();
+			grid.clear();
+			count = 0;
+			reset_extent();
+		}
+
+		entry *find(size_t handle)
+		{
+			if(handle < entries.size() && entries[handle].slot != npos)
+			{
+				return &entries[handle];
+			}
+			return nullptr;
+		}
+
+		const entry *find(size_t handle) const
+		{
+			return const_cast<spatial_grid*>(this)->find(handle);
+		}
+
+		// Calls func with the handle of every point inside the box, until it returns false
+		template <class Func>
+		bool query_box(const float min[3], const float max[3], Func func) const
+		{
+			int32_t lo[3] = {cell_coord(min[0]), cell_coord(min[1]), cell_coord(min[2])};
+			int32_t hi[3] = {cell_coord(max[0]), cell_coord(max[1]), cell_coord(max[2])};
+			return visit_cells(lo, hi, [&](const bucket &points)
+			{
+				for(const auto &p : points)
+				{
+					if(p.pos[0] >= min[0] && p.pos[0] <= max[0] && p.pos[1] >= min[1] && p.pos[1] <= max[1] && p.pos[2] >= min[2] && p.pos[2] <= max[2])
+					{
+						if(!func(p.handle)) return false;
+					}
+				}
+				return true;
+			});
+		}
+
+		// Calls func with the handle of every point within the radius, until it returns false
+		template <class Func>
+		bool query_radius(const float center[3], float radius, Func func) const
+		{
+			int32_t lo[3] = {cell_coord(center[0] - radius), cell_coord(center[1] - radius), cell_coord(center[2] - radius)};
+			int32_t hi[3] = {cell_coord(center[0] + radius), cell_coord(center[1] + radius), cell_coord(center[2] + radius)};
+			float limit = radius * radius;
+			return visit_cells(lo, hi, [&](const bucket &points)
+			{
+				for(const auto &p : points)
+				{
+					if(distance_sq(p.pos, center) <= limit)
+					{
+						if(!func(p.handle)) return false;
+					}
+				}
+				return true;
+			});
+		}
+
+		// Finds up to max_count nearest points (with their squared distances) ordered by distance; negative max_radius is unlimited
+		void nearest(const float center[3], size_t max_count, float max_radius, std::vector<std::pair<float, size_t>> &result) const
+		{
+			result.clear();
+			if(max_count == 0 || count == 0)
+			{
+				return;
+			}
+			float limit = max_radius < 0 ? std::numeric_limits<float>::infinity() : max_radius * max_radius;
+
+			// result is kept as a max-heap of the best candidates until the end
+			auto consider = [&](const bucket &points)
+			{
+				for(const auto &p : points)
+				{
+					float dist = distance_sq(p.pos, center);
+					if(dist > limit)
+					{
+						continue;
+					}
+					if(result.size() < max_count)
+					{
+						result.emplace_back(dist, p.handle);
+						std::push_heap(result.begin(), result.end());
+					}else if(dist < result.front().first)
+					{
+						std::pop_heap(result.begin(), result.end());
+						result.back() = std::make_pair(dist, p.handle);
+						std::push_heap(result.begin(), result.end());
+					}
+				}
+			};
+			// no point in a cell r steps away from the center cell is closer than this
+			auto bound = [&](int32_t r)
+			{
+				float d = std::max(r - 1, 0) * cell_size;
+				return d * d;
+			};
+			auto pruned = [&](int32_t r)
+			{
+				float min_dist = bound(r);
+				return min_dist > limit || (result.size() == max_count && result.front().first <= min_dist);
+			};
+
+			int32_t c[3] = {cell_coord(center[0]), cell_coord(center[1]), cell_coord(center[2])};
+			int32_t r = 0;
+			for(int i = 0; i < 3; i++)
+			{
+				r = std::max(r, std::max(extent_min[i] - c[i], c[i] - extent_max[i]));
+			}
+
+			size_t visited = 0;
+			auto visit = [&](int32_t x, int32_t y, int32_t z)
+			{
+				visited++;
+				auto it = grid.find(cell_key(x, y, z));
+				if(it != grid.end())
+				{
+					consider(it->second);
+				}
+			};
+
+			for(; !pruned(r); r++)
+			{
+				if(r > 0)
+				{
+					bool covered = true;
+					for(int i = 0; i < 3; i++)
+					{
+						if(c[i] - (r - 1) > extent_min[i] || c[i] + (r - 1) < extent_max[i])
+						{
+							covered = false;
+							break;
+						}
+					}
+					if(covered)
+					{
+						break;
+					}
+				}
+
+				if(visited > grid.size())
+				{
+					// the shells have grown past the occupied cells, so check the rest directly
+					for(const auto &pair : grid)
+					{
+						int32_t pc[3];
+						cell_coords(pair.first, pc);
+						int32_t d = std::max(std::max(std::abs(pc[0] - c[0]), std::abs(pc[1] - c[1])), std::abs(pc[2] - c[2]));
+						if(d >= r && !pruned(d))
+						{
+							consider(pair.second);
+						}
+					}
+					break;
+				}
+
+				// the shell of cells exactly r steps away, clipped to the occupied range
+				int32_t lo[3], hi[3];
+				for(int i = 0; i < 3; i++)
+				{
+					lo[i] = std::max(c[i] - r, extent_min[i]);
+					hi[i] = std::min(c[i] + r, extent_max[i]);
+				}
+				for(int32_t x = lo[0]; x <= hi[0]; x++)
+				{
+					for(int32_t y = lo[1]; y <= hi[1]; y++)
+					{
+						if(std::abs(x - c[0]) == r || std::abs(y - c[1]) == r)
+						{
+							for(int32_t z = lo[2]; z <= hi[2]; z++)
+							{
+								visit(x, y, z);
+							}
+						}else{
+							if(c[2] - r >= extent_min[2])
+							{
+								visit(x, y, c[2] - r);
+							}
+							if(r > 0 && c[2] + r <= extent_max[2])
+							{
+								visit(x, y, c[2] + r);
+							}
+						}
+					}
+				}
+			}
+			std::sort_heap(result.begin(), result.end());
+		}
+
+		template <class Func>
+		void for_each_object(Func func) const
+		{
+			for(const auto &e : entries)
+			{
+				if(e.slot != npos)
+				{
+					func(e.value);
+				}
+			}
+		}
+
+		template <class Func>
+		void for_each_value(Func func)
+		{
+			for(auto &e : entries)
+			{
+				if(e.slot != npos)
+				{
+					func(e.value);
+				}
+			}
+		}
+
+		// Bytes used by the grid itself, not counting memory owned by the values
+		size_t memory_size() const
+		{
+			size_t bytes = entries.size() * sizeof(entry) + free_handles.size() * sizeof(size_t);
+			bytes += grid.bucket_count() * sizeof(void*);
+			for(const auto &pair : grid)
+			{
+				bytes += sizeof(pair) + sizeof(void*) + pair.second.size() * sizeof(point);
+			}
+			return bytes;
+		}
+
+		void swap(spatial_grid &other)
+		{
+			std::swap(cell_size, other.cell_size);
+			std::swap(inv_cell_size, other.inv_cell_size);
+			std::swap(entries, other.entries);
+			std::swap(free_handles, other.free_handles);
+			std::swap(grid, other.grid);
+			std::swap(count, other.count);
+			std::swap(extent_min, other.extent_min);
+			std::swap(extent_max, other.extent_max);
+		}
+	};
+
+	template <class Value>
+	constexpr size_t spatial_grid<Value>::npos;
+
+	template <class Value>
+	constexpr int32_t spatial_grid<Value>::cell_limit;
+}
+
+#endif
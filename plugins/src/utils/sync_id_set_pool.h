@@ -0,0 +1,119 @@
+#ifndef SYNC_ID_SET_POOL_H_INCLUDED
+#define SYNC_ID_SET_POOL_H_INCLUDED
+
+#include "utils/shared_id_set_pool.h"
+#include <memory>
+#include <mutex>
+
+namespace aux
+{
+	// Pool of shared objects whose ids may be resolved and released from any thread.
+	// Objects are only handed out as shared pointers, which keep them alive after removal.
+	template <class Type>
+	class sync_id_set_pool
+	{
+		shared_id_set_pool<Type> pool;
+		mutable std::mutex mutex;
+
+	public:
+		std::shared_ptr<Type> add(std::shared_ptr<Type> &&value)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return pool.add(std::move(value));
+		}
+
+		template <class... Args>
+		std::shared_ptr<Type> emplace(Args &&... args)
+		{
+			return add(std::allocate_shared<Type>(slab_allocator<Type>(), std::forward<Args>(args)...));
+		}
+
+		size_t size() const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return pool.size();
+		}
+
+		bool remove(Type *value)
+		{
+			std::shared_ptr<Type> orig;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				auto it = pool.find(value);
+				if(it == pool.end())
+				{
+					return false;
+				}
+				orig = pool.extract(it);
+			}
+			return true;
+		}
+
+		void clear()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pool.clear();
+		}
+
+		template <class Func>
+		void for_each(Func func) const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pool.for_each(func);
+		}
+
+		bool get_by_id(cell id, std::shared_ptr<Type> &value)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return pool.get_by_id(id, value);
+		}
+
+		cell get_id(const Type *value) const
+		{
+			return reinterpret_cast<cell>(value);
+		}
+
+		cell get_id(const std::shared_ptr<Type> &value) const
+		{
+			return reinterpret_cast<cell>(value.get());
+		}
+
+		size_t release_owner(AMX *amx)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return pool.release_owner(amx);
+		}
+
+		void forget_owner(AMX *amx)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pool.forget_owner(amx);
+		}
+
+		size_t owned_size(AMX *amx) const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return pool.owned_size(amx);
+		}
+
+		template <class Func>
+		void for_each_owned(AMX *amx, Func func) const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pool.for_each_owned(amx, func);
+		}
+
+		const pool_stats &get_stats() const
+		{
+			return pool.get_stats();
+		}
+
+		void reset_stats()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pool.reset_stats();
+		}
+	};
+}
+
+#endif